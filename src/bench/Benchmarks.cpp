@@ -0,0 +1,31 @@
+//==============================================================================
+// File: bench/Benchmarks.cpp
+// Purpose: Benchmark dispatch, and which benchmarks need a GL context
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "bench/Benchmarks.h"
+#include <iostream>
+
+namespace CowGL {
+    namespace Benchmarks {
+        int run(const std::string &name) {
+            if (name == "cows") return runCowRendering();
+            if (name == "primitives") return runPrimitives();
+            if (name == "trees") return runTreeRendering();
+            if (name == "update") return runUpdateScaling();
+            if (name == "simulation") return runSimulation();
+            if (name == "lookup") return runLookup();
+            if (name == "spatial") return runSpatial();
+            if (name == "collision") return runCollision();
+
+            std::cerr << "Unknown benchmark: " << name << std::endl;
+            std::cerr << "Available benchmarks: cows, primitives, trees, update, simulation, lookup, spatial, collision" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        bool needsGraphics(const std::string &name) {
+            return name != "update" && name != "simulation" && name != "lookup" && name != "spatial" && name != "collision";
+        }
+    } // namespace Benchmarks
+} // namespace CowGL
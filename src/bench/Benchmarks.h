@@ -0,0 +1,53 @@
+//==============================================================================
+// File: bench/Benchmarks.h
+// Purpose: Built-in performance benchmarks, selected with --bench <name>
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+
+#include <string>
+
+namespace CowGL {
+    namespace Benchmarks {
+        // Runs the named benchmark and returns the process exit code
+        int run(const std::string &name);
+
+        // Whether the benchmark draws; the others run without a window, renderer or GL context
+        bool needsGraphics(const std::string &name);
+
+        // Frame time of cows drawn primitive by primitive, from the cached meshes and through the sorted queue
+        int runCowRendering();
+
+        // Vertex/index counts and generation time of the shared primitive meshes
+        int runPrimitives();
+
+        // Instanced, frustum-culled trees against one draw per tree, at 1k/10k/100k trees
+        int runTreeRendering();
+
+        // Ticks per second and nanoseconds per entity of 1k up to 1M cows among as many trees,
+        // and the cow system on its own, with no GL context
+        int runSimulation();
+
+        // Scene update time of 10k/100k walking, turning cows on 1, 2, 4... threads up to --threads
+        // or the hardware count, with no GL context
+        int runUpdateScaling();
+
+        // Finding one of 10/100/100k objects by name scan, by name, by interned name id and
+        // by handle, with no GL context
+        int runLookup();
+
+        // Radius, box and nearest-neighbour queries among 1k up to 1M cows at a fixed density,
+        // against testing every object, with no GL context
+        int runSpatial();
+
+        // Collision tree build and refit time, and swept-sphere, slide and clearance queries among
+        // 1k/10k/100k trees, against testing every box, with no GL context
+        int runCollision();
+    } // namespace Benchmarks
+} // namespace CowGL
+
+
+#endif //BENCHMARKS_H
@@ -0,0 +1,202 @@
+//==============================================================================
+// File: bench/CollisionBenchmark.cpp
+// Purpose: Cost of building, refitting and querying the collision trees
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "bench/Benchmarks.h"
+#include "entities/Cow.h"
+#include "entities/Environment.h"
+#include "scene/CollisionWorld.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace CowGL {
+    namespace Benchmarks {
+        namespace {
+            // Same density at every size, about a tree per 64 square metres
+            const float SPACING = 8.0f;
+
+            // A cow's collision sphere and one tick of its walk, and the camera's
+            // sphere and orbit distance
+            const float BODY_RADIUS = 1.2f;
+            const float STEP_LENGTH = 5.0f / 60.0f;
+            const float CAMERA_RADIUS = 0.3f;
+            const float CAMERA_DISTANCE = 10.0f;
+
+            struct Query {
+                glm::vec3 from;
+                glm::vec3 to;
+                float radius;
+            };
+
+            // The first box the sphere enters, testing every box the same way the
+            // trees do: grown by the radius, ignoring boxes it starts in
+            bool scanSweep(const std::vector<Bounds> &boxes, const Query &query, float &fraction) {
+                const float from[3] = {query.from.x, query.from.y, query.from.z};
+                const float delta[3] = {
+                    query.to.x - query.from.x, query.to.y - query.from.y, query.to.z - query.from.z
+                };
+
+                fraction = 1.0f;
+                bool found = false;
+                for (const Bounds &box: boxes) {
+                    const float min[3] = {box.min.x - query.radius, box.min.y - query.radius, box.min.z - query.radius};
+                    const float max[3] = {box.max.x + query.radius, box.max.y + query.radius, box.max.z + query.radius};
+
+                    float enter = -1.0f;
+                    float leave = 2.0f;
+                    bool entered = false;
+                    for (int axis = 0; axis < 3; ++axis) {
+                        if (delta[axis] == 0.0f) {
+                            if (from[axis] < min[axis] || from[axis] > max[axis]) leave = -1.0f;
+                            continue;
+                        }
+                        float t0 = (min[axis] - from[axis]) / delta[axis];
+                        float t1 = (max[axis] - from[axis]) / delta[axis];
+                        float axisEnter = std::min(t0, t1);
+                        if (axisEnter > enter) {
+                            enter = axisEnter;
+                            entered = true;
+                        }
+                        leave = std::min(leave, std::max(t0, t1));
+                    }
+
+                    if (entered && enter >= 0.0f && enter <= leave && enter <= 1.0f && enter < fraction) {
+                        fraction = enter;
+                        found = true;
+                    }
+                }
+                return found;
+            }
+
+            // Nanoseconds per call of query(i) over queries calls
+            template<typename Run>
+            double timeQueries(int queries, Run run) {
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < queries; ++i) {
+                    run(i);
+                }
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                return seconds * 1.0e9 / queries;
+            }
+
+            double millisecondsSince(std::chrono::steady_clock::time_point start) {
+                return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            }
+        }
+
+        int runCollision() {
+            const int forestSizes[] = {1000, 10000, 100000};
+            const int QUERIES = 100000;
+
+            std::printf("%8s %11s %11s %11s %11s %13s %16s %11s %8s\n", "trees", "build (ms)", "refit (ms)",
+                        "step (ns)", "slide (ns)", "camera (ns)", "clearance (ns)", "scan (ns)", "hits");
+
+            for (int count: forestSizes) {
+                float side = std::sqrt(static_cast<float>(count)) * SPACING;
+                std::mt19937 rng(1234);
+                std::uniform_real_distribution<float> coordinate(-side * 0.5f, side * 0.5f);
+                std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+                CollisionWorld world;
+                std::vector<std::shared_ptr<GameObject> > trees;
+                std::vector<Bounds> boxes;
+                for (int i = 0; i < count; ++i) {
+                    auto tree = std::make_shared<Environment::Tree>();
+                    tree->getTransform().setPosition(glm::vec3(coordinate(rng), coordinate(rng), 0.0f));
+                    world.add(tree.get());
+                    boxes.push_back(tree->getWorldCollisionBounds());
+                    trees.push_back(std::move(tree));
+                }
+
+                auto start = std::chrono::steady_clock::now();
+                world.update();
+                double buildMs = millisecondsSince(start);
+
+                // A herd of solid cows, all of which moved since the last update
+                CollisionWorld herd;
+                std::vector<std::shared_ptr<Cow> > cows;
+                for (int i = 0; i < count; ++i) {
+                    auto cow = std::make_shared<Cow>();
+                    cow->setCollisionBounds(cow->getLocalBounds());
+                    cow->getTransform().setPosition(glm::vec3(coordinate(rng), coordinate(rng), 0.0f));
+                    herd.add(cow.get());
+                    cows.push_back(std::move(cow));
+                }
+                herd.update();
+                for (const auto &cow: cows) {
+                    cow->getTransform().translate(glm::vec3(0.1f, 0.0f, 0.0f));
+                }
+                start = std::chrono::steady_clock::now();
+                herd.update();
+                double refitMs = millisecondsSince(start);
+
+                // Cow steps from where a cow could stand, and camera placements behind them
+                std::vector<Query> steps;
+                std::vector<Query> cameras;
+                while (static_cast<int>(steps.size()) < QUERIES) {
+                    glm::vec3 center(coordinate(rng), coordinate(rng), 1.1f);
+                    if (world.getClearance(center, BODY_RADIUS, 1.0f) <= 0.0f) continue;
+
+                    float heading = angle(rng);
+                    glm::vec3 direction(std::cos(heading), std::sin(heading), 0.0f);
+                    steps.push_back(Query{center, center + direction * STEP_LENGTH, BODY_RADIUS});
+
+                    glm::vec3 target = center + glm::vec3(0.0f, 0.0f, -0.1f);
+                    glm::vec3 behind(-direction.x * 0.82f, -direction.y * 0.82f, 0.57f);
+                    cameras.push_back(Query{target, target + behind * CAMERA_DISTANCE, CAMERA_RADIUS});
+                }
+
+                // The old way: test every box. The trees must find the same hits.
+                int scanQueries = std::max(20, 10000000 / count);
+                scanQueries = std::min(scanQueries, QUERIES);
+                std::vector<float> scanned(scanQueries);
+                std::vector<uint8_t> scanHit(scanQueries);
+                double scanNs = timeQueries(scanQueries, [&](int i) {
+                    scanHit[i] = scanSweep(boxes, cameras[i], scanned[i]);
+                });
+
+                for (int i = 0; i < scanQueries; ++i) {
+                    CollisionWorld::Hit hit;
+                    bool found = world.sweepSphere(cameras[i].from, cameras[i].to, cameras[i].radius, hit);
+                    if (found != static_cast<bool>(scanHit[i]) || std::fabs(hit.fraction - scanned[i]) > 1.0e-5f) {
+                        std::fprintf(stderr, "Collision benchmark: the trees and a scan disagree on a hit\n");
+                        return EXIT_FAILURE;
+                    }
+                }
+
+                int hits = 0;
+                double stepNs = timeQueries(QUERIES, [&](int i) {
+                    CollisionWorld::Hit hit;
+                    hits += world.sweepSphere(steps[i].from, steps[i].to, steps[i].radius, hit);
+                });
+
+                // A cow's whole move: the sweep, then up to two slides along what it hit
+                double slideNs = timeQueries(QUERIES, [&](int i) {
+                    world.slideSphere(steps[i].from, steps[i].radius, steps[i].to - steps[i].from);
+                });
+
+                double cameraNs = timeQueries(QUERIES, [&](int i) {
+                    CollisionWorld::Hit hit;
+                    hits += world.sweepSphere(cameras[i].from, cameras[i].to, cameras[i].radius, hit);
+                });
+
+                double clearanceNs = timeQueries(QUERIES, [&](int i) {
+                    world.getClearance(steps[i].from, BODY_RADIUS, 4.0f);
+                });
+
+                std::printf("%8d %11.2f %11.2f %11.0f %11.0f %13.0f %16.0f %11.0f %8d\n", count, buildMs, refitMs,
+                            stepNs, slideNs, cameraNs, clearanceNs, scanNs, hits);
+            }
+
+            return EXIT_SUCCESS;
+        }
+    } // namespace Benchmarks
+} // namespace CowGL
@@ -0,0 +1,96 @@
+//==============================================================================
+// File: bench/LookupBenchmark.cpp
+// Purpose: Cost of finding a scene object by name scan, name, name id and handle
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "bench/Benchmarks.h"
+#include "entities/Cow.h"
+#include "scene/Scene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace CowGL {
+    namespace Benchmarks {
+        namespace {
+            // Nanoseconds per call of lookup(i) over queries calls
+            template<typename Lookup>
+            double timeLookups(int queries, Lookup lookup, size_t &found) {
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < queries; ++i) {
+                    if (lookup(i)) ++found;
+                }
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                return seconds * 1.0e9 / queries;
+            }
+        }
+
+        int runLookup() {
+            const int sceneSizes[] = {10, 100, 100000};
+            const int QUERIES = 1000000;
+
+            std::printf("%8s %16s %11s %14s %12s %9s\n", "objects", "name scan (ns)", "name (ns)", "name id (ns)",
+                        "handle (ns)", "speedup");
+
+            for (int count: sceneSizes) {
+                Scene scene;
+                std::vector<std::string> names;
+                std::vector<uint32_t> nameIds;
+                std::vector<Handle<Cow> > handles;
+                for (int i = 0; i < count; ++i) {
+                    names.push_back("Cow_" + std::to_string(i));
+                    handles.push_back(scene.addGameObject(std::make_shared<Cow>(names.back())));
+                    nameIds.push_back(scene.findNameId(names.back()));
+                }
+
+                // Every lookup asks for a random object, so scans average half the scene
+                std::mt19937 rng(1234);
+                std::uniform_int_distribution<int> pick(0, count - 1);
+                std::vector<int> targets(QUERIES);
+                for (int &target: targets) {
+                    target = pick(rng);
+                }
+
+                // The old way: compare every name, then check the type
+                int scanQueries = std::max(200, QUERIES / count);
+                size_t found = 0;
+                double scanNs = timeLookups(scanQueries, [&](int i) {
+                    const std::string &name = names[targets[i]];
+                    const auto &objects = scene.getGameObjects();
+                    auto it = std::find_if(objects.begin(), objects.end(),
+                                           [&name](const auto &obj) { return obj->getName() == name; });
+                    return it != objects.end() && std::dynamic_pointer_cast<Cow>(*it) != nullptr;
+                }, found);
+
+                double nameNs = timeLookups(QUERIES, [&](int i) {
+                    return !scene.findHandle<Cow>(names[targets[i]]).isNull();
+                }, found);
+
+                double nameIdNs = timeLookups(QUERIES, [&](int i) {
+                    return !scene.findHandle<Cow>(nameIds[targets[i]]).isNull();
+                }, found);
+
+                double handleNs = timeLookups(QUERIES, [&](int i) {
+                    return scene.get(handles[targets[i]]) != nullptr;
+                }, found);
+
+                if (found != static_cast<size_t>(scanQueries) + 3 * QUERIES) {
+                    std::fprintf(stderr, "Lookup benchmark missed %zu objects\n",
+                                 static_cast<size_t>(scanQueries) + 3 * QUERIES - found);
+                    return EXIT_FAILURE;
+                }
+
+                std::printf("%8d %16.1f %11.1f %14.1f %12.2f %8.0fx\n", count, scanNs, nameNs, nameIdNs, handleNs,
+                            scanNs / handleNs);
+            }
+
+            return EXIT_SUCCESS;
+        }
+    } // namespace Benchmarks
+} // namespace CowGL
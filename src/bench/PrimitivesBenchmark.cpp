@@ -0,0 +1,37 @@
+//==============================================================================
+// File: bench/PrimitivesBenchmark.cpp
+// Purpose: Memory cost and generation time of the shared primitive meshes
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "bench/Benchmarks.h"
+#include "core/Application.h"
+#include "core/FrameContext.h"
+#include "core/Window.h"
+#include "graphics/Primitives.h"
+#include "graphics/Renderer.h"
+#include "scene/Scene.h"
+
+#include <iostream>
+
+namespace CowGL {
+    namespace Benchmarks {
+        int runPrimitives() {
+            // One frame of the default scene requests every primitive it uses
+            Application *app = Application::getInstance();
+            Renderer *renderer = app->getRenderer();
+            FrameContext context;
+            context.width = app->getWindow()->getWidth();
+            context.height = app->getWindow()->getHeight();
+            context.scene = app->getScene();
+            context.camera = app->getScene()->getActiveCamera();
+
+            renderer->beginFrame();
+            renderer->renderScene(app->getScene(), context);
+            renderer->endFrame();
+
+            Primitives::printStats(std::cout);
+            return EXIT_SUCCESS;
+        }
+    } // namespace Benchmarks
+} // namespace CowGL
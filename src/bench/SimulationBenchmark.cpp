@@ -0,0 +1,125 @@
+//==============================================================================
+// File: bench/SimulationBenchmark.cpp
+// Purpose: Simulation tick throughput without any window or GL context, and
+//          the cow system's share of it
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "bench/Benchmarks.h"
+#include "core/Application.h"
+#include "core/FrameContext.h"
+#include "core/Input.h"
+#include "core/JobSystem.h"
+#include "entities/CowStore.h"
+#include "entities/Cow.h"
+#include "entities/Environment.h"
+#include "scene/Scene.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+namespace CowGL {
+    namespace Benchmarks {
+        namespace {
+            const float SPACING = 4.0f;
+            const float TICK = 1.0f / 60.0f;
+
+            // Every size runs the same ticks, so ns/entity compares across sizes
+            const int WARM_UP_TICKS = 10;
+            const int MEASURED_TICKS = 60;
+
+            // Cows walking in circles among as many trees, on a square grid
+            void populate(Scene &scene, int cows) {
+                std::mt19937 rng(1234);
+                std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+                int count = cows * 2;
+                int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+                for (int i = 0; i < count; ++i) {
+                    std::shared_ptr<GameObject> object;
+                    if (i % 2 == 0) {
+                        object = std::make_shared<Cow>();
+                    } else {
+                        object = std::make_shared<Environment::Tree>();
+                    }
+                    Transform &transform = object->getTransform();
+                    transform.setPosition(glm::vec3((i % side - side * 0.5f) * SPACING,
+                                                    (i / side - side * 0.5f) * SPACING, 0.0f));
+                    transform.setRotation(glm::vec3(0.0f, 0.0f, unit(rng) * 360.0f));
+                    scene.addGameObject(object);
+                }
+            }
+        }
+
+        int runSimulation() {
+            const int herdSizes[] = {1000, 10000, 100000, 1000000};
+            const Options &options = Application::getInstance()->getOptions();
+
+            // Every cow walks and turns and works its head, so each tick does full updates
+            Input input;
+            input.onKeyPress('w', 0, 0);
+            input.onKeyPress('a', 0, 0);
+            input.onKeyPress('h', 0, 0);
+            input.onKeyPress('j', 0, 0);
+
+            JobSystem jobSystem(options.threads);
+            std::printf("Simulating on %d thread(s), no GL context\n", jobSystem.getThreadCount());
+            std::printf("%8s %9s %8s %12s %12s %14s %16s %12s\n", "cows", "objects", "ticks", "tick (ms)", "ticks/s",
+                        "ns/entity", "cow system (ms)", "ns/cow");
+
+            for (int cows: herdSizes) {
+                Scene scene;
+                scene.setJobSystem(&jobSystem);
+                populate(scene, cows);
+                size_t objects = scene.getGameObjects().size();
+
+                FrameContext context;
+                context.deltaTime = TICK;
+                context.input = &input;
+                context.scene = &scene;
+
+                auto step = [&input, &scene, &context]() {
+                    input.update();
+                    scene.update(context);
+                    ++context.tick;
+                    input.clearFrameStates();
+                };
+
+                // Warm-up builds the update phases, applies the key presses and
+                // measures every cow's clearance
+                for (int i = 0; i < WARM_UP_TICKS; ++i) {
+                    step();
+                }
+
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < MEASURED_TICKS; ++i) {
+                    step();
+                }
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                double tickMs = seconds * 1000.0 / MEASURED_TICKS;
+
+                // The same cows walking through the store alone, without colliding: what
+                // the per-field layout costs, apart from the sweeps and the spatial index
+                CowStore &store = scene.getCowStore();
+                start = std::chrono::steady_clock::now();
+                for (int i = 0; i < MEASURED_TICKS; ++i) {
+                    input.update();
+                    store.update(context, &jobSystem, nullptr);
+                    input.clearFrameStates();
+                }
+                double storeMs = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count() / MEASURED_TICKS;
+
+                std::printf("%8d %9zu %8d %12.3f %12.0f %14.1f %16.3f %12.1f\n", cows, objects, MEASURED_TICKS,
+                            tickMs, MEASURED_TICKS / seconds, tickMs * 1.0e6 / objects, storeMs,
+                            storeMs * 1.0e6 / store.size());
+            }
+
+            return EXIT_SUCCESS;
+        }
+    } // namespace Benchmarks
+} // namespace CowGL
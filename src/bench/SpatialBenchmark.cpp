@@ -0,0 +1,117 @@
+//==============================================================================
+// File: bench/SpatialBenchmark.cpp
+// Purpose: Cost of proximity and region queries as the world grows
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "bench/Benchmarks.h"
+#include "entities/Cow.h"
+#include "scene/Scene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace CowGL {
+    namespace Benchmarks {
+        namespace {
+            // Same density at every size, so a query finds about as many cows
+            const float SPACING = 4.0f;
+            const float QUERY_RADIUS = 10.0f;
+            const size_t NEAREST_COUNT = 8;
+
+            // Nanoseconds per call of query(i) over queries calls
+            template<typename Query>
+            double timeQueries(int queries, Query query) {
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < queries; ++i) {
+                    query(i);
+                }
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                return seconds * 1.0e9 / queries;
+            }
+        }
+
+        int runSpatial() {
+            const int herdSizes[] = {1000, 10000, 100000, 1000000};
+            const int QUERIES = 100000;
+
+            std::printf("%8s %12s %14s %12s %14s %12s\n", "cows", "scan (ns)", "radius (ns)", "box (ns)",
+                        "nearest (ns)", "found/query");
+
+            for (int count: herdSizes) {
+                float side = std::sqrt(static_cast<float>(count)) * SPACING;
+                std::mt19937 rng(1234);
+                std::uniform_real_distribution<float> coordinate(-side * 0.5f, side * 0.5f);
+
+                Scene scene;
+                for (int i = 0; i < count; ++i) {
+                    auto cow = std::make_shared<Cow>();
+                    cow->getTransform().setPosition(glm::vec3(coordinate(rng), coordinate(rng), 0.0f));
+                    scene.addGameObject(cow);
+                }
+
+                std::vector<glm::vec2> points(QUERIES);
+                for (glm::vec2 &point: points) {
+                    point = glm::vec2(coordinate(rng), coordinate(rng));
+                }
+
+                // The old way: test every object. Moving objects are filed with some
+                // slack, so the index finds those and a few more.
+                int scanQueries = std::max(20, 10000000 / count);
+                scanQueries = std::min(scanQueries, QUERIES);
+                std::vector<std::vector<GameObject *> > scanned(scanQueries);
+                double scanNs = timeQueries(scanQueries, [&](int i) {
+                    std::vector<GameObject *> &result = scanned[i];
+                    for (const auto &obj: scene.getGameObjects()) {
+                        const glm::vec3 &position = obj->getTransform().getPosition();
+                        const Bounds &bounds = obj->getLocalBounds();
+                        float dx = position.x - points[i].x;
+                        float dy = position.y - points[i].y;
+                        float reach = QUERY_RADIUS + (bounds.center.length() + bounds.radius);
+                        if (dx * dx + dy * dy <= reach * reach) {
+                            result.push_back(obj.get());
+                        }
+                    }
+                });
+
+                std::vector<GameObject *> result;
+                for (int i = 0; i < scanQueries; ++i) {
+                    scene.queryRadius(points[i], QUERY_RADIUS, result);
+                    std::sort(result.begin(), result.end());
+                    std::sort(scanned[i].begin(), scanned[i].end());
+                    if (!std::includes(result.begin(), result.end(), scanned[i].begin(), scanned[i].end())) {
+                        std::fprintf(stderr, "Spatial benchmark: the index missed objects a scan found\n");
+                        return EXIT_FAILURE;
+                    }
+                }
+
+                size_t found = 0;
+                double radiusNs = timeQueries(QUERIES, [&](int i) {
+                    scene.queryRadius(points[i], QUERY_RADIUS, result);
+                    found += result.size();
+                });
+
+                double boxNs = timeQueries(QUERIES, [&](int i) {
+                    glm::vec2 extent(QUERY_RADIUS, QUERY_RADIUS);
+                    glm::vec2 min(points[i].x - extent.x, points[i].y - extent.y);
+                    glm::vec2 max(points[i].x + extent.x, points[i].y + extent.y);
+                    scene.queryBox(min, max, result);
+                });
+
+                double nearestNs = timeQueries(QUERIES, [&](int i) {
+                    scene.queryNearest(points[i], NEAREST_COUNT, result);
+                });
+
+                std::printf("%8d %12.0f %14.0f %12.0f %14.0f %12.1f\n", count, scanNs, radiusNs, boxNs, nearestNs,
+                            static_cast<double>(found) / QUERIES);
+            }
+
+            return EXIT_SUCCESS;
+        }
+    } // namespace Benchmarks
+} // namespace CowGL
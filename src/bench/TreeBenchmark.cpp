@@ -0,0 +1,140 @@
+//==============================================================================
+// File: bench/TreeBenchmark.cpp
+// Purpose: Frame time of instanced vs per-object tree rendering
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "bench/Benchmarks.h"
+#include "core/Application.h"
+#include "core/FrameContext.h"
+#include "core/Window.h"
+#include "entities/Environment.h"
+#include "graphics/Camera.h"
+#include "graphics/Frustum.h"
+#include "graphics/InstanceRenderer.h"
+#include "graphics/Renderer.h"
+#include "scene/Scene.h"
+
+#include "utils/OpenGL.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+namespace CowGL {
+    namespace Benchmarks {
+        namespace {
+            const float TREE_SPACING = 6.0f;
+
+            // The two paths are timed in alternating rounds and the best of each kept,
+            // so a slow spell on the machine does not land on just one of them
+            const int ROUNDS = 3;
+
+            // A square forest centred on the origin with some variation per tree
+            void plantForest(Scene &scene, int count) {
+                std::mt19937 rng(1234);
+                std::uniform_real_distribution<float> jitter(-2.0f, 2.0f);
+                std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+                int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+                for (int i = 0; i < count; ++i) {
+                    auto tree = std::make_shared<Environment::Tree>();
+                    Transform &transform = tree->getTransform();
+                    transform.setPosition(glm::vec3(
+                        (i % side - side * 0.5f) * TREE_SPACING + jitter(rng),
+                        (i / side - side * 0.5f) * TREE_SPACING + jitter(rng),
+                        0.0f));
+                    transform.setRotation(glm::vec3(0.0f, 0.0f, unit(rng) * 360.0f));
+                    transform.setUniformScale(0.7f + 0.6f * unit(rng));
+                    tree->setTint(glm::vec4(0.8f + 0.2f * unit(rng), 0.8f + 0.2f * unit(rng), 0.8f, 1.0f));
+                    scene.addGameObject(tree);
+                }
+            }
+
+            double timeFrames(Renderer *renderer, Scene &scene, int frames) {
+                Window *window = Application::getInstance()->getWindow();
+                FrameContext context;
+                context.width = window->getWidth();
+                context.height = window->getHeight();
+                context.scene = &scene;
+                context.camera = scene.getActiveCamera();
+
+                auto renderFrame = [renderer, &scene, &context]() {
+                    renderer->beginFrame();
+                    renderer->renderScene(&scene, context);
+                    renderer->endFrame();
+                    glFinish();
+                };
+
+                // Warm-up frame also performs the one-off static rebuild
+                renderFrame();
+
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < frames; ++i) {
+                    renderFrame();
+                }
+                auto end = std::chrono::steady_clock::now();
+
+                return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+            }
+        }
+
+        int runTreeRendering() {
+            const int forestSizes[] = {1000, 10000, 100000};
+            Renderer *renderer = Application::getInstance()->getRenderer();
+
+            // Standing in the middle of the forest, looking along +x
+            Camera camera;
+            camera.setPosition(glm::vec3(0.0f, 0.0f, 2.0f));
+            camera.setTarget(glm::vec3(1.0f, 0.0f, 2.0f));
+
+            std::printf("%8s %9s %12s %16s %17s %12s %12s\n",
+                        "trees", "visible", "cull (ms)", "instanced (ms)", "per-object (ms)",
+                        "tris (full)", "tris (LOD)");
+
+            for (int count: forestSizes) {
+                int frames = std::max(2, 20000 / count);
+
+                Scene instancedScene;
+                instancedScene.setActiveCamera(&camera);
+                plantForest(instancedScene, count);
+
+                Scene perObjectScene;
+                perObjectScene.setActiveCamera(&camera);
+                plantForest(perObjectScene, count);
+
+                // Switching scenes re-bakes the static world in each warm-up frame, which
+                // picks up the instancing setting
+                double instancedMs = 1.0e30;
+                double perObjectMs = 1.0e30;
+                for (int round = 0; round < ROUNDS; ++round) {
+                    Environment::Tree::setInstancingEnabled(false);
+                    perObjectMs = std::min(perObjectMs, timeFrames(renderer, perObjectScene, std::max(1, frames / 4)));
+
+                    Environment::Tree::setInstancingEnabled(true);
+                    instancedMs = std::min(instancedMs, timeFrames(renderer, instancedScene, frames));
+                }
+                RenderStats stats = renderer->getStats();
+
+                // The view from the last frame is still loaded, so the cull can be timed on its own
+                InstanceRenderer *instances = instancedScene.getGameObjects().front()->getInstanceRenderer();
+                glm::mat4 projection, modelView;
+                glGetFloatv(GL_PROJECTION_MATRIX, projection.m);
+                glGetFloatv(GL_MODELVIEW_MATRIX, modelView.m);
+                Frustum frustum = Frustum::fromMatrix(projection * modelView);
+
+                auto cullStart = std::chrono::steady_clock::now();
+                size_t visible = instances->cull(frustum);
+                double cullMs = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - cullStart).count();
+
+                std::printf("%8d %9zu %12.3f %16.3f %17.3f %12zu %12zu\n", count, visible, cullMs, instancedMs,
+                            perObjectMs, stats.trianglesFullDetail, stats.trianglesDrawn);
+            }
+
+            return EXIT_SUCCESS;
+        }
+    } // namespace Benchmarks
+} // namespace CowGL
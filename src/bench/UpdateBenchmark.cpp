@@ -0,0 +1,107 @@
+//==============================================================================
+// File: bench/UpdateBenchmark.cpp
+// Purpose: Scene update time of large herds across job system thread counts
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "bench/Benchmarks.h"
+#include "core/Application.h"
+#include "core/FrameContext.h"
+#include "core/Input.h"
+#include "core/JobSystem.h"
+#include "entities/Cow.h"
+#include "scene/Scene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace CowGL {
+    namespace Benchmarks {
+        namespace {
+            const float COW_SPACING = 4.0f;
+            const float TICK = 1.0f / 60.0f;
+
+            void raiseHerd(Scene &scene, int count) {
+                int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+                for (int i = 0; i < count; ++i) {
+                    auto cow = std::make_shared<Cow>();
+                    cow->getTransform().setPosition(glm::vec3(
+                        (i % side - side * 0.5f) * COW_SPACING, (i / side - side * 0.5f) * COW_SPACING, 0.0f));
+                    scene.addGameObject(cow);
+                }
+            }
+
+            double timeTicks(Scene &scene, int ticks) {
+                // Every cow walks and turns and works its head, so each tick does full updates
+                Input input;
+                input.onKeyPress('w', 0, 0);
+                input.onKeyPress('a', 0, 0);
+                input.onKeyPress('h', 0, 0);
+                input.onKeyPress('j', 0, 0);
+
+                FrameContext context;
+                context.deltaTime = TICK;
+                context.input = &input;
+                context.scene = &scene;
+
+                auto step = [&input, &scene, &context]() {
+                    input.update();
+                    scene.update(context);
+                    input.clearFrameStates();
+                };
+
+                // Warm-up tick also builds the update phases and applies the key presses
+                step();
+
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < ticks; ++i) {
+                    step();
+                }
+                auto end = std::chrono::steady_clock::now();
+
+                return std::chrono::duration<double, std::milli>(end - start).count() / ticks;
+            }
+        }
+
+        int runUpdateScaling() {
+            const int herdSizes[] = {10000, 100000};
+            int maxThreads = Application::getInstance()->getOptions().threads;
+            if (maxThreads <= 0) {
+                maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+            }
+
+            // Powers of two up to, and always including, the largest thread count
+            std::vector<int> threadCounts;
+            for (int threads = 1; threads < maxThreads; threads *= 2) {
+                threadCounts.push_back(threads);
+            }
+            threadCounts.push_back(maxThreads);
+
+            std::printf("%8s %9s %12s %9s\n", "cows", "threads", "tick (ms)", "speedup");
+
+            for (int count: herdSizes) {
+                Scene scene;
+                raiseHerd(scene, count);
+                int ticks = std::max(20, 2000000 / count);
+
+                double serialMs = 0.0;
+                for (int threads: threadCounts) {
+                    JobSystem jobSystem(threads);
+                    scene.setJobSystem(&jobSystem);
+                    double ms = timeTicks(scene, ticks);
+                    scene.setJobSystem(nullptr);
+
+                    if (threads == 1) serialMs = ms;
+                    std::printf("%8d %9d %12.3f %8.2fx\n", count, threads, ms, serialMs / ms);
+                }
+            }
+
+            return EXIT_SUCCESS;
+        }
+    } // namespace Benchmarks
+} // namespace CowGL
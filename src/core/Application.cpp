@@ -5,18 +5,55 @@
 //==============================================================================
 
 #include "core/Application.h"
+#include "core/FrameContext.h"
 #include "core/Window.h"
+#include "core/HeadlessContext.h"
 #include "core/Input.h"
+#include "core/InputRecording.h"
+#include "core/Profiler.h"
+#include "core/JobSystem.h"
 #include "graphics/Renderer.h"
 #include "scene/Scene.h"
 #include "ui/UIManager.h"
 #include "entities/Cow.h"
 #include "entities/Environment.h"
+#include "bench/Benchmarks.h"
 
-#include <GLUT/glut.h>
+#include "utils/OpenGL.h"
+#include <cstdio>
+#include <ctime>
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <thread>
 
 namespace CowGL {
+    namespace {
+        // Longest real time a single frame may feed into the simulation, so a stall
+        // (window drag, breakpoint) does not trigger a burst of catch-up ticks
+        const double MAX_FRAME_TIME = 0.25;
+
+        // GLUT timers have millisecond resolution and fire late, so they are armed this
+        // much early and the frame pacer waits out the rest
+        const auto TIMER_SLACK = std::chrono::milliseconds(2);
+
+        void printFrameTimes(std::vector<double> frameMs) {
+            if (frameMs.empty()) return;
+
+            std::sort(frameMs.begin(), frameMs.end());
+            double total = 0.0;
+            for (double ms: frameMs) total += ms;
+            auto percentile = [&frameMs](double p) {
+                size_t rank = static_cast<size_t>(std::ceil(p * frameMs.size()));
+                return frameMs[std::clamp<size_t>(rank, 1, frameMs.size()) - 1];
+            };
+
+            std::printf("Frame time over %zu frames (ms): min %.3f, avg %.3f, p50 %.3f, p95 %.3f, p99 %.3f, max %.3f\n",
+                        frameMs.size(), frameMs.front(), total / frameMs.size(), percentile(0.50),
+                        percentile(0.95), percentile(0.99), frameMs.back());
+        }
+    }
+
     Application *Application::s_instance = nullptr;
 
     Application::Application(int argc, char **argv) {
@@ -28,24 +65,61 @@ namespace CowGL {
     }
 
     Application::~Application() {
+        stopSimulation();
         s_instance = nullptr;
     }
 
     void Application::initialize(int argc, char **argv) {
-        // Initialize GLUT
-        glutInit(&argc, argv);
+        // Unknown arguments are skipped, so GLUT's own can stay in place
+        m_options = Options::parse(argc, argv);
+
+        // A replay only reproduces the session at the tick rate and size it was recorded with
+        InputRecording replay;
+        if (!m_options.replayPath.empty()) {
+            replay = InputRecording::load(m_options.replayPath);
+            m_options.tickRate = static_cast<int>(replay.tickRate);
+            if (replay.width > 0 && replay.height > 0) {
+                m_options.width = replay.width;
+                m_options.height = replay.height;
+            }
+        }
+
+#ifdef COWGL_PROFILER
+        if (!m_options.tracePath.empty()) {
+            Profiler::startTrace(m_options.tracePath);
+        }
+#endif
+
+        // Simulation benchmarks build their own scenes and never touch GL
+        if (!m_options.benchmark.empty() && !Benchmarks::needsGraphics(m_options.benchmark)) {
+            return;
+        }
+
+        // GLUT needs a display to initialise, which headless machines do not have
+        Window::Mode mode = m_options.headless ? Window::Mode::Headless : Window::Mode::Windowed;
+        if (mode == Window::Mode::Windowed) {
+            glutInit(&argc, argv);
+        }
 
         // Create systems
-        m_window = std::make_unique<Window>("CowGL", 1024, 768);
+        m_window = std::make_unique<Window>("CowGL", m_options.width, m_options.height, mode);
         m_input = std::make_unique<Input>();
+        if (!m_options.replayPath.empty()) {
+            m_input->startReplay(std::move(replay.events));
+        }
+        if (!m_options.recordPath.empty()) {
+            m_input->startRecording();
+        }
+        m_jobSystem = std::make_unique<JobSystem>(m_options.threads);
         m_renderer = std::make_unique<Renderer>();
         m_scene = std::make_unique<Scene>();
+        m_scene->setJobSystem(m_jobSystem.get());
         m_uiManager = std::make_unique<UIManager>();
 
         // Initialize systems
         m_renderer->initialize();
         m_scene->initialize();
-        m_uiManager->initialize();
+        m_uiManager->initialize(m_window->getWidth(), m_window->getHeight());
 
         // Setup callbacks
         m_window->setDisplayCallback([]() {
@@ -53,45 +127,93 @@ namespace CowGL {
         });
 
         m_window->setKeyboardCallback([](unsigned char key, int x, int y) {
-            if (s_instance) s_instance->m_input->onKeyPress(key, x, y);
+            if (!s_instance) return;
+            s_instance->m_input->onKeyPress(key, x, y);
+            s_instance->wake();
         });
 
         m_window->setKeyboardUpCallback([](unsigned char key, int x, int y) {
-            if (s_instance) s_instance->m_input->onKeyRelease(key, x, y);
+            if (!s_instance) return;
+            s_instance->m_input->onKeyRelease(key, x, y);
+            s_instance->wake();
         });
 
         m_window->setMouseCallback([](int button, int state, int x, int y) {
-            if (s_instance) s_instance->m_input->onMouseButton(button, state, x, y);
+            if (!s_instance) return;
+            s_instance->m_input->onMouseButton(button, state, x, y);
+            s_instance->wake();
         });
 
         m_window->setMouseMoveCallback([](int x, int y) {
-            if (s_instance) s_instance->m_input->onMouseMove(x, y);
+            if (!s_instance) return;
+            s_instance->m_input->onMouseMove(x, y);
+            s_instance->wake();
         });
 
         m_window->setReshapeCallback([](int width, int height) {
-            if (s_instance) {
-                s_instance->m_window->setWidth(width);
-                s_instance->m_window->setHeight(height);
-                // Update button positions
-                s_instance->m_uiManager->updateButtonPositions();
-            }
+            if (!s_instance) return;
+            s_instance->m_window->setWidth(width);
+            s_instance->m_window->setHeight(height);
+            // The UI lays its buttons out again on the next tick
+            s_instance->wake();
         });
 
-        m_lastFrameTime = std::chrono::steady_clock::now();
+#ifdef COWGL_PROFILER
+        if (m_options.benchmark.empty() && !m_options.profilePath.empty()) {
+            Profiler::writeCsvOnExit(m_options.profilePath);
+        }
+#endif
+
+        m_tickInterval = 1.0 / m_options.tickRate;
+
+        // The first frame draws the initial state
+        publishSnapshot(std::chrono::steady_clock::now());
     }
 
     void Application::timerCallback(int value) {
         if (s_instance) {
-            s_instance->handleEvents();
+            s_instance->exitIfShuttingDown();
+            s_instance->m_frameScheduled = false;
+            s_instance->m_pacer.waitForFrame();
+            glutPostRedisplay();
+        }
+    }
+
+    void Application::idleCallback() {
+        if (s_instance) {
+            s_instance->exitIfShuttingDown();
             glutPostRedisplay();
-            glutTimerFunc(16, timerCallback, 0);
         }
     }
 
     int Application::run() {
-        // Start timer with static callback
-        glutTimerFunc(0, Application::timerCallback, 0);
+        if (!m_options.benchmark.empty()) {
+            return Benchmarks::run(m_options.benchmark);
+        }
+
+        if (m_options.headless) {
+            return runHeadless();
+        }
 
+        // Replays are measured frame by frame, so they never go idle
+        m_idleEnabled = m_options.idle && m_options.replayPath.empty();
+        m_sessionStart = std::chrono::steady_clock::now();
+
+        m_simulationThread = std::thread(&Application::simulationLoop, this);
+        m_pacer.setTargetRate(m_options.frameRateMode == FrameRateMode::Capped ? m_options.frameRateCap : 0);
+
+        switch (m_options.frameRateMode) {
+            case FrameRateMode::VSync:
+                if (!m_window->setSwapInterval(1)) {
+                    std::cerr << "Swap control is not available, frames are not synchronised to the display"
+                            << std::endl;
+                }
+                break;
+            default:
+                m_window->setSwapInterval(0);
+                break;
+        }
+        resumeFrames();
 
         // Enter main loop
         glutMainLoop();
@@ -100,38 +222,357 @@ namespace CowGL {
     }
 
     void Application::shutdown() {
-        m_running = false;
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_running = false;
+        }
+        m_wakeCondition.notify_all();
+    }
+
+    void Application::stopSimulation() {
+        shutdown();
+        if (m_simulationThread.joinable()) {
+            m_simulationThread.join();
+        }
+    }
+
+    void Application::exitIfShuttingDown() {
+        if (m_running) return;
+
+        // GLUT's main loop never returns, so leave from here once the simulation is done
+        stopSimulation();
+        finishSession();
+        exit(0);
+    }
+
+    void Application::finishSession() {
+        if (!m_options.recordPath.empty()) {
+            InputRecording recording;
+            recording.tickRate = static_cast<uint32_t>(m_options.tickRate);
+            recording.width = static_cast<uint16_t>(m_options.width);
+            recording.height = static_cast<uint16_t>(m_options.height);
+            recording.events = m_input->getRecordedEvents();
+            try {
+                recording.save(m_options.recordPath);
+                std::printf("Recorded %zu input events over %u ticks to %s\n", recording.events.size(),
+                            m_input->getTick(), m_options.recordPath.c_str());
+            } catch (const std::exception &e) {
+                std::cerr << e.what() << std::endl;
+            }
+        }
+
+        if (!m_options.replayPath.empty()) {
+            printFrameTimes(m_frameTimes);
+        }
+
+        double cpuSeconds = static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+        if (m_window->isHeadless()) {
+            // Headless frames don't wait on the clock, so CPU per drawn frame is the measure
+            int frames = m_drawnFrames + m_idleFrames;
+            std::printf("CPU time %.2f s over %d drawn frames (%.3f ms/frame), idle %d frames (%.1f%%)\n",
+                        cpuSeconds, m_drawnFrames, cpuSeconds * 1000.0 / std::max(m_drawnFrames, 1), m_idleFrames,
+                        100.0 * m_idleFrames / std::max(frames, 1));
+        } else {
+            auto now = std::chrono::steady_clock::now();
+            double sessionSeconds = std::chrono::duration<double>(now - m_sessionStart).count();
+            double idleSeconds = m_idleSeconds;
+            if (m_renderSleeping) {
+                idleSeconds += std::chrono::duration<double>(now - m_sleepStart).count();
+            }
+            std::printf("CPU time %.2f s over %.2f s (%.1f%% of one core), idle %.1f%% of the session\n",
+                        cpuSeconds, sessionSeconds, 100.0 * cpuSeconds / std::max(sessionSeconds, 1e-9),
+                        100.0 * idleSeconds / std::max(sessionSeconds, 1e-9));
+        }
+
+        if (m_pacer.getFrameCount() > 0) {
+            double missedPercent = 100.0 * m_pacer.getMissedDeadlines() / m_pacer.getFrameCount();
+            if (m_pacer.getTargetRate() > 0) {
+                std::printf("Frame pacing at %d fps: %llu frames, %llu missed deadlines (%.1f%%), "
+                            "render cost avg %.3f ms\n", m_pacer.getTargetRate(),
+                            static_cast<unsigned long long>(m_pacer.getFrameCount()),
+                            static_cast<unsigned long long>(m_pacer.getMissedDeadlines()), missedPercent,
+                            m_pacer.getAverageCostMs());
+            } else {
+                std::printf("Unpaced frames: %llu frames, render cost avg %.3f ms\n",
+                            static_cast<unsigned long long>(m_pacer.getFrameCount()), m_pacer.getAverageCostMs());
+            }
+        }
+    }
+
+    void Application::wake() {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_wakeSerial.fetch_add(1, std::memory_order_release);
+        }
+        m_wakeCondition.notify_all();
+
+        if (m_renderSleeping) {
+            m_renderSleeping = false;
+            m_idleSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_sleepStart).count();
+            m_pacer.resync();
+            resumeFrames();
+        }
+    }
+
+    void Application::resumeFrames() {
+        // Frames are paced by a timer when capped, otherwise drawn whenever GLUT is idle
+        // and, with vsync, held back by the buffer swap
+        if (m_options.frameRateMode == FrameRateMode::Capped) {
+            scheduleNextFrame();
+        } else {
+            glutIdleFunc(Application::idleCallback);
+        }
+    }
+
+    void Application::tick(std::chrono::steady_clock::time_point time) {
+        // Events queued before a wake-up was counted are all applied by this tick
+        m_tickWakeSerial = m_wakeSerial.load(std::memory_order_acquire);
+        update(static_cast<float>(m_tickInterval));
+        m_tickCount++;
+        publishSnapshot(time);
+    }
+
+    void Application::publishSnapshot(std::chrono::steady_clock::time_point time) {
+        COWGL_PROFILE_SCOPE("Snapshot");
+        RenderSnapshot &snapshot = m_snapshots.back();
+        snapshot.tick = m_tickCount;
+        snapshot.time = time;
+        m_scene->captureSnapshot(snapshot);
+        m_uiManager->captureSnapshot(snapshot);
+
+        uint64_t revision = snapshot.sceneRevision + snapshot.uiRevision;
+        snapshot.idle = revision == m_publishedRevision && !snapshot.animating;
+        snapshot.wakeSerial = m_tickWakeSerial;
+        m_publishedRevision = revision;
+        m_lastTickIdle = snapshot.idle;
+
+        m_snapshots.publish();
+    }
+
+    void Application::simulationLoop() {
+        Profiler::setThreadName("Simulation");
+
+        auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(m_tickInterval));
+        auto maxLag = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(MAX_FRAME_TIME));
+
+        auto nextTick = std::chrono::steady_clock::now();
+        while (m_running) {
+            nextTick += interval;
+            std::this_thread::sleep_until(nextTick);
+
+            // After a stall, drop the backlog instead of catching up in a burst
+            auto now = std::chrono::steady_clock::now();
+            if (now - nextTick > maxLag) {
+                nextTick = now;
+            }
+
+            {
+                COWGL_PROFILE_FRAME();
+                tick(nextTick);
+            }
+
+            // Nothing moved, so nothing will until the next input event
+            if (m_idleEnabled && m_lastTickIdle) {
+                std::unique_lock<std::mutex> lock(m_wakeMutex);
+                m_wakeCondition.wait(lock, [this]() {
+                    return !m_running || m_wakeSerial.load(std::memory_order_acquire) != m_tickWakeSerial;
+                });
+                nextTick = std::chrono::steady_clock::now() - interval;
+            }
+        }
     }
 
     void Application::update(float deltaTime) {
+        COWGL_PROFILE_SCOPE("Update");
+        handleEvents();
         m_input->update();
-        m_scene->update(deltaTime);
-        m_uiManager->update(deltaTime);
+
+        FrameContext context;
+        context.deltaTime = deltaTime;
+        context.time = static_cast<double>(m_tickCount) * m_tickInterval;
+        context.tick = m_tickCount;
+        context.width = m_window->getWidth();
+        context.height = m_window->getHeight();
+        context.input = m_input.get();
+        context.scene = m_scene.get();
+        context.camera = m_scene->getActiveCamera();
+        context.lighting = m_uiManager->getLighting();
+
+        m_scene->update(context);
+        {
+            COWGL_PROFILE_SCOPE("UI update");
+            m_uiManager->update(context);
+        }
 
         // Clear input states after all systems have had a chance to read them
         m_input->clearFrameStates();
     }
 
     void Application::render() {
-        auto currentTime = std::chrono::steady_clock::now();
-        float deltaTime = std::chrono::duration<float>(currentTime - m_lastFrameTime).count();
-        m_lastFrameTime = currentTime;
+        exitIfShuttingDown();
+        COWGL_PROFILE_FRAME();
+
+        // The latest tick is shown as it becomes due, blended in from the tick before
+        m_snapshots.acquire();
+        double sinceTick = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - m_snapshots.front().time).count();
+        float alpha = static_cast<float>(std::clamp(sinceTick / m_tickInterval, 0.0, 1.0));
+
+        m_pacer.beginFrame();
+        if (m_options.replayPath.empty()) {
+            drawFrame(alpha);
+        } else {
+            auto frameStart = std::chrono::steady_clock::now();
+            drawFrame(alpha);
+            m_frameTimes.push_back(std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - frameStart).count());
+            if (static_cast<int>(m_frameTimes.size()) >= m_options.frames) {
+                shutdown();
+            }
+        }
+        m_pacer.endFrame();
+
+        // The frame just drawn stays valid until the next input event
+        const RenderSnapshot &shown = m_snapshots.front();
+        bool settled = m_idleEnabled && shown.idle &&
+                       shown.wakeSerial == m_wakeSerial.load(std::memory_order_acquire);
+#ifdef COWGL_PROFILER
+        settled = settled && !Profiler::isOverlayVisible();
+#endif
+        if (settled) {
+            if (!m_renderSleeping) {
+                m_renderSleeping = true;
+                m_sleepStart = std::chrono::steady_clock::now();
+                glutIdleFunc(nullptr);
+            }
+            return;
+        }
+
+        if (m_options.frameRateMode == FrameRateMode::Capped) {
+            scheduleNextFrame();
+        }
+    }
 
-        update(deltaTime);
+    float Application::advanceSimulation(double elapsedSeconds) {
+        m_accumulator += std::min(elapsedSeconds, MAX_FRAME_TIME);
+
+        // Every tick sees the same delta, so the outcome does not depend on the frame rate
+        while (m_accumulator >= m_tickInterval) {
+            tick(std::chrono::steady_clock::now());
+            m_accumulator -= m_tickInterval;
+        }
+
+        return static_cast<float>(m_accumulator / m_tickInterval);
+    }
+
+    void Application::scheduleNextFrame() {
+        if (m_frameScheduled) return;
+
+        auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+            m_pacer.getWakeTime() - TIMER_SLACK - std::chrono::steady_clock::now());
+        m_frameScheduled = true;
+        glutTimerFunc(static_cast<unsigned int>(std::max<long long>(delay.count(), 0)), Application::timerCallback, 0);
+    }
+
+    void Application::drawFrame(float alpha) {
+        const RenderSnapshot &snapshot = m_snapshots.front();
+
+        // Objects are drawn through the live scene, so it may not gain or lose any until the frame is done
+        auto structureLock = m_scene->lockStructure();
+        m_scene->applySnapshot(snapshot, alpha);
+        m_uiManager->applySnapshot(snapshot);
+
+        // Drawing reads the blended snapshot only, never the simulation's live state
+        FrameContext context;
+        context.time = std::max(static_cast<double>(snapshot.tick) - 1.0 + alpha, 0.0) * m_tickInterval;
+        context.tick = snapshot.tick;
+        context.width = m_window->getWidth();
+        context.height = m_window->getHeight();
+        context.scene = m_scene.get();
+        context.camera = m_scene->getActiveCamera();
+        context.lighting = m_uiManager->getRenderLighting();
 
         m_renderer->beginFrame();
-        m_renderer->renderScene(m_scene.get());
-        m_uiManager->render(m_renderer.get());
+        m_renderer->renderScene(m_scene.get(), context);
+
+        // UI text is drawn with GLUT bitmap fonts, which need a GLUT window
+        if (!m_window->isHeadless()) {
+            COWGL_PROFILE_SCOPE("UI render");
+            m_uiManager->render(m_renderer.get(), context);
+        }
         m_renderer->endFrame();
+        structureLock.unlock();
 
         // Swap buffers after all rendering is complete
-        glutSwapBuffers();
+        COWGL_PROFILE_SCOPE("Swap buffers");
+        m_window->swapBuffers();
+    }
+
+    int Application::runHeadless() {
+        // Each frame stands for one interval at the frame rate cap, so runs are reproducible
+        const double FRAME_TIME = 1.0 / m_options.frameRateCap;
+
+        bool replaying = !m_options.replayPath.empty();
+
+        // Nothing wakes a headless run but a replay, so once it settles every later
+        // frame would draw the same image; with --headless-idle those are counted as
+        // idle instead of drawn
+        m_idleEnabled = m_options.headlessIdle && m_options.idle && !replaying;
+
+        auto start = std::chrono::steady_clock::now();
+        int frames = 0;
+        bool settled = false;
+        while (frames < m_options.frames && m_running) {
+            ++frames;
+            if (settled) {
+                ++m_idleFrames;
+                continue;
+            }
+            ++m_drawnFrames;
+
+            COWGL_PROFILE_FRAME();
+            auto frameStart = std::chrono::steady_clock::now();
+            float alpha = advanceSimulation(FRAME_TIME);
+            m_snapshots.acquire();
+            drawFrame(alpha);
+            settled = m_idleEnabled && m_snapshots.front().idle;
+
+            // Replays time every frame to completion, so statistics cover the GPU work too
+            if (replaying) {
+                glFinish();
+                m_frameTimes.push_back(std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - frameStart).count());
+            }
+        }
+        glFinish();
+        double elapsedMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        // Idle frames cost nothing, so the time per frame is over the frames drawn
+        std::printf("Rendered %d frames (%llu ticks) at %dx%d in %.1f ms (%.3f ms/frame)",
+                    m_drawnFrames, static_cast<unsigned long long>(m_tickCount),
+                    m_options.width, m_options.height, elapsedMs, elapsedMs / std::max(m_drawnFrames, 1));
+        if (m_idleFrames > 0) {
+            std::printf(", %d of %d frames idle", m_idleFrames, frames);
+        }
+        std::printf("\n");
+
+        if (!m_options.outputPath.empty()) {
+            m_window->getHeadlessContext()->saveImage(m_options.outputPath);
+            std::printf("Last frame written to %s\n", m_options.outputPath.c_str());
+        }
+
+        finishSession();
+
+        return EXIT_SUCCESS;
     }
 
     void Application::handleEvents() {
         // Process any pending events
-        if (m_input->isKeyPressed('q') || m_input->isKeyPressed('Q')) {
-            exit(0);
+        if (m_input->isActionPressed(Action::Quit)) {
+            shutdown();
         }
     }
 } // namespace CowGL
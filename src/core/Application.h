@@ -11,6 +11,16 @@
 
 #include <memory>
 #include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include "core/Options.h"
+#include "core/FramePacer.h"
+#include "scene/RenderSnapshot.h"
+#include "utils/TripleBuffer.h"
 
 namespace CowGL {
     class Window;
@@ -18,6 +28,7 @@ namespace CowGL {
     class Scene;
     class UIManager;
     class Input;
+    class JobSystem;
 
     class Application {
     public:
@@ -32,6 +43,7 @@ namespace CowGL {
 
         int run();
 
+        // Safe from any thread; the render thread stops the simulation and exits
         void shutdown();
 
         static Application *getInstance() { return s_instance; }
@@ -40,14 +52,54 @@ namespace CowGL {
         Scene *getScene() const { return m_scene.get(); }
         Input *getInput() const { return m_input.get(); }
         UIManager *getUIManager() const { return m_uiManager.get(); }
+        JobSystem *getJobSystem() const { return m_jobSystem.get(); }
+        const Options &getOptions() const { return m_options; }
 
     private:
         void initialize(int argc, char **argv);
 
+        // One fixed simulation tick
         void update(float deltaTime);
 
+        // Simulation tick followed by a snapshot of its result, due at the given time
+        void tick(std::chrono::steady_clock::time_point time);
+
+        void publishSnapshot(std::chrono::steady_clock::time_point time);
+
+        // Ticks on a steady schedule until shutdown, on the simulation thread
+        void simulationLoop();
+
+        void stopSimulation();
+
+        // Exits from the render thread once shutdown was requested
+        void exitIfShuttingDown();
+
+        // Saves the input recording and reports replay frame times, once the simulation stopped
+        void finishSession();
+
+        // Render thread, on every input event or resize: a sleeping simulation ticks again
+        // and frames resume until the result has been drawn
+        void wake();
+
+        // Starts drawing frames again, paced as configured
+        void resumeFrames();
+
         void render();
 
+        // Runs every tick that fits into the elapsed time on the calling thread and
+        // returns how far the simulation is into the next one, as a fraction of a tick
+        float advanceSimulation(double elapsedSeconds);
+
+        // Draws the acquired snapshot (and the UI when there is a window) and presents it,
+        // blending moving objects alpha of the way from the previous tick to the current one
+        void drawFrame(float alpha);
+
+        // Arms the GLUT timer for the next frame when the frame rate is capped
+        void scheduleNextFrame();
+
+        // Fixed number of frames at a fixed timestep, without GLUT
+        int runHeadless();
+
         void handleEvents();
 
         static Application *s_instance;
@@ -57,10 +109,50 @@ namespace CowGL {
         std::unique_ptr<Scene> m_scene;
         std::unique_ptr<UIManager> m_uiManager;
         std::unique_ptr<Input> m_input;
+        std::unique_ptr<JobSystem> m_jobSystem;
+
+        Options m_options;
+
+        std::atomic<bool> m_running{true};
+
+        // Fixed timestep state, owned by whichever thread runs the simulation
+        double m_tickInterval = 1.0 / 60.0;
+        double m_accumulator = 0.0;
+        uint64_t m_tickCount = 0;
+
+        // Windowed sessions simulate on their own thread and hand each tick to the
+        // render thread; headless runs do both on one thread for reproducibility
+        std::thread m_simulationThread;
+        TripleBuffer<RenderSnapshot> m_snapshots;
+
+        // Idle mode: after a tick that changed nothing the simulation waits for a wake-up,
+        // and the render thread stops once it has drawn that tick and every wake-up was simulated
+        bool m_idleEnabled = false;
+        std::atomic<uint64_t> m_wakeSerial{0};
+        std::mutex m_wakeMutex;
+        std::condition_variable m_wakeCondition;
+        uint64_t m_tickWakeSerial = 0;              // Simulation thread
+        uint64_t m_publishedRevision = UINT64_MAX; // Simulation thread
+        bool m_lastTickIdle = false;                // Simulation thread
+        bool m_renderSleeping = false;              // Render thread
+        std::chrono::steady_clock::time_point m_sleepStart;
+        double m_idleSeconds = 0.0;
+        std::chrono::steady_clock::time_point m_sessionStart;
+
+        // Headless frames drawn, and skipped because the last one drawn still stands
+        int m_drawnFrames = 0;
+        int m_idleFrames = 0;
+
+        // Milliseconds per drawn frame while replaying
+        std::vector<double> m_frameTimes;
+
+        // Frame deadlines and render cost; only capped sessions wait on it
+        FramePacer m_pacer;
+        bool m_frameScheduled = false;
 
-        std::chrono::steady_clock::time_point m_lastFrameTime;
-        bool m_running = true;
         static void timerCallback(int value);
+
+        static void idleCallback();
     };
 } // namespace CowGL
 
@@ -0,0 +1,62 @@
+//==============================================================================
+// File: core/FrameContext.h
+// Purpose: Per-tick and per-frame state passed down through update and render
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef FRAMECONTEXT_H
+#define FRAMECONTEXT_H
+
+
+#include <cstdint>
+
+namespace CowGL {
+    class Input;
+    class Camera;
+    class Scene;
+
+    // Lighting as set through the lighting menu
+    struct LightingState {
+        float globalAmbient = 0.3f;
+        float sunIntensity = 1.0f;
+        float sunAngle = 45.0f;
+
+        bool operator==(const LightingState &other) const {
+            return globalAmbient == other.globalAmbient && sunIntensity == other.sunIntensity &&
+                   sunAngle == other.sunAngle;
+        }
+
+        bool operator!=(const LightingState &other) const { return !(*this == other); }
+    };
+
+    // Everything an update or a draw reads from outside the object itself. The
+    // application fills one in per simulation tick and one per rendered frame and
+    // hands it down by const reference; nothing changes it afterwards, so workers
+    // of the job system can read it while objects update in parallel.
+    struct FrameContext {
+        // Seconds the tick advances the simulation by; zero when drawing
+        float deltaTime = 0.0f;
+
+        // Simulated seconds and ticks; frames are between tick and the one before it
+        double time = 0.0;
+        uint64_t tick = 0;
+
+        // Window size in pixels
+        int width = 0;
+        int height = 0;
+
+        // Input applied for this tick; null when nothing reacts to controls
+        const Input *input = nullptr;
+
+        const Scene *scene = nullptr;
+
+        // Active camera; drawing uses its render view
+        const Camera *camera = nullptr;
+
+        // The simulation's lighting on update, the snapshot's on render
+        LightingState lighting;
+    };
+} // namespace CowGL
+
+
+#endif //FRAMECONTEXT_H
@@ -0,0 +1,89 @@
+//==============================================================================
+// File: core/FramePacer.cpp
+// Purpose: Frame pacer implementation
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "core/FramePacer.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace CowGL {
+    namespace {
+        // Sleeps wake up late by up to a scheduler quantum, so the end of a wait spins
+        const auto SPIN_TIME = std::chrono::microseconds(1500);
+
+        // Weight of the newest frame in the expected render cost
+        const double COST_SMOOTHING = 0.1;
+    }
+
+    FramePacer::FramePacer(int targetRate)
+        : m_targetRate(0)
+          , m_interval(Clock::duration::zero())
+          , m_deadline(Clock::now())
+          , m_frameStart(m_deadline)
+          , m_expectedCost(0.0)
+          , m_frameCount(0)
+          , m_missedDeadlines(0)
+          , m_totalCost(0.0) {
+        setTargetRate(targetRate);
+    }
+
+    void FramePacer::setTargetRate(int targetRate) {
+        m_targetRate = std::max(targetRate, 0);
+        m_interval = m_targetRate > 0
+                         ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_targetRate))
+                         : Clock::duration::zero();
+        m_deadline = Clock::now() + m_interval;
+    }
+
+    FramePacer::Clock::time_point FramePacer::getWakeTime() const {
+        if (m_targetRate == 0) return Clock::now();
+
+        // Never start earlier than a whole interval ahead, even if the cost estimate is that high
+        auto lead = std::min(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_expectedCost)),
+                             m_interval);
+        return m_deadline - lead;
+    }
+
+    void FramePacer::waitForFrame() const {
+        if (m_targetRate == 0) return;
+
+        Clock::time_point wake = getWakeTime();
+        if (Clock::now() < wake - SPIN_TIME) {
+            std::this_thread::sleep_until(wake - SPIN_TIME);
+        }
+        while (Clock::now() < wake) {
+            std::this_thread::yield();
+        }
+    }
+
+    void FramePacer::beginFrame() {
+        m_frameStart = Clock::now();
+    }
+
+    void FramePacer::endFrame() {
+        Clock::time_point now = Clock::now();
+        double cost = std::chrono::duration<double>(now - m_frameStart).count();
+
+        m_expectedCost = m_frameCount == 0 ? cost : m_expectedCost + (cost - m_expectedCost) * COST_SMOOTHING;
+        m_totalCost += cost;
+        ++m_frameCount;
+
+        if (m_targetRate == 0) return;
+
+        // Deadlines stay on their grid; a frame presented after its own deadline counts
+        // as missed and the grid restarts from now instead of rushing to catch up
+        if (now > m_deadline) {
+            ++m_missedDeadlines;
+            m_deadline = now + m_interval;
+        } else {
+            m_deadline += m_interval;
+        }
+    }
+
+    double FramePacer::getAverageCostMs() const {
+        return m_frameCount > 0 ? m_totalCost * 1000.0 / m_frameCount : 0.0;
+    }
+} // namespace CowGL
@@ -0,0 +1,68 @@
+//==============================================================================
+// File: core/FramePacer.h
+// Purpose: Frame pacing against absolute present deadlines
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+
+#include <chrono>
+#include <cstdint>
+
+namespace CowGL {
+    // Presents frames on a fixed grid of absolute deadlines, so time spent rendering
+    // never adds to the interval. Each frame starts its expected render cost before
+    // its deadline; the wait sleeps for most of the gap and spins the last stretch.
+    class FramePacer {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // Frames per second; 0 leaves frames unpaced and only measures them
+        explicit FramePacer(int targetRate = 60);
+
+        void setTargetRate(int targetRate);
+
+        // Restarts the deadlines from now, after frames were deliberately not drawn
+        void resync() { m_deadline = Clock::now(); }
+
+        int getTargetRate() const { return m_targetRate; }
+
+        // When the next frame should start to be presented on its deadline
+        Clock::time_point getWakeTime() const;
+
+        // Blocks until the wake time; returns immediately when unpaced
+        void waitForFrame() const;
+
+        // Brackets the frame's work, including the buffer swap
+        void beginFrame();
+
+        void endFrame();
+
+        uint64_t getFrameCount() const { return m_frameCount; }
+
+        // Frames presented after their own deadline
+        uint64_t getMissedDeadlines() const { return m_missedDeadlines; }
+
+        double getAverageCostMs() const;
+
+        double getExpectedCostMs() const { return m_expectedCost * 1000.0; }
+
+    private:
+        int m_targetRate;
+        Clock::duration m_interval;
+        Clock::time_point m_deadline;
+        Clock::time_point m_frameStart;
+
+        // Smoothed render cost, in seconds
+        double m_expectedCost;
+
+        uint64_t m_frameCount;
+        uint64_t m_missedDeadlines;
+        double m_totalCost;
+    };
+} // namespace CowGL
+
+
+#endif //FRAMEPACER_H
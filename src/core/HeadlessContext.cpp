@@ -0,0 +1,148 @@
+//==============================================================================
+// File: core/HeadlessContext.cpp
+// Purpose: Offscreen context implementation
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "core/HeadlessContext.h"
+#include "utils/OpenGL.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#ifdef COWGL_HEADLESS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+namespace CowGL {
+#ifdef COWGL_HEADLESS_EGL
+    namespace {
+        EGLDisplay openDisplay() {
+            // Surfaceless needs no window system at all; fall back to whatever the default is
+            auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                eglGetProcAddress("eglGetPlatformDisplayEXT"));
+            if (getPlatformDisplay) {
+                EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+                if (display != EGL_NO_DISPLAY) return display;
+            }
+            return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+    }
+
+    HeadlessContext::HeadlessContext(int width, int height)
+        : m_width(width)
+          , m_height(height)
+          , m_display(nullptr)
+          , m_context(nullptr)
+          , m_framebuffer(0)
+          , m_colorBuffer(0)
+          , m_depthBuffer(0) {
+        EGLDisplay display = openDisplay();
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+            throw std::runtime_error("Failed to initialise an EGL display");
+        }
+        m_display = display;
+
+        // The renderer uses the fixed-function pipeline, so ask for desktop GL
+        if (!eglBindAPI(EGL_OPENGL_API)) {
+            eglTerminate(display);
+            throw std::runtime_error("EGL does not support desktop OpenGL");
+        }
+
+        const EGLint configAttributes[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8,
+            EGL_GREEN_SIZE, 8,
+            EGL_BLUE_SIZE, 8,
+            EGL_DEPTH_SIZE, 24,
+            EGL_NONE
+        };
+        EGLConfig config;
+        EGLint configCount = 0;
+        if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+            eglTerminate(display);
+            throw std::runtime_error("No suitable EGL config for offscreen rendering");
+        }
+
+        EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+        if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+            if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+            eglTerminate(display);
+            throw std::runtime_error("Failed to create a surfaceless OpenGL context");
+        }
+        m_context = context;
+
+        // Without a surface there is no default framebuffer, so render into our own
+        glGenRenderbuffers(1, &m_colorBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+        glGenRenderbuffers(1, &m_depthBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+        glGenFramebuffers(1, &m_framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            throw std::runtime_error("Offscreen framebuffer is incomplete");
+        }
+    }
+
+    HeadlessContext::~HeadlessContext() {
+        if (m_framebuffer) glDeleteFramebuffers(1, &m_framebuffer);
+        if (m_colorBuffer) glDeleteRenderbuffers(1, &m_colorBuffer);
+        if (m_depthBuffer) glDeleteRenderbuffers(1, &m_depthBuffer);
+
+        if (m_display) {
+            eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (m_context) eglDestroyContext(m_display, m_context);
+            eglTerminate(m_display);
+        }
+    }
+
+    bool HeadlessContext::isSupported() {
+        return true;
+    }
+#else
+    HeadlessContext::HeadlessContext(int width, int height)
+        : m_width(width)
+          , m_height(height)
+          , m_display(nullptr)
+          , m_context(nullptr)
+          , m_framebuffer(0)
+          , m_colorBuffer(0)
+          , m_depthBuffer(0) {
+        throw std::runtime_error("Headless rendering is not available in this build (EGL not found)");
+    }
+
+    HeadlessContext::~HeadlessContext() = default;
+
+    bool HeadlessContext::isSupported() {
+        return false;
+    }
+#endif
+
+    void HeadlessContext::saveImage(const std::string &path) const {
+        std::vector<unsigned char> pixels(static_cast<size_t>(m_width) * m_height * 3);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, m_width, m_height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Cannot write image to " + path);
+        }
+
+        // GL rows run bottom to top, PPM rows top to bottom
+        file << "P6\n" << m_width << " " << m_height << "\n255\n";
+        size_t rowBytes = static_cast<size_t>(m_width) * 3;
+        for (int row = m_height - 1; row >= 0; --row) {
+            file.write(reinterpret_cast<const char *>(pixels.data() + row * rowBytes), rowBytes);
+        }
+    }
+} // namespace CowGL
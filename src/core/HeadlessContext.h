@@ -0,0 +1,48 @@
+//==============================================================================
+// File: core/HeadlessContext.h
+// Purpose: Offscreen OpenGL context for machines without a display
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef HEADLESSCONTEXT_H
+#define HEADLESSCONTEXT_H
+
+
+#include <string>
+
+namespace CowGL {
+    // A surfaceless EGL context rendering into a framebuffer object of a fixed
+    // size. Works with Mesa's llvmpipe, so no GPU or X server is required.
+    class HeadlessContext {
+    public:
+        // Throws if no offscreen context can be created on this platform
+        HeadlessContext(int width, int height);
+
+        ~HeadlessContext();
+
+        HeadlessContext(const HeadlessContext &) = delete;
+
+        HeadlessContext &operator=(const HeadlessContext &) = delete;
+
+        // Writes the current colour buffer as a binary PPM image
+        void saveImage(const std::string &path) const;
+
+        // Whether this build can create offscreen contexts at all
+        static bool isSupported();
+
+    private:
+        int m_width;
+        int m_height;
+
+        // EGL handles, kept opaque so the header does not depend on EGL
+        void *m_display;
+        void *m_context;
+
+        unsigned int m_framebuffer;
+        unsigned int m_colorBuffer;
+        unsigned int m_depthBuffer;
+    };
+} // namespace CowGL
+
+
+#endif //HEADLESSCONTEXT_H
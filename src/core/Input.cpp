@@ -5,40 +5,114 @@
 //==============================================================================
 
 #include "core/Input.h"
-#include <GLUT/glut.h>
+#include "utils/OpenGL.h"
+
+#include <algorithm>
 
 namespace CowGL {
     void Input::update() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_applyingEvents.swap(m_pendingEvents);
+        }
+
+        // A replay stands in for the window until it has been played out
+        if (isReplaying()) {
+            m_applyingEvents.clear();
+            for (; m_replayCursor < m_replayEvents.size() && m_replayEvents[m_replayCursor].tick <= m_tick;
+                   ++m_replayCursor) {
+                m_applyingEvents.push_back({m_replayEvents[m_replayCursor], {}});
+            }
+        }
+
+        for (PendingEvent &pending: m_applyingEvents) {
+            InputEvent &event = pending.event;
+            if (!apply(event) || !m_recording) continue;
+
+            event.tick = m_tick;
+            if (pending.time != std::chrono::steady_clock::time_point()) {
+                event.timeMs = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::max(pending.time, m_recordingStart) - m_recordingStart).count());
+            }
+            m_recordedEvents.push_back(event);
+        }
+        m_applyingEvents.clear();
+        ++m_tick;
+
         // Update mouse delta
         m_mouseDelta = m_mousePosition - m_lastMousePosition;
         m_lastMousePosition = m_mousePosition;
     }
 
+    bool Input::apply(const InputEvent &event) {
+        bool changed = false;
+        size_t button = event.code;
+
+        switch (event.type) {
+            case InputEvent::Type::KeyDown:
+                if (m_keyStates.test(event.code)) return false;
+                m_keyStates.set(event.code);
+                m_keyJustPressed.set(event.code);
+                return true;
+            case InputEvent::Type::KeyUp:
+                if (!m_keyStates.test(event.code)) return false;
+                m_keyStates.reset(event.code);
+                return true;
+            case InputEvent::Type::MouseDown:
+            case InputEvent::Type::MouseUp: {
+                if (button >= m_mouseButtonStates.size()) return false;
+                bool pressed = event.type == InputEvent::Type::MouseDown;
+                if (pressed && !m_mouseButtonStates[button]) {
+                    m_mouseButtonJustPressed[button] = true;
+                }
+                changed = m_mouseButtonStates[button] != pressed;
+                m_mouseButtonStates[button] = pressed;
+                break;
+            }
+            case InputEvent::Type::MouseMove:
+                break;
+        }
+
+        glm::vec2 position(event.x, event.y);
+        changed = changed || position.x != m_mousePosition.x || position.y != m_mousePosition.y;
+        m_mousePosition = position;
+        return changed;
+    }
+
     void Input::clearFrameStates() {
         // Clear just pressed states
         m_keyJustPressed.clear();
         m_mouseButtonJustPressed.fill(false);
     }
 
-    void Input::onKeyPress(unsigned char key, int x, int y) {
-        if (!m_keyStates[key]) {
-            m_keyJustPressed[key] = true;
-        }
-        m_keyStates[key] = true;
+    void Input::startRecording() {
+        m_recording = true;
+        m_recordingStart = std::chrono::steady_clock::now();
+        m_recordedEvents.clear();
     }
 
-    void Input::onKeyRelease(unsigned char key, int x, int y) {
-        m_keyStates[key] = false;
+    void Input::startReplay(std::vector<InputEvent> events) {
+        m_replayEvents = std::move(events);
+        m_replayCursor = 0;
+    }
+
+    void Input::queue(const InputEvent &event) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingEvents.push_back({event, std::chrono::steady_clock::now()});
     }
 
-    bool Input::isKeyPressed(unsigned char key) const {
-        auto it = m_keyStates.find(key);
-        return it != m_keyStates.end() && it->second;
+    void Input::onKeyPress(unsigned char key, int x, int y) {
+        InputEvent event;
+        event.type = InputEvent::Type::KeyDown;
+        event.code = key;
+        queue(event);
     }
 
-    bool Input::isKeyJustPressed(unsigned char key) const {
-        auto it = m_keyJustPressed.find(key);
-        return it != m_keyJustPressed.end() && it->second;
+    void Input::onKeyRelease(unsigned char key, int x, int y) {
+        InputEvent event;
+        event.type = InputEvent::Type::KeyUp;
+        event.code = key;
+        queue(event);
     }
 
     void Input::onMouseButton(int button, int state, int x, int y) {
@@ -53,19 +127,20 @@ namespace CowGL {
             default: return;
         }
 
-        size_t index = static_cast<size_t>(mb);
-        bool pressed = (state == GLUT_DOWN);
-
-        if (pressed && !m_mouseButtonStates[index]) {
-            m_mouseButtonJustPressed[index] = true;
-        }
-
-        m_mouseButtonStates[index] = pressed;
-        m_mousePosition = glm::vec2(x, y);
+        InputEvent event;
+        event.type = state == GLUT_DOWN ? InputEvent::Type::MouseDown : InputEvent::Type::MouseUp;
+        event.code = static_cast<uint8_t>(mb);
+        event.x = static_cast<int16_t>(x);
+        event.y = static_cast<int16_t>(y);
+        queue(event);
     }
 
     void Input::onMouseMove(int x, int y) {
-        m_mousePosition = glm::vec2(x, y);
+        InputEvent event;
+        event.type = InputEvent::Type::MouseMove;
+        event.x = static_cast<int16_t>(x);
+        event.y = static_cast<int16_t>(y);
+        queue(event);
     }
 
     bool Input::isMouseButtonPressed(MouseButton button) const {
@@ -8,11 +8,19 @@
 #define INPUT_H
 
 
-#include <unordered_map>
 #include <array>
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include "core/InputRecording.h"
+#include "core/InputActions.h"
 #include "utils/Math.h"
 
 namespace CowGL {
+    // Window events arrive on the render thread and are queued under a lock;
+    // update() applies them on the simulation thread once per tick, and every query
+    // reads the state as of that tick. Applied events can be recorded with their
+    // tick, and a recording can be replayed in place of live events.
     class Input {
     public:
         enum class MouseButton {
@@ -40,9 +48,18 @@ namespace CowGL {
 
         void onKeyRelease(unsigned char key, int x, int y);
 
-        bool isKeyPressed(unsigned char key) const;
+        bool isKeyPressed(unsigned char key) const { return m_keyStates.test(key); }
 
-        bool isKeyJustPressed(unsigned char key) const;
+        bool isKeyJustPressed(unsigned char key) const { return m_keyJustPressed.test(key); }
+
+        // Whether any key bound to the action is held, or went down this tick
+        bool isActionPressed(Action action) const {
+            return m_keyStates.intersects(ACTION_KEYS[static_cast<size_t>(action)]);
+        }
+
+        bool isActionJustPressed(Action action) const {
+            return m_keyJustPressed.intersects(ACTION_KEYS[static_cast<size_t>(action)]);
+        }
 
         // Mouse
         void onMouseButton(int button, int state, int x, int y);
@@ -58,9 +75,33 @@ namespace CowGL {
 
         void clearFrameStates();
 
+        // Simulation thread, or before it starts: keeps every event that changes state
+        void startRecording();
+
+        const std::vector<InputEvent> &getRecordedEvents() const { return m_recordedEvents; }
+
+        // Applies the events at their ticks and ignores live input until they run out
+        void startReplay(std::vector<InputEvent> events);
+
+        bool isReplaying() const { return m_replayCursor < m_replayEvents.size(); }
+
+        // Ticks applied so far
+        uint32_t getTick() const { return m_tick; }
+
     private:
-        std::unordered_map<unsigned char, bool> m_keyStates;
-        std::unordered_map<unsigned char, bool> m_keyJustPressed;
+        // Queued events carry their arrival time until they are applied
+        struct PendingEvent {
+            InputEvent event;
+            std::chrono::steady_clock::time_point time;
+        };
+
+        void queue(const InputEvent &event);
+
+        // Returns whether the event changed any state
+        bool apply(const InputEvent &event);
+
+        KeySet m_keyStates;
+        KeySet m_keyJustPressed;
 
         std::array<bool, static_cast<size_t>(MouseButton::Count)> m_mouseButtonStates;
         std::array<bool, static_cast<size_t>(MouseButton::Count)> m_mouseButtonJustPressed;
@@ -68,6 +109,20 @@ namespace CowGL {
         glm::vec2 m_mousePosition;
         glm::vec2 m_lastMousePosition;
         glm::vec2 m_mouseDelta;
+
+        // Events received since the last update
+        std::mutex m_mutex;
+        std::vector<PendingEvent> m_pendingEvents;
+        std::vector<PendingEvent> m_applyingEvents;
+
+        uint32_t m_tick = 0;
+
+        bool m_recording = false;
+        std::chrono::steady_clock::time_point m_recordingStart;
+        std::vector<InputEvent> m_recordedEvents;
+
+        std::vector<InputEvent> m_replayEvents;
+        size_t m_replayCursor = 0;
     };
 } // namespace CowGL
 
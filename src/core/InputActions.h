@@ -0,0 +1,152 @@
+//==============================================================================
+// File: core/InputActions.h
+// Purpose: Flat key sets and the compile-time table binding keys to actions
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef INPUTACTIONS_H
+#define INPUTACTIONS_H
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace CowGL {
+    // One bit per key code, so clearing or comparing sets takes four word operations
+    struct KeySet {
+        uint64_t words[4] = {};
+
+        constexpr void set(unsigned char key) { words[key >> 6] |= uint64_t(1) << (key & 63); }
+        constexpr void reset(unsigned char key) { words[key >> 6] &= ~(uint64_t(1) << (key & 63)); }
+        constexpr bool test(unsigned char key) const { return (words[key >> 6] >> (key & 63)) & 1; }
+
+        constexpr bool intersects(const KeySet &other) const {
+            return ((words[0] & other.words[0]) | (words[1] & other.words[1]) |
+                    (words[2] & other.words[2]) | (words[3] & other.words[3])) != 0;
+        }
+
+        constexpr bool empty() const { return (words[0] | words[1] | words[2] | words[3]) == 0; }
+
+        constexpr void clear() {
+            words[0] = 0;
+            words[1] = 0;
+            words[2] = 0;
+            words[3] = 0;
+        }
+    };
+
+    // What the simulation reacts to, independent of the keys bound to it
+    enum class Action : uint8_t {
+        // Cow movement
+        MoveForward,
+        MoveBackward,
+        TurnLeft,
+        TurnRight,
+
+        // Cow control modes, and the head or tail depending on the mode
+        ControlMovement,
+        ControlHead,
+        ControlTail,
+        PartUp,
+        PartDown,
+        PartLeft,
+        PartRight,
+        ResetPose,
+
+        // Camera
+        ToggleCamera,
+        OrbitUp,
+        OrbitDown,
+        OrbitLeft,
+        OrbitRight,
+        ZoomIn,
+        ZoomOut,
+        ResetCamera,
+
+        // Menus and lighting
+        ToggleHelp,
+        ToggleProfiler,
+        SaveTrace,
+        CloseMenus,
+        AmbientUp,
+        AmbientDown,
+        SunIntensityUp,
+        SunIntensityDown,
+        SunAngleUp,
+        SunAngleDown,
+
+        Quit,
+        Count
+    };
+
+    constexpr size_t ACTION_COUNT = static_cast<size_t>(Action::Count);
+
+    struct ActionBinding {
+        Action action;
+        const char *keys; // Every key that triggers the action
+    };
+
+    constexpr ActionBinding ACTION_BINDINGS[] = {
+        {Action::MoveForward, "wW"},
+        {Action::MoveBackward, "sS"},
+        {Action::TurnLeft, "aA"},
+        {Action::TurnRight, "dD"},
+
+        {Action::ControlMovement, "mM"},
+        {Action::ControlHead, "hH"},
+        {Action::ControlTail, "tT"},
+        {Action::PartUp, "iI"},
+        {Action::PartDown, "kK"},
+        {Action::PartLeft, "jJ"},
+        {Action::PartRight, "lL"},
+        {Action::ResetPose, "rR5"},
+
+        {Action::ToggleCamera, "vV"},
+        {Action::OrbitUp, "8"},
+        {Action::OrbitDown, "2"},
+        {Action::OrbitLeft, "4"},
+        {Action::OrbitRight, "6"},
+        {Action::ZoomIn, "1"},
+        {Action::ZoomOut, "7"},
+        {Action::ResetCamera, "5"},
+
+        {Action::ToggleHelp, "hH"},
+        {Action::ToggleProfiler, "pP"},
+        {Action::SaveTrace, "oO"},
+        {Action::CloseMenus, "\r"},
+        {Action::AmbientUp, "+="},
+        {Action::AmbientDown, "-_"},
+        {Action::SunIntensityUp, "]"},
+        {Action::SunIntensityDown, "["},
+        {Action::SunAngleUp, ">."},
+        {Action::SunAngleDown, "<,"},
+
+        {Action::Quit, "qQ"},
+    };
+
+    // Keys of every action, resolved from the bindings at compile time
+    constexpr std::array<KeySet, ACTION_COUNT> buildActionKeys() {
+        std::array<KeySet, ACTION_COUNT> actionKeys{};
+        for (const ActionBinding &binding: ACTION_BINDINGS) {
+            for (const char *key = binding.keys; *key; ++key) {
+                actionKeys[static_cast<size_t>(binding.action)].set(static_cast<unsigned char>(*key));
+            }
+        }
+        return actionKeys;
+    }
+
+    inline constexpr std::array<KeySet, ACTION_COUNT> ACTION_KEYS = buildActionKeys();
+
+    constexpr bool allActionsBound() {
+        for (const KeySet &keys: ACTION_KEYS) {
+            if (keys.empty()) return false;
+        }
+        return true;
+    }
+
+    static_assert(allActionsBound(), "Every action needs at least one key binding");
+} // namespace CowGL
+
+
+#endif //INPUTACTIONS_H
@@ -0,0 +1,97 @@
+//==============================================================================
+// File: core/InputRecording.cpp
+// Purpose: Input recording file reading and writing
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "core/InputRecording.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace CowGL {
+    namespace {
+        const char MAGIC[4] = {'C', 'G', 'I', 'R'};
+        const uint16_t VERSION = 1;
+
+        template<typename T>
+        void write(std::ostream &out, T value) {
+            for (size_t i = 0; i < sizeof(T); ++i) {
+                out.put(static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF));
+            }
+        }
+
+        template<typename T>
+        T read(std::istream &in) {
+            uint64_t value = 0;
+            for (size_t i = 0; i < sizeof(T); ++i) {
+                value |= static_cast<uint64_t>(static_cast<uint8_t>(in.get())) << (8 * i);
+            }
+            return static_cast<T>(value);
+        }
+    }
+
+    void InputRecording::save(const std::string &path) const {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) {
+            throw std::runtime_error("Cannot write input recording '" + path + "'");
+        }
+
+        out.write(MAGIC, sizeof(MAGIC));
+        write<uint16_t>(out, VERSION);
+        write<uint32_t>(out, tickRate);
+        write<uint16_t>(out, width);
+        write<uint16_t>(out, height);
+        write<uint32_t>(out, static_cast<uint32_t>(events.size()));
+
+        for (const InputEvent &event: events) {
+            write<uint32_t>(out, event.tick);
+            write<uint32_t>(out, event.timeMs);
+            write<uint8_t>(out, static_cast<uint8_t>(event.type));
+            write<uint8_t>(out, event.code);
+            write<uint16_t>(out, static_cast<uint16_t>(event.x));
+            write<uint16_t>(out, static_cast<uint16_t>(event.y));
+        }
+
+        if (!out) {
+            throw std::runtime_error("Failed writing input recording '" + path + "'");
+        }
+    }
+
+    InputRecording InputRecording::load(const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Cannot open input recording '" + path + "'");
+        }
+
+        char magic[sizeof(MAGIC)] = {};
+        in.read(magic, sizeof(magic));
+        if (!in || !std::equal(magic, magic + sizeof(magic), MAGIC) || read<uint16_t>(in) != VERSION) {
+            throw std::runtime_error("'" + path + "' is not a CowGL input recording");
+        }
+
+        InputRecording recording;
+        recording.tickRate = read<uint32_t>(in);
+        recording.width = read<uint16_t>(in);
+        recording.height = read<uint16_t>(in);
+        uint32_t count = read<uint32_t>(in);
+
+        recording.events.reserve(count);
+        for (uint32_t i = 0; i < count && in; ++i) {
+            InputEvent event;
+            event.tick = read<uint32_t>(in);
+            event.timeMs = read<uint32_t>(in);
+            event.type = static_cast<InputEvent::Type>(read<uint8_t>(in));
+            event.code = read<uint8_t>(in);
+            event.x = static_cast<int16_t>(read<uint16_t>(in));
+            event.y = static_cast<int16_t>(read<uint16_t>(in));
+            recording.events.push_back(event);
+        }
+
+        if (!in || recording.tickRate == 0) {
+            throw std::runtime_error("Input recording '" + path + "' is truncated");
+        }
+        return recording;
+    }
+} // namespace CowGL
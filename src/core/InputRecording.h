@@ -0,0 +1,50 @@
+//==============================================================================
+// File: core/InputRecording.h
+// Purpose: Recorded input events and their binary file format
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef INPUTRECORDING_H
+#define INPUTRECORDING_H
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CowGL {
+    // One change of keyboard or mouse state
+    struct InputEvent {
+        enum class Type : uint8_t {
+            KeyDown,
+            KeyUp,
+            MouseDown,
+            MouseUp,
+            MouseMove
+        };
+
+        Type type = Type::KeyDown;
+        uint8_t code = 0;   // Key, or mouse button index
+        int16_t x = 0;      // Mouse position, in window coordinates
+        int16_t y = 0;
+        uint32_t tick = 0;  // Simulation tick the event was applied in
+        uint32_t timeMs = 0; // Arrival time since the recording started
+    };
+
+    // A session's input, in the order it was applied, along with the settings the
+    // replay has to match to reproduce it
+    struct InputRecording {
+        uint32_t tickRate = 60;
+        uint16_t width = 0;
+        uint16_t height = 0;
+        std::vector<InputEvent> events;
+
+        // Little-endian: header, then 14 bytes per event; throws on I/O errors
+        void save(const std::string &path) const;
+
+        static InputRecording load(const std::string &path);
+    };
+} // namespace CowGL
+
+
+#endif //INPUTRECORDING_H
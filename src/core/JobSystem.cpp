@@ -0,0 +1,171 @@
+//==============================================================================
+// File: core/JobSystem.cpp
+// Purpose: Job system implementation
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "core/JobSystem.h"
+#include "core/Profiler.h"
+
+#include <algorithm>
+
+namespace CowGL {
+    namespace {
+        // Rounds an idle worker spins looking for work before it sleeps
+        const int IDLE_SPINS = 64;
+
+        thread_local const JobSystem *t_system = nullptr;
+        thread_local int t_queueIndex = 0;
+    }
+
+    JobSystem::JobSystem(int threadCount) {
+        if (threadCount <= 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // Queue 0 belongs to the threads calling into the system, the rest to workers
+        for (int i = 0; i < threadCount; ++i) {
+            m_queues.push_back(std::make_unique<Queue>());
+        }
+        for (int i = 1; i < threadCount; ++i) {
+            m_workers.emplace_back(&JobSystem::workerLoop, this, i);
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+
+        for (std::thread &worker: m_workers) {
+            worker.join();
+        }
+    }
+
+    void JobSystem::parallelFor(size_t count, size_t grainSize,
+                                const std::function<void(size_t, size_t)> &body) {
+        if (count == 0) return;
+
+        grainSize = std::max<size_t>(grainSize, 1);
+        if (m_workers.empty() || count <= grainSize) {
+            body(0, count);
+            return;
+        }
+
+        // The caller takes the first half of every split and helps with the rest
+        // until every piece it handed out has run
+        std::atomic<size_t> pending{0};
+        runRange(0, count, grainSize, body, pending);
+
+        while (pending.load(std::memory_order_acquire) > 0) {
+            if (!tryRun()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::runRange(size_t begin, size_t end, size_t grainSize,
+                             const std::function<void(size_t, size_t)> &body, std::atomic<size_t> &pending) {
+        while (end - begin > grainSize) {
+            size_t middle = begin + (end - begin) / 2;
+
+            // Counted before it can run, so pending only reaches zero at the very end
+            pending.fetch_add(1, std::memory_order_relaxed);
+
+            Job job;
+            job.function = [this, middle, end, grainSize, &body, &pending]() {
+                runRange(middle, end, grainSize, body, pending);
+            };
+            job.pending = &pending;
+            push(std::move(job));
+
+            end = middle;
+        }
+
+        body(begin, end);
+    }
+
+    void JobSystem::push(Job job) {
+        Queue &queue = *m_queues[getQueueIndex()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+        }
+        m_queuedJobs.fetch_add(1, std::memory_order_release);
+
+        // Taking the sleep lock orders the push before a worker's check of the count
+        { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+        m_wake.notify_one();
+    }
+
+    bool JobSystem::tryRun() {
+        int own = getQueueIndex();
+        int count = static_cast<int>(m_queues.size());
+
+        Job job;
+        bool found = false;
+
+        // Newest own job first, it is the most likely to still be in cache
+        {
+            Queue &queue = *m_queues[own];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty()) {
+                job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+                found = true;
+            }
+        }
+
+        // Otherwise the oldest job of another thread, which is usually the largest range
+        for (int offset = 1; !found && offset < count; ++offset) {
+            Queue &queue = *m_queues[(own + offset) % count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty()) {
+                job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                found = true;
+            }
+        }
+
+        if (!found) return false;
+
+        m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        run(job);
+        return true;
+    }
+
+    void JobSystem::run(Job &job) {
+        job.function();
+        job.pending->fetch_sub(1, std::memory_order_release);
+    }
+
+    int JobSystem::getQueueIndex() const {
+        return t_system == this ? t_queueIndex : 0;
+    }
+
+    void JobSystem::workerLoop(int index) {
+        t_system = this;
+        t_queueIndex = index;
+        Profiler::setThreadName("Worker");
+
+        while (true) {
+            bool worked = false;
+            for (int spin = 0; spin < IDLE_SPINS; ++spin) {
+                if (tryRun()) {
+                    worked = true;
+                    break;
+                }
+                std::this_thread::yield();
+            }
+            if (worked) continue;
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wake.wait(lock, [this]() {
+                return m_stopping || m_queuedJobs.load(std::memory_order_acquire) > 0;
+            });
+            if (m_stopping) return;
+        }
+    }
+} // namespace CowGL
@@ -0,0 +1,84 @@
+//==============================================================================
+// File: core/JobSystem.h
+// Purpose: Work-stealing task scheduler with a parallel for
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CowGL {
+    // A fixed pool of threads, each with its own deque of jobs. Threads run their
+    // own jobs newest first and, when out of work, steal the oldest job of another
+    // thread. The thread that starts a parallel for works on it as well, so a
+    // system with one thread runs everything inline.
+    class JobSystem {
+    public:
+        // Total threads including the caller's; 0 uses every hardware thread
+        explicit JobSystem(int threadCount = 0);
+
+        ~JobSystem();
+
+        JobSystem(const JobSystem &) = delete;
+
+        JobSystem &operator=(const JobSystem &) = delete;
+
+        int getThreadCount() const { return static_cast<int>(m_queues.size()); }
+
+        // Calls body(begin, end) over disjoint sub-ranges covering [0, count) and
+        // returns once all of them ran. Ranges are split in halves down to grainSize
+        // items, and the halves are left for idle threads to steal.
+        void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)> &body);
+
+    private:
+        struct Job {
+            std::function<void()> function;
+            std::atomic<size_t> *pending = nullptr; // Decremented once the job ran
+        };
+
+        // Guarded by its own lock; contention only occurs when a thief visits
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        void workerLoop(int index);
+
+        void push(Job job);
+
+        // Pops from the calling thread's own queue, then steals from the others
+        bool tryRun();
+
+        void run(Job &job);
+
+        // Splits [begin, end) until a piece is no larger than grainSize
+        void runRange(size_t begin, size_t end, size_t grainSize,
+                      const std::function<void(size_t, size_t)> &body, std::atomic<size_t> &pending);
+
+        // Index of the calling thread's queue; threads outside the pool share queue 0
+        int getQueueIndex() const;
+
+        std::vector<std::unique_ptr<Queue> > m_queues;
+        std::vector<std::thread> m_workers;
+
+        // Idle workers sleep until jobs are pushed
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wake;
+        std::atomic<size_t> m_queuedJobs{0};
+        std::atomic<bool> m_stopping{false};
+    };
+} // namespace CowGL
+
+
+#endif //JOBSYSTEM_H
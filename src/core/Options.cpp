@@ -0,0 +1,95 @@
+//==============================================================================
+// File: core/Options.cpp
+// Purpose: Command line option parsing
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "core/Options.h"
+#include <stdexcept>
+
+namespace CowGL {
+    namespace {
+        const char *requireValue(int argc, char **argv, int &i, const char *what) {
+            if (i + 1 >= argc) {
+                throw std::runtime_error(std::string(argv[i]) + " requires " + what);
+            }
+            return argv[++i];
+        }
+
+        int parseNumber(const std::string &value, const std::string &option, int minimum, const char *what) {
+            size_t used = 0;
+            int result = 0;
+            try {
+                result = std::stoi(value, &used);
+            } catch (const std::exception &) {
+                used = 0;
+            }
+            if (used != value.size() || result < minimum) {
+                throw std::runtime_error(option + " expects " + what + ", got '" + value + "'");
+            }
+            return result;
+        }
+
+        int parsePositive(const std::string &value, const std::string &option) {
+            return parseNumber(value, option, 1, "a positive number");
+        }
+    }
+
+    Options Options::parse(int argc, char **argv) {
+        Options options;
+
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+
+            if (arg == "--bench") {
+                options.benchmark = requireValue(argc, argv, i, "a benchmark name");
+            } else if (arg == "--headless") {
+                options.headless = true;
+            } else if (arg == "--frames") {
+                options.frames = parsePositive(requireValue(argc, argv, i, "a frame count"), arg);
+            } else if (arg == "--output") {
+                options.outputPath = requireValue(argc, argv, i, "a file name");
+            } else if (arg == "--record") {
+                options.recordPath = requireValue(argc, argv, i, "a file name");
+            } else if (arg == "--replay") {
+                options.replayPath = requireValue(argc, argv, i, "a file name");
+            } else if (arg == "--tick-rate") {
+                options.tickRate = parsePositive(requireValue(argc, argv, i, "ticks per second"), arg);
+            } else if (arg == "--fps") {
+                std::string rate = requireValue(argc, argv, i, "frames per second");
+                if (rate == "unlimited") {
+                    options.frameRateMode = FrameRateMode::Uncapped;
+                } else {
+                    options.frameRateMode = FrameRateMode::Capped;
+                    options.frameRateCap = parsePositive(rate, arg);
+                }
+            } else if (arg == "--vsync") {
+                options.frameRateMode = FrameRateMode::VSync;
+            } else if (arg == "--uncapped") {
+                options.frameRateMode = FrameRateMode::Uncapped;
+            } else if (arg == "--no-idle") {
+                options.idle = false;
+            } else if (arg == "--headless-idle") {
+                options.headlessIdle = true;
+            } else if (arg == "--threads") {
+                // 0 asks for every hardware thread, the same as leaving it out
+                options.threads = parseNumber(requireValue(argc, argv, i, "a thread count"), arg, 0,
+                                              "a thread count, or 0 for every hardware thread");
+            } else if (arg == "--profile-csv") {
+                options.profilePath = requireValue(argc, argv, i, "a file name");
+            } else if (arg == "--trace") {
+                options.tracePath = requireValue(argc, argv, i, "a file name");
+            } else if (arg == "--size") {
+                std::string size = requireValue(argc, argv, i, "WIDTHxHEIGHT");
+                size_t separator = size.find('x');
+                if (separator == std::string::npos) {
+                    throw std::runtime_error("--size expects WIDTHxHEIGHT, got '" + size + "'");
+                }
+                options.width = parsePositive(size.substr(0, separator), arg);
+                options.height = parsePositive(size.substr(separator + 1), arg);
+            }
+        }
+
+        return options;
+    }
+} // namespace CowGL
@@ -0,0 +1,65 @@
+//==============================================================================
+// File: core/Options.h
+// Purpose: Command line options for the application
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+
+#include <string>
+
+namespace CowGL {
+    // How the interactive session paces rendering; the simulation always ticks at a fixed rate
+    enum class FrameRateMode {
+        Capped,   // At most frameRateCap frames per second
+        VSync,    // One frame per display refresh
+        Uncapped  // As fast as possible
+    };
+
+    struct Options {
+        // Name of the benchmark to run instead of the interactive session
+        std::string benchmark;
+
+        // Render offscreen through a plain frame loop instead of a GLUT window
+        bool headless = false;
+        int frames = 300;
+        std::string outputPath; // Last headless frame as a PPM image, if set
+
+        // Input recorded to a file on exit, and a recording to play back instead of live
+        // input; a replay renders `frames` frames and prints frame time statistics
+        std::string recordPath;
+        std::string replayPath;
+
+        // Per-zone frame timings written on exit by profiler builds; empty disables it
+        std::string profilePath = "profile.csv";
+
+        // Chrome trace of the recent frames, saved on O and on exit by profiler builds
+        std::string tracePath;
+
+        // Simulation ticks per second, independent of how often frames are drawn
+        int tickRate = 60;
+
+        FrameRateMode frameRateMode = FrameRateMode::Capped;
+        int frameRateCap = 60;
+
+        // Stop ticking and drawing while nothing changes, until the next input event
+        bool idle = true;
+
+        // Headless runs draw every frame unless asked to stop once the scene settles
+        bool headlessIdle = false;
+
+        // Threads sharing the simulation's object updates; 0 uses every hardware thread
+        int threads = 0;
+
+        // Window or offscreen framebuffer size
+        int width = 1024;
+        int height = 768;
+
+        static Options parse(int argc, char **argv);
+    };
+} // namespace CowGL
+
+
+#endif //OPTIONS_H
@@ -0,0 +1,449 @@
+//==============================================================================
+// File: core/Profiler.cpp
+// Purpose: Profiler implementation
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "core/Profiler.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+
+namespace CowGL {
+    namespace Profiler {
+        namespace {
+            using Clock = std::chrono::steady_clock;
+
+            struct Zone {
+                const char *name;
+                int parent;
+                int depth;
+                std::vector<int> children;
+
+                Clock::time_point start;
+                double frameMs = 0.0; // Accumulated over the current frame
+
+                // Milliseconds per frame, indexed by frame number modulo the history
+                std::array<float, HISTORY_FRAMES> history{};
+                uint64_t firstFrame = 0;
+            };
+
+            enum class TraceType : uint32_t {
+                Begin,
+                End,
+                Counter
+            };
+
+            // One slot of a thread's trace ring. Only the owning thread writes; every
+            // field is atomic so a save on another thread can read along without locks.
+            struct TraceSlot {
+                std::atomic<int64_t> time{0}; // Nanoseconds since the trace started
+                std::atomic<const char *> name{nullptr};
+                std::atomic<TraceType> type{TraceType::Begin};
+                std::atomic<double> value{0.0};
+            };
+
+            struct TraceEvent {
+                int64_t time;
+                const char *name;
+                TraceType type;
+                double value;
+            };
+
+            // Zones of one thread. Zone 0 is the whole frame; the stack holds the open
+            // zones, root first. Only the owning thread times zones, the mutex guards
+            // the zone list and histories against readers on other threads.
+            struct ThreadProfile {
+                std::vector<Zone> zones;
+                std::vector<int> stack;
+                uint64_t frameCount = 0;
+                std::mutex mutex;
+
+                // Trace ring, allocated by the first event. An event is claimed before
+                // its slot is overwritten and counted as written once it is complete.
+                std::unique_ptr<TraceSlot[]> traceStorage;
+                std::atomic<TraceSlot *> traceSlots{nullptr};
+                std::atomic<uint64_t> traceClaimed{0};
+                std::atomic<uint64_t> traceWritten{0};
+            };
+
+            std::mutex s_registryMutex;
+            std::vector<std::unique_ptr<ThreadProfile> > s_threads;
+            thread_local ThreadProfile *t_profile = nullptr;
+
+            std::atomic<bool> s_overlayVisible{false};
+            std::string s_csvPath;
+
+            std::atomic<bool> s_tracing{false};
+            std::atomic<Clock::rep> s_traceEpoch{0};
+            std::string s_tracePath;
+
+            ThreadProfile &profile() {
+                if (!t_profile) {
+                    // Profiles outlive their threads so their timings still reach the CSV
+                    auto profile = std::make_unique<ThreadProfile>();
+                    Zone frame;
+                    frame.name = "Frame";
+                    frame.parent = -1;
+                    frame.depth = 0;
+                    profile->zones.push_back(frame);
+                    profile->stack.push_back(0);
+
+                    t_profile = profile.get();
+                    std::lock_guard<std::mutex> lock(s_registryMutex);
+                    s_threads.push_back(std::move(profile));
+                }
+                return *t_profile;
+            }
+
+            int findOrAddChild(ThreadProfile &profile, int parent, const char *name) {
+                for (int child: profile.zones[parent].children) {
+                    if (profile.zones[child].name == name) return child;
+                }
+
+                Zone zone;
+                zone.name = name;
+                zone.parent = parent;
+                zone.depth = profile.zones[parent].depth + 1;
+                zone.firstFrame = profile.frameCount;
+
+                std::lock_guard<std::mutex> lock(profile.mutex);
+                int index = static_cast<int>(profile.zones.size());
+                profile.zones.push_back(zone);
+                profile.zones[parent].children.push_back(index);
+                return index;
+            }
+
+            ZoneStats summarize(const Zone &zone, uint64_t frameCount) {
+                ZoneStats stats;
+                stats.name = zone.name;
+                stats.depth = zone.depth;
+
+                uint64_t recorded = frameCount - zone.firstFrame;
+                stats.frames = static_cast<int>(std::min<uint64_t>(recorded, HISTORY_FRAMES));
+                if (stats.frames == 0) return stats;
+
+                // The most recent frames occupy the slots just before the write position
+                std::vector<float> samples;
+                samples.reserve(stats.frames);
+                for (int i = 1; i <= stats.frames; ++i) {
+                    samples.push_back(zone.history[(frameCount - i) % HISTORY_FRAMES]);
+                }
+                stats.lastMs = samples.front();
+
+                double sum = 0.0;
+                for (float sample: samples) sum += sample;
+                stats.avgMs = sum / samples.size();
+
+                auto [minIt, maxIt] = std::minmax_element(samples.begin(), samples.end());
+                stats.minMs = *minIt;
+                stats.maxMs = *maxIt;
+
+                size_t p99 = (samples.size() * 99) / 100;
+                std::nth_element(samples.begin(), samples.begin() + p99, samples.end());
+                stats.p99Ms = samples[p99];
+                return stats;
+            }
+
+            void collect(const ThreadProfile &profile, int index, std::vector<ZoneStats> &out) {
+                out.push_back(summarize(profile.zones[index], profile.frameCount));
+                for (int child: profile.zones[index].children) {
+                    collect(profile, child, out);
+                }
+            }
+
+            void record(ThreadProfile &current, TraceType type, const char *name, double value) {
+                TraceSlot *slots = current.traceSlots.load(std::memory_order_relaxed);
+                if (!slots) {
+                    current.traceStorage = std::make_unique<TraceSlot[]>(TRACE_EVENTS_PER_THREAD);
+                    slots = current.traceStorage.get();
+                    current.traceSlots.store(slots, std::memory_order_release);
+                }
+
+                // A reader that sees any part of the new event also sees the claim,
+                // and drops whatever used to be in the slot
+                uint64_t index = current.traceWritten.load(std::memory_order_relaxed);
+                current.traceClaimed.store(index + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                TraceSlot &slot = slots[index % TRACE_EVENTS_PER_THREAD];
+                Clock::rep now = Clock::now().time_since_epoch().count();
+                auto elapsed = Clock::duration(now - s_traceEpoch.load(std::memory_order_relaxed));
+                slot.time.store(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                                std::memory_order_relaxed);
+                slot.name.store(name, std::memory_order_relaxed);
+                slot.type.store(type, std::memory_order_relaxed);
+                slot.value.store(value, std::memory_order_relaxed);
+
+                current.traceWritten.store(index + 1, std::memory_order_release);
+            }
+
+            bool isTracingNow() {
+                return s_tracing.load(std::memory_order_relaxed);
+            }
+
+            // The thread's events that were complete and not yet overwritten, oldest first
+            std::vector<TraceEvent> readTrace(const ThreadProfile &profile) {
+                std::vector<TraceEvent> events;
+                const TraceSlot *slots = profile.traceSlots.load(std::memory_order_acquire);
+                if (!slots) return events;
+
+                uint64_t end = profile.traceWritten.load(std::memory_order_acquire);
+                uint64_t begin = end > TRACE_EVENTS_PER_THREAD ? end - TRACE_EVENTS_PER_THREAD : 0;
+                events.reserve(end - begin);
+                for (uint64_t i = begin; i < end; ++i) {
+                    const TraceSlot &slot = slots[i % TRACE_EVENTS_PER_THREAD];
+                    events.push_back({slot.time.load(std::memory_order_relaxed),
+                                      slot.name.load(std::memory_order_relaxed),
+                                      slot.type.load(std::memory_order_relaxed),
+                                      slot.value.load(std::memory_order_relaxed)});
+                }
+
+                // Slots the thread started reusing while they were copied are torn
+                std::atomic_thread_fence(std::memory_order_acquire);
+                uint64_t claimed = profile.traceClaimed.load(std::memory_order_relaxed);
+                uint64_t valid = claimed > TRACE_EVENTS_PER_THREAD ? claimed - TRACE_EVENTS_PER_THREAD : 0;
+                if (valid > begin) {
+                    events.erase(events.begin(), events.begin() + std::min(valid - begin, end - begin));
+                }
+                return events;
+            }
+
+            void writeJsonString(FILE *file, const char *text) {
+                std::fputc('"', file);
+                for (const char *c = text; *c; ++c) {
+                    if (*c == '"' || *c == '\\') {
+                        std::fputc('\\', file);
+                        std::fputc(*c, file);
+                    } else if (static_cast<unsigned char>(*c) < 0x20) {
+                        std::fprintf(file, "\\u%04x", *c);
+                    } else {
+                        std::fputc(*c, file);
+                    }
+                }
+                std::fputc('"', file);
+            }
+
+            void saveTraceAtExit() {
+                if (!saveTrace()) {
+                    std::fprintf(stderr, "Could not write trace to %s\n", s_tracePath.c_str());
+                }
+            }
+
+            void writeCsvAtExit() {
+                if (!writeCsv(s_csvPath)) {
+                    std::fprintf(stderr, "Could not write profile to %s\n", s_csvPath.c_str());
+                }
+            }
+        }
+
+        void setThreadName(const char *name) {
+            ThreadProfile &current = profile();
+            std::lock_guard<std::mutex> lock(current.mutex);
+            current.zones[0].name = name;
+        }
+
+        void beginFrame() {
+            ThreadProfile &current = profile();
+
+            // A zone left open by an early return must not swallow the next frame
+            current.stack.resize(1);
+            current.zones[0].start = Clock::now();
+
+            if (isTracingNow()) {
+                record(current, TraceType::Begin, current.zones[0].name, 0.0);
+            }
+        }
+
+        void endFrame() {
+            ThreadProfile &current = profile();
+            Zone &frame = current.zones[0];
+            frame.frameMs = std::chrono::duration<double, std::milli>(Clock::now() - frame.start).count();
+
+            if (isTracingNow()) {
+                record(current, TraceType::End, frame.name, 0.0);
+            }
+
+            std::lock_guard<std::mutex> lock(current.mutex);
+            size_t slot = current.frameCount % HISTORY_FRAMES;
+            for (Zone &zone: current.zones) {
+                zone.history[slot] = static_cast<float>(zone.frameMs);
+                zone.frameMs = 0.0;
+            }
+            current.frameCount++;
+        }
+
+        void beginZone(const char *name) {
+            ThreadProfile &current = profile();
+            int index = findOrAddChild(current, current.stack.back(), name);
+            current.stack.push_back(index);
+            current.zones[index].start = Clock::now();
+
+            if (isTracingNow()) {
+                record(current, TraceType::Begin, name, 0.0);
+            }
+        }
+
+        void endZone() {
+            ThreadProfile &current = profile();
+            if (current.stack.size() <= 1) return;
+
+            Zone &zone = current.zones[current.stack.back()];
+            zone.frameMs += std::chrono::duration<double, std::milli>(Clock::now() - zone.start).count();
+            current.stack.pop_back();
+
+            if (isTracingNow()) {
+                record(current, TraceType::End, zone.name, 0.0);
+            }
+        }
+
+        void counter(const char *name, double value) {
+            if (isTracingNow()) {
+                record(profile(), TraceType::Counter, name, value);
+            }
+        }
+
+        std::vector<ZoneStats> getStats() {
+            std::vector<ZoneStats> stats;
+
+            std::lock_guard<std::mutex> registryLock(s_registryMutex);
+            for (const auto &thread: s_threads) {
+                std::lock_guard<std::mutex> lock(thread->mutex);
+                if (thread->frameCount == 0) continue;
+                collect(*thread, 0, stats);
+            }
+            return stats;
+        }
+
+        bool writeCsv(const std::string &path) {
+            FILE *file = std::fopen(path.c_str(), "w");
+            if (!file) return false;
+
+            std::fprintf(file, "zone,depth,frames,min_ms,avg_ms,p99_ms,max_ms\n");
+
+            // Zones are named by their full path so repeated leaf names stay apart
+            std::vector<std::string> names;
+            for (const ZoneStats &zone: getStats()) {
+                names.resize(zone.depth);
+                names.push_back(zone.name);
+
+                std::string fullName;
+                for (const std::string &part: names) {
+                    if (!fullName.empty()) fullName += '/';
+                    fullName += part;
+                }
+
+                std::fprintf(file, "%s,%d,%d,%.4f,%.4f,%.4f,%.4f\n",
+                             fullName.c_str(), zone.depth, zone.frames,
+                             zone.minMs, zone.avgMs, zone.p99Ms, zone.maxMs);
+            }
+
+            return std::fclose(file) == 0;
+        }
+
+        void writeCsvOnExit(const std::string &path) {
+            bool registered = !s_csvPath.empty();
+            s_csvPath = path;
+            if (!registered) {
+                std::atexit(writeCsvAtExit);
+            }
+        }
+
+        void startTrace(const std::string &path) {
+            bool registered = !s_tracePath.empty();
+            s_tracePath = path;
+            if (!isTracingNow()) {
+                s_traceEpoch = Clock::now().time_since_epoch().count();
+                s_tracing = true;
+            }
+            if (!registered) {
+                std::atexit(saveTraceAtExit);
+            }
+        }
+
+        bool isTracing() {
+            return isTracingNow();
+        }
+
+        bool saveTrace() {
+            if (!isTracingNow()) return false;
+
+            FILE *file = std::fopen(s_tracePath.c_str(), "w");
+            if (!file) return false;
+
+            std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+            bool first = true;
+            auto separate = [&first, file]() {
+                std::fputs(first ? "\n" : ",\n", file);
+                first = false;
+            };
+
+            size_t eventCount = 0;
+            std::lock_guard<std::mutex> registryLock(s_registryMutex);
+            for (size_t t = 0; t < s_threads.size(); ++t) {
+                const ThreadProfile &thread = *s_threads[t];
+                int tid = static_cast<int>(t) + 1;
+
+                const char *threadName;
+                {
+                    std::lock_guard<std::mutex> lock(s_threads[t]->mutex);
+                    threadName = thread.zones[0].name;
+                }
+                separate();
+                std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                             "\"args\":{\"name\":", tid);
+                writeJsonString(file, threadName);
+                std::fputs("}}", file);
+
+                // The oldest events may have lost their begin to the ring, so ends are
+                // only written for zones that are open in the trace
+                int depth = 0;
+                for (const TraceEvent &event: readTrace(thread)) {
+                    if (event.type == TraceType::End) {
+                        if (depth == 0) continue;
+                        --depth;
+                    } else if (event.type == TraceType::Begin) {
+                        ++depth;
+                    }
+
+                    static const char *const PHASES[] = {"B", "E", "C"};
+                    separate();
+                    std::fputs("{\"name\":", file);
+                    writeJsonString(file, event.name);
+                    std::fprintf(file, ",\"ph\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f",
+                                 PHASES[static_cast<int>(event.type)], tid, event.time / 1000.0);
+                    if (event.type == TraceType::Counter) {
+                        std::fprintf(file, ",\"args\":{\"value\":%.17g}", event.value);
+                    }
+                    std::fputc('}', file);
+                    ++eventCount;
+                }
+            }
+
+            std::fprintf(file, "\n]}\n");
+            if (std::fclose(file) != 0) return false;
+
+            std::printf("Trace of %zu events written to %s\n", eventCount, s_tracePath.c_str());
+            return true;
+        }
+
+        void setOverlayVisible(bool visible) {
+            s_overlayVisible = visible;
+        }
+
+        bool isOverlayVisible() {
+            return s_overlayVisible;
+        }
+
+        void toggleOverlay() {
+            s_overlayVisible = !s_overlayVisible;
+        }
+    } // namespace Profiler
+} // namespace CowGL
@@ -0,0 +1,123 @@
+//==============================================================================
+// File: core/Profiler.h
+// Purpose: Scoped CPU timers with per-zone history over recent frames
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+
+#include <string>
+#include <vector>
+
+// Zones are opened with COWGL_PROFILE_SCOPE("Name") and nest by call structure,
+// COWGL_PROFILE_COUNTER("Name", value) samples a value for the trace. Without
+// COWGL_PROFILER the macros expand to nothing, so instrumented code is identical
+// to uninstrumented code.
+#ifdef COWGL_PROFILER
+#define COWGL_PROFILE_CONCAT_IMPL(a, b) a##b
+#define COWGL_PROFILE_CONCAT(a, b) COWGL_PROFILE_CONCAT_IMPL(a, b)
+#define COWGL_PROFILE_SCOPE(name) \
+    ::CowGL::ProfileScope COWGL_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define COWGL_PROFILE_FRAME() \
+    ::CowGL::ProfileFrame COWGL_PROFILE_CONCAT(profileFrame_, __LINE__)
+#define COWGL_PROFILE_COUNTER(name, value) \
+    ::CowGL::Profiler::counter(name, static_cast<double>(value))
+#else
+#define COWGL_PROFILE_SCOPE(name) ((void) 0)
+#define COWGL_PROFILE_FRAME() ((void) 0)
+#define COWGL_PROFILE_COUNTER(name, value) ((void) 0)
+#endif
+
+namespace CowGL {
+    namespace Profiler {
+        // Frames kept per zone for the statistics
+        constexpr int HISTORY_FRAMES = 240;
+
+        // Most recent trace events kept per thread
+        constexpr size_t TRACE_EVENTS_PER_THREAD = 1 << 16;
+
+        // Timings of one zone over the recorded history, in milliseconds. A zone
+        // entered several times in a frame counts the sum of its entries.
+        struct ZoneStats {
+            std::string name;
+            int depth = 0;
+            int frames = 0;
+            double lastMs = 0.0;
+            double minMs = 0.0;
+            double avgMs = 0.0;
+            double p99Ms = 0.0;
+            double maxMs = 0.0;
+        };
+
+        // Every thread keeps its own zones and frames. The root zone is named after
+        // the thread, "Frame" unless set here before the thread's first zone.
+        void setThreadName(const char *name);
+
+        // Frame boundaries; zones outside a frame are attached to the root
+        void beginFrame();
+
+        void endFrame();
+
+        // Zone names must outlive the profiler, string literals are expected.
+        // Zones are matched by pointer, so the same literal always means the same zone.
+        void beginZone(const char *name);
+
+        void endZone();
+
+        // Counter value at this moment; only recorded while a trace is running
+        void counter(const char *name, double value);
+
+        // Every zone seen so far, thread by thread in depth-first order, root first.
+        // Threads that never finished a frame are left out. Safe to call from any thread.
+        std::vector<ZoneStats> getStats();
+
+        // One row per zone; returns false when the file cannot be written
+        bool writeCsv(const std::string &path);
+
+        // Writes the CSV to path when the process exits, also through exit()
+        void writeCsvOnExit(const std::string &path);
+
+        // While a trace runs, frames, zones and counters are also logged as events,
+        // each thread into its own buffer of the most recent events. Saving writes
+        // them to path as Chrome trace JSON, for chrome://tracing or Perfetto; the
+        // trace is saved once more when the process exits.
+        void startTrace(const std::string &path);
+
+        bool isTracing();
+
+        // Safe to call from any thread while the others keep recording; returns
+        // false when no trace runs or the file cannot be written
+        bool saveTrace();
+
+        void setOverlayVisible(bool visible);
+
+        bool isOverlayVisible();
+
+        void toggleOverlay();
+    } // namespace Profiler
+
+    class ProfileScope {
+    public:
+        explicit ProfileScope(const char *name) { Profiler::beginZone(name); }
+        ~ProfileScope() { Profiler::endZone(); }
+
+        ProfileScope(const ProfileScope &) = delete;
+
+        ProfileScope &operator=(const ProfileScope &) = delete;
+    };
+
+    class ProfileFrame {
+    public:
+        ProfileFrame() { Profiler::beginFrame(); }
+        ~ProfileFrame() { Profiler::endFrame(); }
+
+        ProfileFrame(const ProfileFrame &) = delete;
+
+        ProfileFrame &operator=(const ProfileFrame &) = delete;
+    };
+} // namespace CowGL
+
+
+#endif //PROFILER_H
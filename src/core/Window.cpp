@@ -5,8 +5,14 @@
 //==============================================================================
 
 #include "core/Window.h"
-#include <GLUT/glut.h>
-#include <OpenGL/gl.h>
+#include "core/HeadlessContext.h"
+#include "utils/OpenGL.h"
+
+#ifdef __APPLE__
+#include <OpenGL/OpenGL.h>
+#else
+#include <GL/glx.h>
+#endif
 
 namespace CowGL {
     Window::DisplayCallback Window::s_displayCallback = nullptr;
@@ -17,8 +23,17 @@ namespace CowGL {
     Window::ReshapeCallback Window::s_reshapeCallback = nullptr;
 
 
-    Window::Window(const std::string &title, int width, int height)
-        : m_width(width), m_height(height) {
+    Window::Window(const std::string &title, int width, int height, Mode mode)
+        : m_width(width), m_height(height), m_windowHandle(0) {
+        if (mode == Mode::Headless) {
+            m_headlessContext = std::make_unique<HeadlessContext>(width, height);
+
+            glEnable(GL_DEPTH_TEST);
+            glDepthFunc(GL_LESS);
+            glClearColor(0.529f, 0.808f, 0.922f, 1.0f); // Sky blue
+            return;
+        }
+
         glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
         glutInitWindowSize(width, height);
         glutInitWindowPosition(100, 100);
@@ -41,6 +56,8 @@ namespace CowGL {
         glutReshapeFunc(reshapeCallbackWrapper);
     }
 
+    Window::~Window() = default;
+
     void Window::reshapeCallbackWrapper(int width, int height) {
         if (s_reshapeCallback) {
             s_reshapeCallback(width, height);
@@ -72,11 +89,48 @@ namespace CowGL {
     }
 
     void Window::swapBuffers() {
+        if (m_headlessContext) {
+            // Nothing to present; make sure the frame is actually submitted
+            glFlush();
+            return;
+        }
         glutSwapBuffers();
     }
 
     void Window::requestRedraw() {
-        glutPostRedisplay();
+        if (!m_headlessContext) {
+            glutPostRedisplay();
+        }
+    }
+
+    bool Window::setSwapInterval(int interval) {
+        if (m_headlessContext) return false;
+
+#ifdef __APPLE__
+        GLint value = interval;
+        return CGLSetParameter(CGLGetCurrentContext(), kCGLCPSwapInterval, &value) == kCGLNoError;
+#else
+        // freeglut runs on GLX here; drivers expose one of three swap control extensions
+        auto lookup = [](const char *name) {
+            return glXGetProcAddressARB(reinterpret_cast<const GLubyte *>(name));
+        };
+
+        if (auto swapIntervalEXT = reinterpret_cast<PFNGLXSWAPINTERVALEXTPROC>(lookup("glXSwapIntervalEXT"))) {
+            GLXDrawable drawable = glXGetCurrentDrawable();
+            if (drawable) {
+                swapIntervalEXT(glXGetCurrentDisplay(), drawable, interval);
+                return true;
+            }
+        }
+        if (auto swapIntervalMESA = reinterpret_cast<PFNGLXSWAPINTERVALMESAPROC>(lookup("glXSwapIntervalMESA"))) {
+            return swapIntervalMESA(static_cast<unsigned int>(interval)) == 0;
+        }
+        if (auto swapIntervalSGI = reinterpret_cast<PFNGLXSWAPINTERVALSGIPROC>(lookup("glXSwapIntervalSGI"))) {
+            // SGI swap control cannot turn synchronisation off
+            return interval > 0 && swapIntervalSGI(interval) == 0;
+        }
+        return false;
+#endif
     }
 
     void Window::displayCallbackWrapper() {
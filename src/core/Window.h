@@ -9,20 +9,30 @@
 
 
 #include <string>
+#include <memory>
 #include <functional>
+#include <atomic>
 
 namespace CowGL {
+    class HeadlessContext;
+
     class Window {
     public:
+        // Headless windows render offscreen and never receive input events
+        enum class Mode {
+            Windowed,
+            Headless
+        };
+
         using DisplayCallback = std::function<void()>;
         using KeyboardCallback = std::function<void(unsigned char, int, int)>;
         using MouseCallback = std::function<void(int, int, int, int)>;
         using MouseMoveCallback = std::function<void(int, int)>;
         using ReshapeCallback = std::function<void(int, int)>;
 
-        Window(const std::string &title, int width, int height);
+        Window(const std::string &title, int width, int height, Mode mode = Mode::Windowed);
 
-        ~Window() = default;
+        ~Window();
 
         void setDisplayCallback(DisplayCallback callback);
 
@@ -48,6 +58,14 @@ namespace CowGL {
 
         void requestRedraw();
 
+        // Buffer swaps to wait for per display refresh, 0 to present immediately.
+        // Returns false when the platform offers no swap control.
+        bool setSwapInterval(int interval);
+
+        bool isHeadless() const { return m_headlessContext != nullptr; }
+
+        HeadlessContext *getHeadlessContext() const { return m_headlessContext.get(); }
+
 
     private:
         static void displayCallbackWrapper();
@@ -70,9 +88,11 @@ namespace CowGL {
         static MouseMoveCallback s_mouseMoveCallback;
         static ReshapeCallback s_reshapeCallback;
 
-        int m_width;
-        int m_height;
+        // Set by the render thread on reshape, read by the simulation thread
+        std::atomic<int> m_width;
+        std::atomic<int> m_height;
         int m_windowHandle;
+        std::unique_ptr<HeadlessContext> m_headlessContext;
     };
 } // namespace CowGL
 
@@ -5,354 +5,545 @@
 //==============================================================================
 
 #include "entities/Cow.h"
-#include "core/Application.h"
+#include "core/FrameContext.h"
 #include "core/Input.h"
-#include <GLUT/glut.h>
-#include <OpenGL/gl.h>
+#include "utils/OpenGL.h"
 
 #include "graphics/Camera.h"
+#include "graphics/GeometryBuilder.h"
+#include "graphics/LevelOfDetail.h"
+#include "graphics/RenderQueue.h"
+#include "scene/RenderSnapshot.h"
+#include "scene/Scene.h"
+
+#include <memory>
+#include <vector>
 
 namespace CowGL {
     namespace {
-        // Colors
-        const GLfloat COW_BROWN[] = {0.42f, 0.18f, 0.12f, 1.0f};
-        const GLfloat DARK_GRAY[] = {0.3f, 0.3f, 0.3f, 1.0f};
-        const GLfloat PINK[] = {1.0f, 0.75f, 0.79f, 1.0f};
-        const GLfloat IVORY[] = {1.0f, 1.0f, 0.94f, 1.0f};
-        const GLfloat WHITE[] = {1.0f, 1.0f, 1.0f, 1.0f};
-        const GLfloat BLACK[] = {0.0f, 0.0f, 0.0f, 1.0f};
-
-        // Movement constants
-        const float MOVE_SPEED = 5.0f;
-        const float TURN_SPEED = 90.0f;
-        const float HEAD_TURN_SPEED = 60.0f;
-        const float TAIL_TURN_SPEED = 60.0f;
-
-        // Angle limits
-        const float HEAD_MAX_HORIZONTAL = 80.0f;
-        const float HEAD_MAX_VERTICAL = 60.0f;
-        const float TAIL_MAX_HORIZONTAL = 45.0f;
-        const float TAIL_MAX_VERTICAL = 45.0f;
+        // Materials; the whole cow shares the body's soft highlight
+        const glm::vec4 COW_SPECULAR(0.3f, 0.3f, 0.3f, 1.0f);
+        const float COW_SHININESS = 20.0f;
+
+        const Material COW_BROWN(glm::vec4(0.42f, 0.18f, 0.12f, 1.0f), COW_SPECULAR, COW_SHININESS);
+        const Material DARK_GRAY(glm::vec4(0.3f, 0.3f, 0.3f, 1.0f), COW_SPECULAR, COW_SHININESS);
+        const Material PINK(glm::vec4(1.0f, 0.75f, 0.79f, 1.0f), COW_SPECULAR, COW_SHININESS);
+        const Material IVORY(glm::vec4(1.0f, 1.0f, 0.94f, 1.0f), COW_SPECULAR, COW_SHININESS);
+        const Material WHITE(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), COW_SPECULAR, COW_SHININESS);
+        const Material BLACK(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), COW_SPECULAR, COW_SHININESS);
+        const Material WALNUT(glm::vec4(0.26f, 0.15f, 0.06f, 1.0f), COW_SPECULAR, COW_SHININESS);
+
+        // Joints of the head and tail on the body
+        const glm::vec3 HEAD_PIVOT(1.1f, 0.0f, 1.3f);
+        const glm::vec3 TAIL_PIVOT(-0.69f, 0.0f, 1.45f);
+
+        // Between the eyes, in the head's space
+        const glm::vec3 EYE_POINT(0.4f, 0.0f, 0.07f);
+
+        // Head yaw and pitch, tail yaw and pitch as Euler angles of the part
+        // transforms; the tail model hangs down its z axis, so it is tipped back by 90 degrees
+        glm::vec3 headRotation(const glm::vec4 &pose) {
+            return glm::vec3(0.0f, -pose.y, pose.x);
+        }
+
+        glm::vec3 tailRotation(const glm::vec4 &pose) {
+            return glm::vec3(0.0f, pose.w - 90.0f, -pose.z);
+        }
+
+        // Primitive tessellation per detail level, finest first
+        const int LOD_DETAIL[] = {20, 12, 6};
+        const int LOD_LEVEL_COUNT = sizeof(LOD_DETAIL) / sizeof(LOD_DETAIL[0]);
+
+        // Rigid parts baked into one mesh per material, per detail level, shared by all cows
+        enum Part {
+            BODY,
+            HEAD,
+            TAIL,
+            PART_COUNT
+        };
+
+        struct CowModel {
+            struct Piece {
+                MaterialId material;
+                std::unique_ptr<Mesh> mesh;
+            };
+
+            struct Level {
+                std::vector<Piece> parts[PART_COUNT];
+                size_t triangleCount = 0;
+            };
+
+            Level levels[LOD_LEVEL_COUNT];
+            bool built = false;
+        };
+
+        CowModel &getModel() {
+            static CowModel model;
+            return model;
+        }
     }
 
+    bool Cow::s_meshCacheEnabled = true;
+    LodSettings Cow::s_lodSettings = {{25.0f, 60.0f}};
+
     Cow::Cow(const std::string &name)
         : GameObject(name)
-          , m_moveSpeed(MOVE_SPEED)
-          , m_turnSpeed(TURN_SPEED)
-          , m_headHorizontalAngle(0.0f)
-          , m_headVerticalAngle(0.0f)
-          , m_tailHorizontalAngle(0.0f)
-          , m_tailVerticalAngle(-30.0f)
-          , m_animationTime(0.0f)
-          , m_eyePosition(0.0f, 0.0f, 0.0f)
-          , m_controlMode(ControlMode::Movement) {
-    }
-
-    void Cow::update(float deltaTime) {
-        // Calculate eye position with head rotation
-        glm::vec3 headOffset(1.1f, 0.0f, 1.3f);
-        float headYaw = glm::radians(m_headHorizontalAngle);
-        float headPitch = glm::radians(m_headVerticalAngle);
-
-        glm::vec3 rotatedOffset(
-            headOffset.x * std::cos(headYaw) - headOffset.y * std::sin(headYaw),
-            headOffset.x * std::sin(headYaw) + headOffset.y * std::cos(headYaw),
-            headOffset.z + headOffset.x * std::sin(headPitch)
-        );
-
-        m_eyePosition = m_transform.getPosition() + rotatedOffset;
-        m_animationTime += deltaTime;
-
-        // Handle input
-        Input *input = Application::getInstance()->getInput();
-
-        // Toggle control modes
-        if (input->isKeyJustPressed('t') || input->isKeyJustPressed('T')) {
-            m_controlMode = ControlMode::Tail;
-        } else if (input->isKeyJustPressed('h') || input->isKeyJustPressed('H')) {
-            m_controlMode = ControlMode::Head;
-        } else if (input->isKeyJustPressed('m') || input->isKeyJustPressed('M')) {
-            m_controlMode = ControlMode::Movement;
+          , m_store(nullptr)
+          , m_storeRow(0)
+          , m_renderPose(0.0f, 0.0f, 0.0f, -30.0f)
+          , m_headRevision(0)
+          , m_renderPartsPose(m_renderPose)
+          , m_lodLevel(0) {
+        // Covers the head and tail at their full articulation range
+        setLocalBounds(Bounds(glm::vec3(-1.6f, -1.0f, 0.0f), glm::vec3(1.9f, 1.0f, 2.2f)));
+
+        m_head.setPosition(HEAD_PIVOT);
+        m_head.setRotation(headRotation(getPose()));
+        m_head.setParent(&m_transform);
+
+        m_renderHead.setPosition(HEAD_PIVOT);
+        m_renderHead.setRotation(headRotation(m_renderPartsPose));
+        m_renderTail.setPosition(TAIL_PIVOT);
+        m_renderTail.setRotation(tailRotation(m_renderPartsPose));
+    }
+
+    void Cow::update(const FrameContext &context) {
+        CowState state = getState();
+        CowStore::step(state, m_transform, CowCommand::fromInput(context.input), context.deltaTime, getCollisionWorld());
+        setState(state);
+    }
+
+    void Cow::setScene(Scene *scene) {
+        if (scene == m_scene) return;
+
+        if (m_store) {
+            m_state = m_store->remove(m_storeRow);
+            m_store = nullptr;
         }
 
-        // Movement controls (always active)
-        if (input->isKeyPressed('w') || input->isKeyPressed('W')) moveForward(deltaTime);
-        if (input->isKeyPressed('s') || input->isKeyPressed('S')) moveBackward(deltaTime);
-        if (input->isKeyPressed('a') || input->isKeyPressed('A')) turnLeft(deltaTime);
-        if (input->isKeyPressed('d') || input->isKeyPressed('D')) turnRight(deltaTime);
-
-        // Context-sensitive controls (I,J,K,L)
-        switch (m_controlMode) {
-            case ControlMode::Head:
-                if (input->isKeyPressed('i') || input->isKeyPressed('I')) moveHeadUp(deltaTime);
-                if (input->isKeyPressed('k') || input->isKeyPressed('K')) moveHeadDown(deltaTime);
-                if (input->isKeyPressed('j') || input->isKeyPressed('J')) turnHeadLeft(deltaTime);
-                if (input->isKeyPressed('l') || input->isKeyPressed('L')) turnHeadRight(deltaTime);
-                break;
-
-            case ControlMode::Tail:
-                if (input->isKeyPressed('i') || input->isKeyPressed('I')) moveTailUp(deltaTime);
-                if (input->isKeyPressed('k') || input->isKeyPressed('K')) moveTailDown(deltaTime);
-                if (input->isKeyPressed('j') || input->isKeyPressed('J')) turnTailLeft(deltaTime);
-                if (input->isKeyPressed('l') || input->isKeyPressed('L')) turnTailRight(deltaTime);
-                break;
-
-            default:
-                break;
+        GameObject::setScene(scene);
+
+        if (scene) {
+            m_store = &scene->getCowStore();
+            m_storeRow = m_store->add(this, m_state);
         }
+    }
 
-        // Reset controls
-        if (input->isKeyPressed('r') || input->isKeyPressed('R')) {
-            resetHead();
-            resetTail();
+    void Cow::setActive(bool active) {
+        GameObject::setActive(active);
+        if (m_store) {
+            m_store->setActive(m_storeRow, active);
         }
+    }
 
-        // Reset with numpad 5
-        if (input->isKeyPressed('5')) {
-            resetHead();
-            resetTail();
+    void Cow::setState(const CowState &state) {
+        if (m_store) {
+            m_store->set(m_storeRow, state);
+        } else {
+            m_state = state;
         }
     }
 
+    const CollisionWorld *Cow::getCollisionWorld() const {
+        return m_scene ? &m_scene->getCollisionWorld() : nullptr;
+    }
+
+    void Cow::control(const CowCommand &command, float deltaTime) {
+        CowState state = getState();
+        CowStore::applyCommand(state, m_transform, command, deltaTime, getCollisionWorld());
+        setState(state);
+    }
+
     void Cow::moveForward(float deltaTime) {
-        glm::vec3 forward = m_transform.getForward();
-        m_transform.translate(forward * m_moveSpeed * deltaTime);
+        CowCommand command;
+        command.moveForward = true;
+        control(command, deltaTime);
     }
 
     void Cow::moveBackward(float deltaTime) {
-        glm::vec3 forward = m_transform.getForward();
-        m_transform.translate(forward * -m_moveSpeed * deltaTime);
+        CowCommand command;
+        command.moveBackward = true;
+        control(command, deltaTime);
     }
 
     void Cow::turnLeft(float deltaTime) {
-        m_transform.rotate(glm::vec3(0.0f, 0.0f, m_turnSpeed * deltaTime));
+        CowCommand command;
+        command.turnLeft = true;
+        control(command, deltaTime);
     }
 
     void Cow::turnRight(float deltaTime) {
-        m_transform.rotate(glm::vec3(0.0f, 0.0f, -m_turnSpeed * deltaTime));
+        CowCommand command;
+        command.turnRight = true;
+        control(command, deltaTime);
+    }
+
+    void Cow::controlPart(ControlMode part, const CowCommand &command, float deltaTime) {
+        CowState state = getState();
+        ControlMode mode = state.controlMode;
+        state.controlMode = part;
+
+        CowStore::applyCommand(state, m_transform, command, deltaTime, getCollisionWorld());
+
+        state.controlMode = mode;
+        setState(state);
     }
 
     void Cow::moveHeadUp(float deltaTime) {
-        m_headVerticalAngle = std::min(m_headVerticalAngle + HEAD_TURN_SPEED * deltaTime, HEAD_MAX_VERTICAL);
+        CowCommand command;
+        command.partUp = true;
+        controlPart(ControlMode::Head, command, deltaTime);
     }
 
     void Cow::moveHeadDown(float deltaTime) {
-        m_headVerticalAngle = std::max(m_headVerticalAngle - HEAD_TURN_SPEED * deltaTime, -HEAD_MAX_VERTICAL);
+        CowCommand command;
+        command.partDown = true;
+        controlPart(ControlMode::Head, command, deltaTime);
     }
 
     void Cow::turnHeadLeft(float deltaTime) {
-        m_headHorizontalAngle = std::min(m_headHorizontalAngle + HEAD_TURN_SPEED * deltaTime, HEAD_MAX_HORIZONTAL);
+        CowCommand command;
+        command.partLeft = true;
+        controlPart(ControlMode::Head, command, deltaTime);
     }
 
     void Cow::turnHeadRight(float deltaTime) {
-        m_headHorizontalAngle = std::max(m_headHorizontalAngle - HEAD_TURN_SPEED * deltaTime, -HEAD_MAX_HORIZONTAL);
+        CowCommand command;
+        command.partRight = true;
+        controlPart(ControlMode::Head, command, deltaTime);
     }
 
     void Cow::resetHead() {
-        m_headHorizontalAngle = 0.0f;
-        m_headVerticalAngle = 0.0f;
+        CowState state = getState();
+        state.headYaw = 0.0f;
+        state.headPitch = 0.0f;
+        ++state.poseRevision;
+        setState(state);
     }
 
     void Cow::moveTailUp(float deltaTime) {
-        m_tailVerticalAngle = std::min(m_tailVerticalAngle + TAIL_TURN_SPEED * deltaTime, TAIL_MAX_VERTICAL);
+        CowCommand command;
+        command.partUp = true;
+        controlPart(ControlMode::Tail, command, deltaTime);
     }
 
     void Cow::moveTailDown(float deltaTime) {
-        m_tailVerticalAngle = std::max(m_tailVerticalAngle - TAIL_TURN_SPEED * deltaTime, -TAIL_MAX_VERTICAL);
+        CowCommand command;
+        command.partDown = true;
+        controlPart(ControlMode::Tail, command, deltaTime);
     }
 
     void Cow::turnTailLeft(float deltaTime) {
-        m_tailHorizontalAngle = std::min(m_tailHorizontalAngle + TAIL_TURN_SPEED * deltaTime, TAIL_MAX_HORIZONTAL);
+        CowCommand command;
+        command.partLeft = true;
+        controlPart(ControlMode::Tail, command, deltaTime);
     }
 
     void Cow::turnTailRight(float deltaTime) {
-        m_tailHorizontalAngle = std::max(m_tailHorizontalAngle - TAIL_TURN_SPEED * deltaTime, -TAIL_MAX_HORIZONTAL);
+        CowCommand command;
+        command.partRight = true;
+        controlPart(ControlMode::Tail, command, deltaTime);
     }
 
     void Cow::resetTail() {
-        m_tailHorizontalAngle = 0.0f;
-        m_tailVerticalAngle = -30.0f;
+        CowState state = getState();
+        state.tailYaw = 0.0f;
+        state.tailPitch = -30.0f;
+        ++state.poseRevision;
+        setState(state);
+    }
+
+    const Transform &Cow::getHead() const {
+        CowState state = getState();
+        if (state.poseRevision != m_headRevision) {
+            m_head.setRotation(headRotation(glm::vec4(state.headYaw, state.headPitch, state.tailYaw, state.tailPitch)));
+            m_headRevision = state.poseRevision;
+        }
+        return m_head;
     }
 
     glm::vec3 Cow::getEyePosition() const {
-        return m_eyePosition;
+        return getHead().getWorldMatrix().transformPoint(EYE_POINT);
     }
 
-    glm::vec3 Cow::getLookDirection() const {
-        float yaw = glm::radians(m_transform.getRotation().z + m_headHorizontalAngle);
-        float pitch = glm::radians(m_headVerticalAngle);
+    Cow::ControlMode Cow::getControlMode() const {
+        return m_store ? m_store->getControlMode(m_storeRow) : m_state.controlMode;
+    }
 
-        return glm::vec3(
-            std::cos(yaw) * std::cos(pitch),
-            std::sin(yaw) * std::cos(pitch),
-            std::sin(pitch)
-        );
+    uint64_t Cow::getStateRevision() const {
+        uint64_t poseRevision = m_store ? m_store->getPoseRevision(m_storeRow) : m_state.poseRevision;
+        return GameObject::getStateRevision() + poseRevision;
     }
 
-    void Cow::onRender() {
+    glm::vec3 Cow::getLookDirection() const {
+        // The head faces along its x axis
+        const glm::mat4 &head = getHead().getWorldMatrix();
+        return glm::vec3(head.m[0], head.m[1], head.m[2]).normalized();
+    }
+
+    void Cow::onRender(const FrameContext &context) {
         // Don't render the cow in first-person view
-        auto scene = Application::getInstance()->getScene();
-        Camera* camera = scene->getActiveCamera();
-        if (camera && camera->getMode() == Camera::Mode::FirstPerson) {
+        const Camera *camera = context.camera;
+        if (camera && camera->getRenderMode() == Camera::Mode::FirstPerson) {
             // Skip rendering the cow when in first-person mode
             return;
         }
 
+        updateLodLevel(camera);
+
+        const CowModel &model = getModel();
+        const CowModel::Level &level = model.levels[m_lodLevel];
+        // The body's matrix is already applied, so the parts only need theirs
+        updateRenderParts();
+        const glm::mat4 partMatrices[PART_COUNT] = {glm::mat4(), m_renderHead.getMatrix(), m_renderTail.getMatrix()};
+
+        const LightingState &lighting = context.lighting;
+
         glEnable(GL_LIGHTING);
 
-        renderBody();
-        renderHead();
-        renderTail();
+        for (int part = 0; part < PART_COUNT; ++part) {
+            glPushMatrix();
+            glMultMatrixf(partMatrices[part].m);
+            if (s_meshCacheEnabled) {
+                for (const CowModel::Piece &piece: level.parts[part]) {
+                    Materials::get(piece.material).apply(lighting.globalAmbient, lighting.sunIntensity);
+                    piece.mesh->draw();
+                }
+            } else {
+                GeometryBuilder builder;
+                builder.drawImmediately(lighting.globalAmbient, lighting.sunIntensity);
+                buildPart(builder, part, LOD_DETAIL[m_lodLevel]);
+            }
+            glPopMatrix();
+        }
 
         glDisable(GL_LIGHTING);
 
+        LevelOfDetail::record(model.levels[0].triangleCount, level.triangleCount);
     }
 
-    void Cow::renderBody() {
-        GLUquadric *quadric = gluNewQuadric();
+    bool Cow::enqueue(RenderQueue &queue, const FrameContext &context) {
+        if (!s_meshCacheEnabled) return false;
+        if (!m_active) return true;
 
-        // Body
-        glPushMatrix();
-        glTranslatef(-0.7f, 0.0f, 1.0f);
-        glRotatef(90.0f, 0.0f, 1.0f, 0.0f);
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, COW_BROWN);
-
-        // Add specular highlight to make lighting more visible
-        GLfloat cowSpecular[] = {0.3f, 0.3f, 0.3f, 1.0f};
-        glMaterialfv(GL_FRONT, GL_SPECULAR, cowSpecular);
-        glMaterialf(GL_FRONT, GL_SHININESS, 20.0f);
-
-        gluCylinder(quadric, 0.5f, 0.5f, 1.4f, 20, 20);
-        glRotatef(180.0f, 1.0f, 0.0f, 0.0f);
-        gluDisk(quadric, 0.0f, 0.5f, 20, 20);
-        glTranslatef(0.0f, 0.0f, -1.4f);
-        glutSolidSphere(0.5f, 20, 20);
-        glPopMatrix();
+        const Camera *camera = context.camera;
+        if (camera && camera->getRenderMode() == Camera::Mode::FirstPerson) {
+            return true;
+        }
 
-        // Udder
-        glPushMatrix();
-        glTranslatef(-0.25f, 0.0f, 0.5f);
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, PINK);
-        glutSolidSphere(0.35f, 20, 20);
-        glPopMatrix();
+        updateLodLevel(camera);
 
-        // Legs
-        renderLeg(glm::vec3(-0.6f, 0.4f, 0.0f));
-        renderLeg(glm::vec3(-0.6f, -0.4f, 0.0f));
-        renderLeg(glm::vec3(0.6f, 0.4f, 0.0f));
-        renderLeg(glm::vec3(0.6f, -0.4f, 0.0f));
+        const CowModel &model = getModel();
+        const CowModel::Level &level = model.levels[m_lodLevel];
+        updateRenderParts();
+        const glm::mat4 partMatrices[PART_COUNT] = {
+            getRenderTransform().getWorldMatrix(), m_renderHead.getWorldMatrix(), m_renderTail.getWorldMatrix()
+        };
 
-        gluDeleteQuadric(quadric);
+        for (int part = 0; part < PART_COUNT; ++part) {
+            for (const CowModel::Piece &piece: level.parts[part]) {
+                queue.submit(RenderPass::Opaque, piece.material, *piece.mesh, partMatrices[part]);
+            }
+        }
+
+        LevelOfDetail::record(model.levels[0].triangleCount, level.triangleCount);
+        return true;
     }
 
-    void Cow::renderHead() {
-        GLUquadric *quadric = gluNewQuadric();
+    void Cow::updateLodLevel(const Camera *camera) {
+        buildModel();
 
-        glPushMatrix();
-        glTranslatef(1.1f, 0.0f, 1.3f);
-        glRotatef(m_headHorizontalAngle, 0.0f, 0.0f, 1.0f);
-        glRotatef(m_headVerticalAngle, 0.0f, -1.0f, 0.0f);
+        if (!camera) {
+            m_lodLevel = 0;
+            return;
+        }
+
+        Bounds bounds = getRenderBounds();
+        float distance = (bounds.center - camera->getRenderPosition()).length();
+        int level = LevelOfDetail::selectLevel(s_lodSettings, bounds.radius, distance, camera->getRenderFOV(), m_lodLevel);
+        m_lodLevel = std::min(level, LOD_LEVEL_COUNT - 1);
+    }
+
+    void Cow::captureState(ObjectState &state) const {
+        GameObject::captureState(state);
+        state.pose = getPose();
+    }
+
+    void Cow::applyState(const ObjectState &from, const ObjectState &to, float alpha) {
+        GameObject::applyState(from, to, alpha);
+        auto lerp = [alpha](float a, float b) { return a + (b - a) * alpha; };
+        m_renderPose = glm::vec4(lerp(from.pose.x, to.pose.x), lerp(from.pose.y, to.pose.y),
+                                 lerp(from.pose.z, to.pose.z), lerp(from.pose.w, to.pose.w));
+    }
+
+    glm::vec4 Cow::getPose() const {
+        CowState state = getState();
+        return glm::vec4(state.headYaw, state.headPitch, state.tailYaw, state.tailPitch);
+    }
+
+    void Cow::updateRenderParts() {
+        const Transform *body = &getRenderTransform();
+        if (m_renderHead.getParent() != body) {
+            m_renderHead.setParent(body);
+            m_renderTail.setParent(body);
+        }
 
+        glm::vec4 pose = getRenderPose();
+        if (pose.x != m_renderPartsPose.x || pose.y != m_renderPartsPose.y || pose.z != m_renderPartsPose.z ||
+            pose.w != m_renderPartsPose.w) {
+            m_renderHead.setRotation(headRotation(pose));
+            m_renderTail.setRotation(tailRotation(pose));
+            m_renderPartsPose = pose;
+        }
+    }
+
+    void Cow::buildModel() {
+        CowModel &model = getModel();
+        if (model.built) return;
+
+        for (int i = 0; i < LOD_LEVEL_COUNT; ++i) {
+            CowModel::Level &level = model.levels[i];
+
+            for (int part = 0; part < PART_COUNT; ++part) {
+                GeometryBuilder builder;
+                buildPart(builder, part, LOD_DETAIL[i]);
+
+                for (const auto &bucket: builder.getBuckets()) {
+                    if (bucket.indices.empty()) continue;
+
+                    CowModel::Piece piece;
+                    piece.material = Materials::intern(bucket.material);
+                    piece.mesh = std::make_unique<Mesh>(bucket.vertices, bucket.indices);
+                    level.triangleCount += piece.mesh->getTriangleCount();
+                    level.parts[part].push_back(std::move(piece));
+                }
+            }
+        }
+
+        model.built = true;
+    }
+
+    void Cow::buildPart(GeometryBuilder &builder, int part, int detail) {
+        switch (part) {
+            case BODY: buildBody(builder, detail); break;
+            case HEAD: buildHead(builder, detail); break;
+            default: buildTail(builder, detail); break;
+        }
+    }
+
+    void Cow::buildBody(GeometryBuilder &builder, int detail) {
+        // Body
+        builder.pushMatrix();
+        builder.translate(-0.7f, 0.0f, 1.0f);
+        builder.rotate(90.0f, 0.0f, 1.0f, 0.0f);
+        builder.setMaterial(COW_BROWN);
+        builder.addCylinder(0.5f, 1.4f, detail, detail);
+        builder.rotate(180.0f, 1.0f, 0.0f, 0.0f);
+        builder.addDisk(0.5f, detail, detail);
+        builder.translate(0.0f, 0.0f, -1.4f);
+        builder.addSphere(0.5f, detail, detail);
+        builder.popMatrix();
+
+        // Udder
+        builder.pushMatrix();
+        builder.translate(-0.25f, 0.0f, 0.5f);
+        builder.setMaterial(PINK);
+        builder.addSphere(0.35f, detail, detail);
+        builder.popMatrix();
+
+        // Legs
+        buildLeg(builder, glm::vec3(-0.6f, 0.4f, 0.0f), detail);
+        buildLeg(builder, glm::vec3(-0.6f, -0.4f, 0.0f), detail);
+        buildLeg(builder, glm::vec3(0.6f, 0.4f, 0.0f), detail);
+        buildLeg(builder, glm::vec3(0.6f, -0.4f, 0.0f), detail);
+    }
+
+    void Cow::buildHead(GeometryBuilder &builder, int detail) {
         // Head
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, COW_BROWN);
-        glutSolidSphere(0.4f, 20, 20);
+        builder.setMaterial(COW_BROWN);
+        builder.addSphere(0.4f, detail, detail);
 
         // Horns
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, IVORY);
-        glPushMatrix();
-        glRotatef(20.0f, 0.0f, 1.0f, 0.0f);
-        glPushMatrix();
-        glRotatef(20.0f, 1.0f, 0.0f, 0.0f);
-        glutSolidCone(0.15f, 0.6f, 20, 20);
-        glPopMatrix();
-        glPushMatrix();
-        glRotatef(20.0f, -1.0f, 0.0f, 0.0f);
-        glutSolidCone(0.15f, 0.6f, 20, 20);
-        glPopMatrix();
-        glPopMatrix();
+        builder.setMaterial(IVORY);
+        builder.pushMatrix();
+        builder.rotate(20.0f, 0.0f, 1.0f, 0.0f);
+        builder.pushMatrix();
+        builder.rotate(20.0f, 1.0f, 0.0f, 0.0f);
+        builder.addCone(0.15f, 0.6f, detail, detail);
+        builder.popMatrix();
+        builder.pushMatrix();
+        builder.rotate(20.0f, -1.0f, 0.0f, 0.0f);
+        builder.addCone(0.15f, 0.6f, detail, detail);
+        builder.popMatrix();
+        builder.popMatrix();
 
         // Ears
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, COW_BROWN);
-        glPushMatrix();
-        glTranslatef(0.0f, 0.34f, 0.2f);
-        glRotatef(90.0f, 0.0f, 1.0f, 0.0f);
-        gluDisk(quadric, 0.0f, 0.1f, 20, 20);
-        glPopMatrix();
-        glPushMatrix();
-        glTranslatef(0.0f, -0.34f, 0.2f);
-        glRotatef(90.0f, 0.0f, 1.0f, 0.0f);
-        gluDisk(quadric, 0.0f, 0.1f, 20, 20);
-        glPopMatrix();
+        builder.setMaterial(COW_BROWN);
+        builder.pushMatrix();
+        builder.translate(0.0f, 0.34f, 0.2f);
+        builder.rotate(90.0f, 0.0f, 1.0f, 0.0f);
+        builder.addDisk(0.1f, detail, detail);
+        builder.popMatrix();
+        builder.pushMatrix();
+        builder.translate(0.0f, -0.34f, 0.2f);
+        builder.rotate(90.0f, 0.0f, 1.0f, 0.0f);
+        builder.addDisk(0.1f, detail, detail);
+        builder.popMatrix();
 
         // Nose
-        glPushMatrix();
-        glTranslatef(0.25f, 0.0f, -0.2f);
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, PINK);
-        glutSolidSphere(0.25f, 20, 20);
-        glPopMatrix();
+        builder.pushMatrix();
+        builder.translate(0.25f, 0.0f, -0.2f);
+        builder.setMaterial(PINK);
+        builder.addSphere(0.25f, detail, detail);
+        builder.popMatrix();
 
         // Eyes
-        glPushMatrix();
-        glRotatef(80.0f, 0.0f, 1.0f, 0.0f);
-        glPushMatrix();
-        glRotatef(15.0f, 1.0f, 0.0f, 0.0f);
-        glTranslatef(0.0f, 0.0f, 0.40001f);
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, WHITE);
-        gluDisk(quadric, 0.0f, 0.04f, 20, 20);
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-        glTranslatef(0.0f, 0.0f, 0.001f);
-        gluDisk(quadric, 0.0f, 0.025f, 20, 20);
-        glPopMatrix();
-        glPushMatrix();
-        glRotatef(15.0f, -1.0f, 0.0f, 0.0f);
-        glTranslatef(0.0f, 0.0f, 0.40001f);
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, WHITE);
-        gluDisk(quadric, 0.0f, 0.04f, 20, 20);
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-        glTranslatef(0.0f, 0.0f, 0.001f);
-        gluDisk(quadric, 0.0f, 0.025f, 20, 20);
-        glPopMatrix();
-        glPopMatrix();
-
-        glPopMatrix();
-        gluDeleteQuadric(quadric);
-    }
-
-    void Cow::renderTail() {
-        GLUquadric *quadric = gluNewQuadric();
-
-        glPushMatrix();
-        glTranslatef(-0.69f, 0.0f, 1.45f);
-        glRotatef(m_tailHorizontalAngle, 0.0f, 0.0f, -1.0f);
-        glRotatef(m_tailVerticalAngle, 0.0f, 1.0f, 0.0f);
-        glRotatef(90.0f, 0.0f, -1.0f, 0.0f);
-
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, COW_BROWN);
-        glutSolidSphere(0.05f, 20, 20);
-        gluCylinder(quadric, 0.05f, 0.05f, 0.75f, 20, 20);
-
-        glTranslatef(0.0f, 0.0f, 0.75f);
-        GLfloat walnutColor[] = {0.26f, 0.15f, 0.06f, 1.0f};
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, walnutColor);
-        glutSolidSphere(0.075f, 20, 20);
-
-        glPopMatrix();
-        gluDeleteQuadric(quadric);
-    }
-
-    void Cow::renderLeg(const glm::vec3 &position) {
-        GLUquadric *quadric = gluNewQuadric();
-
-        glPushMatrix();
-        glTranslatef(position.x, position.y, position.z);
-
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, COW_BROWN);
-        gluCylinder(quadric, 0.1f, 0.1f, 1.0f, 20, 20);
-
-        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, DARK_GRAY);
-        gluCylinder(quadric, 0.10002f, 0.10002f, 0.15f, 20, 20);
-
-        glPopMatrix();
-        gluDeleteQuadric(quadric);
+        builder.pushMatrix();
+        builder.rotate(80.0f, 0.0f, 1.0f, 0.0f);
+        builder.pushMatrix();
+        builder.rotate(15.0f, 1.0f, 0.0f, 0.0f);
+        builder.translate(0.0f, 0.0f, 0.40001f);
+        builder.setMaterial(WHITE);
+        builder.addDisk(0.04f, detail, detail);
+        builder.setMaterial(BLACK);
+        builder.translate(0.0f, 0.0f, 0.001f);
+        builder.addDisk(0.025f, detail, detail);
+        builder.popMatrix();
+        builder.pushMatrix();
+        builder.rotate(15.0f, -1.0f, 0.0f, 0.0f);
+        builder.translate(0.0f, 0.0f, 0.40001f);
+        builder.setMaterial(WHITE);
+        builder.addDisk(0.04f, detail, detail);
+        builder.setMaterial(BLACK);
+        builder.translate(0.0f, 0.0f, 0.001f);
+        builder.addDisk(0.025f, detail, detail);
+        builder.popMatrix();
+        builder.popMatrix();
+    }
+
+    void Cow::buildTail(GeometryBuilder &builder, int detail) {
+        builder.pushMatrix();
+        builder.setMaterial(COW_BROWN);
+        builder.addSphere(0.05f, detail, detail);
+        builder.addCylinder(0.05f, 0.75f, detail, detail);
+
+        builder.translate(0.0f, 0.0f, 0.75f);
+        builder.setMaterial(WALNUT);
+        builder.addSphere(0.075f, detail, detail);
+
+        builder.popMatrix();
+    }
+
+    void Cow::buildLeg(GeometryBuilder &builder, const glm::vec3 &position, int detail) {
+        builder.pushMatrix();
+        builder.translate(position.x, position.y, position.z);
+
+        builder.setMaterial(COW_BROWN);
+        builder.addCylinder(0.1f, 1.0f, detail, detail);
+
+        builder.setMaterial(DARK_GRAY);
+        builder.addCylinder(0.10002f, 0.15f, detail, detail);
+
+        builder.popMatrix();
     }
 } // namespace CowGL
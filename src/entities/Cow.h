@@ -9,22 +9,36 @@
 
 
 #include "scene/GameObject.h"
+#include "entities/CowStore.h"
+#include "graphics/LevelOfDetail.h"
 #include "utils/Math.h"
 
 namespace CowGL {
+    class Camera;
+
+    // Inside a scene, a cow's simulation state lives in the scene's cow store
+    // and the scene's cow system updates it; the object reads and writes its row.
+    // Outside a scene the object keeps the state itself.
     class Cow : public GameObject {
     public:
-        enum class ControlMode {
-            Movement,
-            Head,
-            Tail
-        };
+        using ControlMode = CowControlMode;
 
         explicit Cow(const std::string &name = "Cow");
 
         ~Cow() override = default;
 
-        void update(float deltaTime) override;
+        // Ticks just this cow; cows in a scene are ticked in bulk instead
+        void update(const FrameContext &context) override;
+
+        bool needsUpdate() const override { return m_store == nullptr; }
+
+        // Moves the state into the new scene's cow store
+        void setScene(Scene *scene) override;
+
+        void setActive(bool active) override;
+
+        // Reads input and only writes the cow's own state
+        UpdateAccess getUpdateAccess() const override { return {Systems::INPUT, Systems::NONE}; }
 
         // Movement controls
         void moveForward(float deltaTime);
@@ -62,42 +76,100 @@ namespace CowGL {
 
         glm::vec3 getLookDirection() const;
 
-        const glm::vec3 &getEyePositionRef() const { return m_eyePosition; }
+        ControlMode getControlMode() const;
+
+        // Switch distances between the pre-tessellated detail levels, shared by all cows
+        static void setLodSettings(const LodSettings &settings) { s_lodSettings = settings; }
+        static const LodSettings &getLodSettings() { return s_lodSettings; }
 
-        ControlMode getControlMode() const { return m_controlMode; }
+        int getLodLevel() const { return m_lodLevel; }
+
+        // Rigid parts are baked once and shared by every cow. Disabling the cache
+        // falls back to drawing them primitive by primitive each frame, which
+        // also keeps cows out of the render queue.
+        static void setMeshCacheEnabled(bool enabled) { s_meshCacheEnabled = enabled; }
+        static bool isMeshCacheEnabled() { return s_meshCacheEnabled; }
+
+        // Submits one packet per part and material to the renderer's queue
+        bool enqueue(RenderQueue &queue, const FrameContext &context) override;
+
+        // Head and tail angles travel with the transform as the pose
+        void captureState(ObjectState &state) const override;
+
+        void applyState(const ObjectState &from, const ObjectState &to, float alpha) override;
+
+        uint64_t getStateRevision() const override;
 
     protected:
-        void onRender() override;
+        // Draws the parts directly, in model order
+        void onRender(const FrameContext &context) override;
 
     private:
-        void renderBody();
+        friend class CowStore;
+
+        CowState getState() const { return m_store ? m_store->get(m_storeRow) : m_state; }
+
+        void setState(const CowState &state);
+
+        // What the cow collides with; nothing outside a scene
+        const CollisionWorld *getCollisionWorld() const;
+
+        // Runs one command against the cow's state and transform
+        void control(const CowCommand &command, float deltaTime);
+
+        // Runs a head or tail command whatever the cow's control mode
+        void controlPart(ControlMode part, const CowCommand &command, float deltaTime);
+
+        // Picks the detail level for the camera's render view; full detail without a camera
+        void updateLodLevel(const Camera *camera);
+
+        // Head yaw and pitch, tail yaw and pitch, in degrees
+        glm::vec4 getPose() const;
+
+        // Pose to draw: the blended one once states are applied, the simulation's otherwise
+        glm::vec4 getRenderPose() const { return m_interpolated ? m_renderPose : getPose(); }
+
+        // Head in the simulation's pose, as a child of the body; places the eye
+        const Transform &getHead() const;
+
+        // Poses the drawn head and tail as children of the render transform
+        void updateRenderParts();
+
+        // Bakes every detail level into per-material meshes shared by all cows
+        static void buildModel();
+
+        // Geometry in part-local space; detail is the slice/stack count of every primitive
+        static void buildPart(GeometryBuilder &builder, int part, int detail);
+
+        static void buildBody(GeometryBuilder &builder, int detail);
 
-        void renderHead();
+        static void buildHead(GeometryBuilder &builder, int detail);
 
-        void renderTail();
+        static void buildTail(GeometryBuilder &builder, int detail);
 
-        void renderLeg(const glm::vec3 &position);
+        static void buildLeg(GeometryBuilder &builder, const glm::vec3 &position, int detail);
 
-        // Movement
-        float m_moveSpeed;
-        float m_turnSpeed;
+        static bool s_meshCacheEnabled;
+        static LodSettings s_lodSettings;
 
-        // Head state
-        float m_headHorizontalAngle;
-        float m_headVerticalAngle;
+        // Where the state lives: a row of the scene's store, or m_state when not in a scene
+        CowStore *m_store;
+        uint32_t m_storeRow;
+        CowState m_state;
 
-        // Tail state
-        float m_tailHorizontalAngle;
-        float m_tailVerticalAngle;
+        glm::vec4 m_renderPose;
 
-        // Animation
-        float m_animationTime;
+        // Head in the simulation's pose, as of pose revision m_headRevision
+        mutable Transform m_head;
+        mutable uint64_t m_headRevision;
 
-        // Camera support
-        glm::vec3 m_eyePosition;
+        // Head and tail as drawn, in the render pose m_renderPartsPose
+        Transform m_renderHead;
+        Transform m_renderTail;
+        glm::vec4 m_renderPartsPose;
 
-        // Control mode
-        ControlMode m_controlMode;
+        // Detail level drawn last frame
+        int m_lodLevel;
     };
 } // namespace CowGL
 
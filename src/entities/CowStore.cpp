@@ -0,0 +1,363 @@
+//==============================================================================
+// File: entities/CowStore.cpp
+// Purpose: Dense per-field storage and the bulk update system for cows
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "entities/CowStore.h"
+#include "entities/Cow.h"
+#include "core/FrameContext.h"
+#include "core/Input.h"
+#include "core/JobSystem.h"
+#include "core/Profiler.h"
+#include "scene/CollisionWorld.h"
+#include "scene/TransformStore.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace CowGL {
+    namespace {
+        // Movement constants
+        const float MOVE_SPEED = 5.0f;
+        const float TURN_SPEED = 90.0f;
+        const float HEAD_TURN_SPEED = 60.0f;
+        const float TAIL_TURN_SPEED = 60.0f;
+
+        // Angle limits
+        const float HEAD_MAX_HORIZONTAL = 80.0f;
+        const float HEAD_MAX_VERTICAL = 60.0f;
+        const float TAIL_MAX_HORIZONTAL = 45.0f;
+        const float TAIL_MAX_VERTICAL = 45.0f;
+
+        // Rows per job; a row is a few dozen instructions
+        const size_t UPDATE_GRAIN_SIZE = 2048;
+
+        // The sphere that collides for the body, from the feet: as wide as the
+        // body, while the head and rump may poke a little into what it touches
+        const glm::vec3 BODY_CENTER(0.0f, 0.0f, 1.1f);
+        const float BODY_RADIUS = 1.2f;
+
+        // How much room around a cow to measure after it collides; more lasts
+        // longer in the open but costs more to measure
+        const float CLEARANCE_LOOKAHEAD = 4.0f;
+
+        // How far a pinned cow can slide from where its contacts were gathered
+        // before they are gathered again
+        const float CONTACT_LOOKAHEAD = 1.0f;
+
+        // Contacts kept per cow; a cow among more searches the world every slide
+        const size_t MAX_CONTACTS = 4;
+        const uint8_t NO_CONTACTS = UINT8_MAX;
+
+        // Contacts of the cow being slid, kept per thread so slides allocate nothing
+        thread_local std::vector<uint32_t> t_contacts;
+    }
+
+    CowCommand CowCommand::fromInput(const Input *input) {
+        CowCommand command;
+        if (!input) return command;
+
+        // Toggle control modes
+        if (input->isActionJustPressed(Action::ControlTail)) {
+            command.switchMode = true;
+            command.mode = CowControlMode::Tail;
+        } else if (input->isActionJustPressed(Action::ControlHead)) {
+            command.switchMode = true;
+            command.mode = CowControlMode::Head;
+        } else if (input->isActionJustPressed(Action::ControlMovement)) {
+            command.switchMode = true;
+            command.mode = CowControlMode::Movement;
+        }
+
+        command.moveForward = input->isActionPressed(Action::MoveForward);
+        command.moveBackward = input->isActionPressed(Action::MoveBackward);
+        command.turnLeft = input->isActionPressed(Action::TurnLeft);
+        command.turnRight = input->isActionPressed(Action::TurnRight);
+
+        // Context-sensitive controls (I,J,K,L)
+        command.partUp = input->isActionPressed(Action::PartUp);
+        command.partDown = input->isActionPressed(Action::PartDown);
+        command.partLeft = input->isActionPressed(Action::PartLeft);
+        command.partRight = input->isActionPressed(Action::PartRight);
+
+        command.resetPose = input->isActionPressed(Action::ResetPose);
+        return command;
+    }
+
+    CowStore::CowStore(TransformStore &transforms)
+        : m_transformStore(transforms) {
+    }
+
+    uint32_t CowStore::add(Cow *owner, const CowState &state) {
+        uint32_t row = static_cast<uint32_t>(m_owners.size());
+
+        m_transformSlots.push_back(owner->getTransform().getSlot());
+        m_active.push_back(owner->isActive());
+
+        m_headYaw.push_back(state.headYaw);
+        m_headPitch.push_back(state.headPitch);
+        m_tailYaw.push_back(state.tailYaw);
+        m_tailPitch.push_back(state.tailPitch);
+        m_animationTime.push_back(state.animationTime);
+        m_controlMode.push_back(state.controlMode);
+        m_poseRevision.push_back(state.poseRevision);
+        m_clearance.push_back(-1.0f);
+        m_clearanceCenter.emplace_back();
+        m_contactIds.resize(m_contactIds.size() + MAX_CONTACTS);
+        m_contactCount.push_back(NO_CONTACTS);
+
+        m_owners.push_back(owner);
+        return row;
+    }
+
+    CowState CowStore::remove(uint32_t row) {
+        CowState state = get(row);
+
+        // Move the last row into the hole
+        size_t last = m_owners.size() - 1;
+        if (row != last) {
+            m_transformSlots[row] = m_transformSlots[last];
+            m_active[row] = m_active[last];
+            set(row, get(static_cast<uint32_t>(last)));
+            m_clearance[row] = m_clearance[last];
+            m_clearanceCenter[row] = m_clearanceCenter[last];
+            std::copy_n(&m_contactIds[last * MAX_CONTACTS], MAX_CONTACTS, &m_contactIds[row * MAX_CONTACTS]);
+            m_contactCount[row] = m_contactCount[last];
+
+            m_owners[row] = m_owners[last];
+            m_owners[row]->m_storeRow = row;
+        }
+
+        m_transformSlots.pop_back();
+        m_active.pop_back();
+        m_headYaw.pop_back();
+        m_headPitch.pop_back();
+        m_tailYaw.pop_back();
+        m_tailPitch.pop_back();
+        m_animationTime.pop_back();
+        m_controlMode.pop_back();
+        m_poseRevision.pop_back();
+        m_clearance.pop_back();
+        m_clearanceCenter.pop_back();
+        m_contactIds.resize(m_contactIds.size() - MAX_CONTACTS);
+        m_contactCount.pop_back();
+        m_owners.pop_back();
+        return state;
+    }
+
+    CowState CowStore::get(uint32_t row) const {
+        CowState state;
+        state.headYaw = m_headYaw[row];
+        state.headPitch = m_headPitch[row];
+        state.tailYaw = m_tailYaw[row];
+        state.tailPitch = m_tailPitch[row];
+        state.animationTime = m_animationTime[row];
+        state.controlMode = m_controlMode[row];
+        state.poseRevision = m_poseRevision[row];
+        return state;
+    }
+
+    void CowStore::set(uint32_t row, const CowState &state) {
+        m_headYaw[row] = state.headYaw;
+        m_headPitch[row] = state.headPitch;
+        m_tailYaw[row] = state.tailYaw;
+        m_tailPitch[row] = state.tailPitch;
+        m_animationTime[row] = state.animationTime;
+        m_controlMode[row] = state.controlMode;
+        m_poseRevision[row] = state.poseRevision;
+    }
+
+    void CowStore::update(const FrameContext &context, JobSystem *jobSystem, const CollisionWorld *world) {
+        COWGL_PROFILE_SCOPE("Cow system");
+        CowCommand command = CowCommand::fromInput(context.input);
+        float deltaTime = context.deltaTime;
+
+        // Solid objects came or went, so the room measured around each cow is stale
+        if (world && world->getRevision() != m_collisionRevision) {
+            std::fill(m_clearance.begin(), m_clearance.end(), -1.0f);
+            std::fill(m_contactCount.begin(), m_contactCount.end(), NO_CONTACTS);
+            m_collisionRevision = world->getRevision();
+        }
+
+        auto range = [this, &command, deltaTime, world](size_t begin, size_t end) {
+            updateRange(begin, end, command, deltaTime, world);
+        };
+
+        if (jobSystem) {
+            jobSystem->parallelFor(size(), UPDATE_GRAIN_SIZE, range);
+        } else {
+            range(0, size());
+        }
+    }
+
+    void CowStore::updateRange(size_t begin, size_t end, const CowCommand &command, float deltaTime,
+                               const CollisionWorld *world) {
+        bool posing = command.changesPose();
+        bool walking = command.moveForward != command.moveBackward;
+
+        // Room measured around a cow only holds while nothing solid moves
+        bool cacheClearance = world && !world->hasMovingObjects();
+        for (size_t i = begin; i < end; ++i) {
+            if (!m_active[i]) continue;
+
+            // Same as step, reading and writing only the columns the tick needs
+            m_animationTime[i] += deltaTime;
+
+            if (posing) {
+                uint32_t row = static_cast<uint32_t>(i);
+                CowState state = get(row);
+                applyPose(state, command, deltaTime);
+                set(row, state);
+            }
+
+            uint32_t slot = m_transformSlots[i];
+            if (walking) {
+                glm::vec3 displacement = walkDisplacement(m_transformStore.getRotation(slot), command, deltaTime);
+                if (!world) {
+                    m_transformStore.translate(slot, displacement);
+                } else if (!cacheClearance) {
+                    glm::vec3 center = m_transformStore.getPosition(slot) + BODY_CENTER;
+                    m_transformStore.translate(slot, world->slideSphere(center, BODY_RADIUS, displacement));
+                } else {
+                    // Both ends inside the measured room means nothing is in the way
+                    glm::vec3 center = m_transformStore.getPosition(slot) + BODY_CENTER;
+                    glm::vec3 fromRoom = center - m_clearanceCenter[i];
+                    glm::vec3 toRoom = fromRoom + displacement;
+                    float room = m_clearance[i];
+                    if (room >= 0.0f && glm::vec3::dot(fromRoom, fromRoom) <= room * room &&
+                        glm::vec3::dot(toRoom, toRoom) <= room * room) {
+                        m_transformStore.translate(slot, displacement);
+                    } else {
+                        // A pinned cow still near where its contacts were gathered slides
+                        // against just those instead of searching the world again
+                        float contactRoom = CONTACT_LOOKAHEAD - displacement.length();
+                        bool nearContacts = room < 0.0f && m_contactCount[i] != NO_CONTACTS &&
+                                            contactRoom >= 0.0f &&
+                                            glm::vec3::dot(fromRoom, fromRoom) <= contactRoom * contactRoom;
+
+                        glm::vec3 moved;
+                        if (nearContacts) {
+                            const uint32_t *contacts = &m_contactIds[i * MAX_CONTACTS];
+                            t_contacts.assign(contacts, contacts + m_contactCount[i]);
+                            moved = world->slideSphere(center, BODY_RADIUS, displacement, t_contacts);
+                        } else {
+                            moved = world->slideSphere(center, BODY_RADIUS, displacement);
+                        }
+                        m_transformStore.translate(slot, moved);
+
+                        if (moved == displacement) {
+                            m_clearanceCenter[i] = center + moved;
+                            m_clearance[i] = world->getClearance(m_clearanceCenter[i], BODY_RADIUS,
+                                                                 CLEARANCE_LOOKAHEAD);
+                            m_contactCount[i] = NO_CONTACTS;
+                        } else if (!nearContacts) {
+                            // A cow up against something has no room to measure, only contacts
+                            m_clearanceCenter[i] = center + moved;
+                            m_clearance[i] = -1.0f;
+                            t_contacts.clear();
+                            world->findSlideCandidates(m_clearanceCenter[i], BODY_RADIUS, CONTACT_LOOKAHEAD,
+                                                       t_contacts);
+                            if (t_contacts.size() <= MAX_CONTACTS) {
+                                std::copy(t_contacts.begin(), t_contacts.end(), &m_contactIds[i * MAX_CONTACTS]);
+                                m_contactCount[i] = static_cast<uint8_t>(t_contacts.size());
+                            } else {
+                                m_contactCount[i] = NO_CONTACTS;
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Same as turnBody
+            if (command.turnLeft) m_transformStore.rotate(slot, glm::vec3(0.0f, 0.0f, TURN_SPEED * deltaTime));
+            if (command.turnRight) m_transformStore.rotate(slot, glm::vec3(0.0f, 0.0f, -TURN_SPEED * deltaTime));
+        }
+    }
+
+    void CowStore::step(CowState &state, Transform &transform, const CowCommand &command, float deltaTime,
+                        const CollisionWorld *world) {
+        state.animationTime += deltaTime;
+
+        applyCommand(state, transform, command, deltaTime, world);
+    }
+
+    void CowStore::applyCommand(CowState &state, Transform &transform, const CowCommand &command,
+                                float deltaTime, const CollisionWorld *world) {
+        applyPose(state, command, deltaTime);
+        moveBody(transform, command, deltaTime, world);
+    }
+
+    glm::vec3 CowStore::walkDisplacement(const glm::vec3 &rotation, const CowCommand &command, float deltaTime) {
+        // Cows rarely pitch, and the trig of zero is exact
+        float cosPitch = 1.0f;
+        float sinPitch = 0.0f;
+        if (rotation.x != 0.0f) {
+            float pitch = glm::radians(rotation.x);
+            cosPitch = std::cos(pitch);
+            sinPitch = std::sin(pitch);
+        }
+
+        float yaw = glm::radians(rotation.z);
+        glm::vec3 forward(std::cos(yaw) * cosPitch, std::sin(yaw) * cosPitch, sinPitch);
+
+        return command.moveForward ? forward * MOVE_SPEED * deltaTime : forward * -MOVE_SPEED * deltaTime;
+    }
+
+    void CowStore::moveBody(Transform &transform, const CowCommand &command, float deltaTime,
+                            const CollisionWorld *world) {
+        // Movement controls (always active); forward and backward together cancel out
+        if (command.moveForward != command.moveBackward) {
+            glm::vec3 displacement = walkDisplacement(transform.getRotation(), command, deltaTime);
+            if (world) {
+                glm::vec3 center = transform.getPosition() + BODY_CENTER;
+                displacement = world->slideSphere(center, BODY_RADIUS, displacement);
+            }
+            transform.translate(displacement);
+        }
+        turnBody(transform, command, deltaTime);
+    }
+
+    void CowStore::turnBody(Transform &transform, const CowCommand &command, float deltaTime) {
+        if (command.turnLeft) transform.rotate(glm::vec3(0.0f, 0.0f, TURN_SPEED * deltaTime));
+        if (command.turnRight) transform.rotate(glm::vec3(0.0f, 0.0f, -TURN_SPEED * deltaTime));
+    }
+
+    void CowStore::applyPose(CowState &state, const CowCommand &command, float deltaTime) {
+        if (command.switchMode) {
+            state.controlMode = command.mode;
+        }
+
+        int parts = command.partUp + command.partDown + command.partLeft + command.partRight;
+        switch (state.controlMode) {
+            case CowControlMode::Head:
+                if (command.partUp) state.headPitch = std::min(state.headPitch + HEAD_TURN_SPEED * deltaTime, HEAD_MAX_VERTICAL);
+                if (command.partDown) state.headPitch = std::max(state.headPitch - HEAD_TURN_SPEED * deltaTime, -HEAD_MAX_VERTICAL);
+                if (command.partLeft) state.headYaw = std::min(state.headYaw + HEAD_TURN_SPEED * deltaTime, HEAD_MAX_HORIZONTAL);
+                if (command.partRight) state.headYaw = std::max(state.headYaw - HEAD_TURN_SPEED * deltaTime, -HEAD_MAX_HORIZONTAL);
+                state.poseRevision += parts;
+                break;
+
+            case CowControlMode::Tail:
+                if (command.partUp) state.tailPitch = std::min(state.tailPitch + TAIL_TURN_SPEED * deltaTime, TAIL_MAX_VERTICAL);
+                if (command.partDown) state.tailPitch = std::max(state.tailPitch - TAIL_TURN_SPEED * deltaTime, -TAIL_MAX_VERTICAL);
+                if (command.partLeft) state.tailYaw = std::min(state.tailYaw + TAIL_TURN_SPEED * deltaTime, TAIL_MAX_HORIZONTAL);
+                if (command.partRight) state.tailYaw = std::max(state.tailYaw - TAIL_TURN_SPEED * deltaTime, -TAIL_MAX_HORIZONTAL);
+                state.poseRevision += parts;
+                break;
+
+            default:
+                break;
+        }
+
+        // Reset controls (R or numpad 5)
+        if (command.resetPose) {
+            CowState rest;
+            state.headYaw = rest.headYaw;
+            state.headPitch = rest.headPitch;
+            state.tailYaw = rest.tailYaw;
+            state.tailPitch = rest.tailPitch;
+            state.poseRevision += 2;
+        }
+    }
+} // namespace CowGL
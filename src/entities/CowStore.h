@@ -0,0 +1,168 @@
+//==============================================================================
+// File: entities/CowStore.h
+// Purpose: Dense per-field storage and the bulk update system for cows
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef COWSTORE_H
+#define COWSTORE_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "utils/Math.h"
+
+namespace CowGL {
+    class Cow;
+    class Transform;
+    class TransformStore;
+    class Input;
+    class JobSystem;
+    class CollisionWorld;
+    struct FrameContext;
+
+    enum class CowControlMode : uint8_t {
+        Movement,
+        Head,
+        Tail
+    };
+
+    // What a cow simulates besides its transform
+    struct CowState {
+        // Head yaw and pitch, tail yaw and pitch, in degrees
+        float headYaw = 0.0f;
+        float headPitch = 0.0f;
+        float tailYaw = 0.0f;
+        float tailPitch = -30.0f;
+
+        float animationTime = 0.0f;
+        CowControlMode controlMode = CowControlMode::Movement;
+
+        // Bumped on every change to the head or tail
+        uint64_t poseRevision = 0;
+    };
+
+    // The controls of one tick. Every cow obeys the same keys, so the input is
+    // read once per tick rather than once per cow.
+    struct CowCommand {
+        bool switchMode = false;
+        CowControlMode mode = CowControlMode::Movement;
+
+        bool moveForward = false;
+        bool moveBackward = false;
+        bool turnLeft = false;
+        bool turnRight = false;
+
+        // Apply to the head or the tail, as the cow's control mode says
+        bool partUp = false;
+        bool partDown = false;
+        bool partLeft = false;
+        bool partRight = false;
+
+        bool resetPose = false;
+
+        // Whether the command can change anything but the body's transform
+        bool changesPose() const {
+            return switchMode || partUp || partDown || partLeft || partRight || resetPose;
+        }
+
+        static CowCommand fromInput(const Input *input);
+    };
+
+    // Cows of a scene, one array per field, so the system that updates them
+    // streams through just the fields a tick uses, plus the cows' slots in the
+    // scene's transform store. A Cow is a façade over its row; removing a row
+    // moves the last one into its place and tells that row's cow where it went.
+    class CowStore {
+    public:
+        // Cows' transforms are moved through the scene's transform store
+        explicit CowStore(TransformStore &transforms);
+
+        CowStore(const CowStore &) = delete;
+
+        CowStore &operator=(const CowStore &) = delete;
+
+        uint32_t add(Cow *owner, const CowState &state);
+
+        // Returns what the row held
+        CowState remove(uint32_t row);
+
+        CowState get(uint32_t row) const;
+
+        void set(uint32_t row, const CowState &state);
+
+        CowControlMode getControlMode(uint32_t row) const { return m_controlMode[row]; }
+
+        // Inactive cows are skipped by update
+        void setActive(uint32_t row, bool active) { m_active[row] = active; }
+
+        uint64_t getPoseRevision(uint32_t row) const { return m_poseRevision[row]; }
+
+        size_t size() const { return m_owners.size(); }
+
+        // One tick of every active cow, spread over the job system when one is
+        // given. Cows slide along the world's solid objects rather than walk
+        // through them; without a world they walk anywhere.
+        void update(const FrameContext &context, JobSystem *jobSystem, const CollisionWorld *world);
+
+        // Advances the animation by a tick, then applies the command to the
+        // state and the cow's body transform
+        static void step(CowState &state, Transform &transform, const CowCommand &command, float deltaTime,
+                         const CollisionWorld *world);
+
+        // Just the command part of step
+        static void applyCommand(CowState &state, Transform &transform, const CowCommand &command,
+                                 float deltaTime, const CollisionWorld *world);
+
+    private:
+        // How far the command walks a body with this rotation, before collision, when it walks one way
+        static glm::vec3 walkDisplacement(const glm::vec3 &rotation, const CowCommand &command, float deltaTime);
+
+        // Movement and turning
+        static void moveBody(Transform &transform, const CowCommand &command, float deltaTime,
+                             const CollisionWorld *world);
+
+        // Turning only; the collision sphere doesn't turn with the body
+        static void turnBody(Transform &transform, const CowCommand &command, float deltaTime);
+
+        // Control mode switches and head and tail controls
+        static void applyPose(CowState &state, const CowCommand &command, float deltaTime);
+
+        void updateRange(size_t begin, size_t end, const CowCommand &command, float deltaTime,
+                         const CollisionWorld *world);
+
+        TransformStore &m_transformStore;
+
+        // Each cow's slot in the transform store
+        std::vector<uint32_t> m_transformSlots;
+        std::vector<uint8_t> m_active;
+
+        std::vector<float> m_headYaw;
+        std::vector<float> m_headPitch;
+        std::vector<float> m_tailYaw;
+        std::vector<float> m_tailPitch;
+        std::vector<float> m_animationTime;
+        std::vector<CowControlMode> m_controlMode;
+        std::vector<uint64_t> m_poseRevision;
+
+        // Room around where each cow last collided, so a cow in the open walks
+        // without a sweep; negative until the next sweep measures it
+        std::vector<float> m_clearance;
+        std::vector<glm::vec3> m_clearanceCenter;
+
+        // The few static boxes around a cow pinned against something, gathered
+        // once at its clearance centre and slid against until it wanders off
+        std::vector<uint32_t> m_contactIds; // MAX_CONTACTS per row
+        std::vector<uint8_t> m_contactCount;
+
+        // Of the collision world the clearances and contacts were measured in
+        uint64_t m_collisionRevision = 0;
+
+        // Told their new row when rows move
+        std::vector<Cow *> m_owners;
+    };
+} // namespace CowGL
+
+
+#endif //COWSTORE_H
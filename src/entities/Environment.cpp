@@ -5,387 +5,372 @@
 //==============================================================================
 
 #include "entities/Environment.h"
-#include <GLUT/glut.h>
-#include <OpenGL/gl.h>
 
-#include "core/Application.h"
-#include "ui/UIManager.h"
+#include "core/FrameContext.h"
+#include "graphics/Camera.h"
+#include "graphics/GeometryBuilder.h"
+#include "graphics/StaticBatch.h"
+#include "graphics/InstanceRenderer.h"
 
 namespace CowGL {
     namespace Environment {
         namespace {
             // Colors
-            const GLfloat GRASS_GREEN[] = {0.18f, 0.55f, 0.18f, 1.0f};
-            const GLfloat CREAM[] = {1.0f, 0.99f, 0.89f, 1.0f};
-            const GLfloat CLAY[] = {0.71f, 0.13f, 0.13f, 1.0f};
-            const GLfloat BROWN[] = {0.55f, 0.27f, 0.07f, 1.0f};
-            const GLfloat LIGHT_BLUE[] = {0.62f, 0.82f, 0.88f, 1.0f};
-            const GLfloat MEDIUM_GRAY[] = {0.5f, 0.5f, 0.5f, 1.0f};
-            const GLfloat LIGHT_GRAY[] = {0.8f, 0.8f, 0.8f, 1.0f};
-            const GLfloat DARK_BROWN[] = {0.31f, 0.21f, 0.14f, 1.0f};
-            const GLfloat DARK_GREEN[] = {0.1f, 0.29f, 0.11f, 1.0f};
-            const GLfloat FOREST_GREEN[] = {0.13f, 0.55f, 0.13f, 1.0f};
-            const GLfloat WATER_BLUE[] = {0.11f, 0.58f, 0.88f, 1.0f};
-            const GLfloat BLACK[] = {0.0f, 0.0f, 0.0f, 1.0f};
-            const GLfloat WHITE[] = {1.0f, 1.0f, 1.0f, 1.0f};
-            const GLfloat METALLIC_GRAY[] = {0.7f, 0.7f, 0.75f, 1.0f};
+            const glm::vec4 GRASS_GREEN(0.18f, 0.55f, 0.18f, 1.0f);
+            const glm::vec4 CREAM(1.0f, 0.99f, 0.89f, 1.0f);
+            const glm::vec4 CLAY(0.71f, 0.13f, 0.13f, 1.0f);
+            const glm::vec4 BROWN(0.55f, 0.27f, 0.07f, 1.0f);
+            const glm::vec4 LIGHT_BLUE(0.62f, 0.82f, 0.88f, 1.0f);
+            const glm::vec4 MEDIUM_GRAY(0.5f, 0.5f, 0.5f, 1.0f);
+            const glm::vec4 LIGHT_GRAY(0.8f, 0.8f, 0.8f, 1.0f);
+            const glm::vec4 DARK_BROWN(0.31f, 0.21f, 0.14f, 1.0f);
+            const glm::vec4 DARK_GREEN(0.1f, 0.29f, 0.11f, 1.0f);
+            const glm::vec4 FOREST_GREEN(0.13f, 0.55f, 0.13f, 1.0f);
+            const glm::vec4 WATER_BLUE(0.11f, 0.58f, 0.88f, 1.0f);
+            const glm::vec4 WHITE(1.0f, 1.0f, 1.0f, 1.0f);
+            const glm::vec4 METALLIC_GRAY(0.7f, 0.7f, 0.75f, 1.0f);
+
+            // Tree tessellation per detail level, finest first
+            struct TreeDetail {
+                int trunkSlices, trunkStacks;
+                int leafSlices, leafStacks;
+            };
+
+            const TreeDetail TREE_DETAIL[] = {
+                {10, 10, 25, 25},
+                {8, 3, 12, 4},
+                {5, 1, 6, 1}
+            };
+            const int TREE_LEVEL_COUNT = sizeof(TREE_DETAIL) / sizeof(TREE_DETAIL[0]);
         }
 
-        // Ground
-        Ground::Ground() : GameObject("Ground") {
+        // StaticProp
+        StaticProp::StaticProp(const std::string &name) : GameObject(name) {
+            m_static = true;
         }
 
-        void Ground::onRender() {
-            glEnable(GL_LIGHTING);
-
-            // Get lighting values for ground color variation
-            auto app = Application::getInstance();
-            auto uiManager = app->getUIManager();
-            float globalAmbientValue = uiManager ? uiManager->getGlobalAmbient() : 0.3f;
-
-            // Vary grass color slightly based on ambient light
-            float grassIntensity = 0.7f + 0.3f * globalAmbientValue;
-            GLfloat dynamicGrassGreen[] = {
-                0.18f * grassIntensity,
-                0.55f * grassIntensity,
-                0.18f * grassIntensity,
-                1.0f
-            };
+        StaticProp::~StaticProp() = default;
 
-            glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, dynamicGrassGreen);
-            glMaterialfv(GL_FRONT, GL_EMISSION, BLACK);
+        void StaticProp::onRender(const FrameContext &context) {
+            if (!m_localBatch) {
+                GeometryBuilder builder;
+                buildStaticGeometry(builder);
+                m_localBatch = std::make_unique<StaticBatch>();
+                m_localBatch->build(builder);
+            }
 
-            // Add specular to make sun angle changes visible
-            GLfloat groundSpecular[] = {0.1f, 0.1f, 0.1f, 1.0f};
-            glMaterialfv(GL_FRONT, GL_SPECULAR, groundSpecular);
-            glMaterialf(GL_FRONT, GL_SHININESS, 5.0f);
+            m_localBatch->draw(context.lighting.globalAmbient, context.lighting.sunIntensity);
+        }
 
-            glBegin(GL_QUADS);
-            glNormal3f(0.0f, 0.0f, 1.0f);
-            glVertex3f(-100.0f, -100.0f, 0.0f);
-            glVertex3f(100.0f, -100.0f, 0.0f);
-            glVertex3f(100.0f, 100.0f, 0.0f);
-            glVertex3f(-100.0f, 100.0f, 0.0f);
-            glEnd();
+        // Ground
+        Ground::Ground() : StaticProp("Ground") {
+            setLocalBounds(Bounds(glm::vec3(-100.0f, -100.0f, 0.0f), glm::vec3(100.0f, 100.0f, 0.0f)));
+        }
 
-            glDisable(GL_LIGHTING);
+        void Ground::buildStaticGeometry(GeometryBuilder &builder) const {
+            // Grass colour varies slightly with ambient light, specular makes sun angle changes visible
+            Material grass(GRASS_GREEN, glm::vec4(0.1f, 0.1f, 0.1f, 1.0f), 5.0f);
+            grass.tintByAmbient = true;
+            builder.setMaterial(grass);
+
+            builder.addQuad(glm::vec3(0.0f, 0.0f, 1.0f),
+                            glm::vec3(-100.0f, -100.0f, 0.0f),
+                            glm::vec3(100.0f, -100.0f, 0.0f),
+                            glm::vec3(100.0f, 100.0f, 0.0f),
+                            glm::vec3(-100.0f, 100.0f, 0.0f));
         }
 
         // House
-        House::House() : GameObject("House") {
+        House::House() : StaticProp("House") {
+            setLocalBounds(Bounds(glm::vec3(-2.5f, -3.5f, 0.0f), glm::vec3(2.51f, 3.5f, 5.25f)));
+            setCollisionBounds(getLocalBounds());
         }
 
-        void House::onRender() {
-            glEnable(GL_LIGHTING);
-
+        void House::buildStaticGeometry(GeometryBuilder &builder) const {
             // Walls
-            glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, CREAM);
-            glMaterialfv(GL_FRONT, GL_EMISSION, BLACK);
-            glMaterialfv(GL_FRONT, GL_SPECULAR, BLACK);
+            builder.setMaterial(Material(CREAM));
 
             // Front wall
-            glBegin(GL_QUADS);
-            glNormal3f(0.0f, -1.0f, 0.0f);
-            glVertex3f(2.5f, -3.5f, 0.0f);
-            glVertex3f(-2.5f, -3.5f, 0.0f);
-            glVertex3f(-2.5f, -3.5f, 3.25f);
-            glVertex3f(2.5f, -3.5f, 3.25f);
-            glEnd();
+            builder.addQuad(glm::vec3(0.0f, -1.0f, 0.0f),
+                            glm::vec3(2.5f, -3.5f, 0.0f),
+                            glm::vec3(-2.5f, -3.5f, 0.0f),
+                            glm::vec3(-2.5f, -3.5f, 3.25f),
+                            glm::vec3(2.5f, -3.5f, 3.25f));
 
             // Back wall
-            glBegin(GL_QUADS);
-            glNormal3f(0.0f, 1.0f, 0.0f);
-            glVertex3f(-2.5f, 3.5f, 0.0f);
-            glVertex3f(2.5f, 3.5f, 0.0f);
-            glVertex3f(2.5f, 3.5f, 3.25f);
-            glVertex3f(-2.5f, 3.5f, 3.25f);
-            glEnd();
+            builder.addQuad(glm::vec3(0.0f, 1.0f, 0.0f),
+                            glm::vec3(-2.5f, 3.5f, 0.0f),
+                            glm::vec3(2.5f, 3.5f, 0.0f),
+                            glm::vec3(2.5f, 3.5f, 3.25f),
+                            glm::vec3(-2.5f, 3.5f, 3.25f));
 
             // Right wall
-            glBegin(GL_QUADS);
-            glNormal3f(1.0f, 0.0f, 0.0f);
-            glVertex3f(2.5f, -3.5f, 0.0f);
-            glVertex3f(2.5f, 3.5f, 0.0f);
-            glVertex3f(2.5f, 3.5f, 3.25f);
-            glVertex3f(2.5f, -3.5f, 3.25f);
-            glEnd();
+            builder.addQuad(glm::vec3(1.0f, 0.0f, 0.0f),
+                            glm::vec3(2.5f, -3.5f, 0.0f),
+                            glm::vec3(2.5f, 3.5f, 0.0f),
+                            glm::vec3(2.5f, 3.5f, 3.25f),
+                            glm::vec3(2.5f, -3.5f, 3.25f));
 
             // Left wall
-            glBegin(GL_QUADS);
-            glNormal3f(-1.0f, 0.0f, 0.0f);
-            glVertex3f(-2.5f, -3.5f, 0.0f);
-            glVertex3f(-2.5f, 3.5f, 0.0f);
-            glVertex3f(-2.5f, 3.5f, 3.25f);
-            glVertex3f(-2.5f, -3.5f, 3.25f);
-            glEnd();
+            builder.addQuad(glm::vec3(-1.0f, 0.0f, 0.0f),
+                            glm::vec3(-2.5f, -3.5f, 0.0f),
+                            glm::vec3(-2.5f, 3.5f, 0.0f),
+                            glm::vec3(-2.5f, 3.5f, 3.25f),
+                            glm::vec3(-2.5f, -3.5f, 3.25f));
 
             // Roof
-            glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, CLAY);
+            builder.setMaterial(Material(CLAY));
 
-            glBegin(GL_TRIANGLES);
             // Front
-            glNormal3f(0.0f, -1.0f, 0.0f);
-            glVertex3f(-2.5f, -3.5f, 3.25f);
-            glVertex3f(2.5f, -3.5f, 3.25f);
-            glVertex3f(0.0f, -3.5f, 5.25f);
+            builder.addTriangle(glm::vec3(0.0f, -1.0f, 0.0f),
+                                glm::vec3(-2.5f, -3.5f, 3.25f),
+                                glm::vec3(2.5f, -3.5f, 3.25f),
+                                glm::vec3(0.0f, -3.5f, 5.25f));
 
             // Back
-            glNormal3f(0.0f, 1.0f, 0.0f);
-            glVertex3f(2.5f, 3.5f, 3.25f);
-            glVertex3f(-2.5f, 3.5f, 3.25f);
-            glVertex3f(0.0f, 3.5f, 5.25f);
-            glEnd();
+            builder.addTriangle(glm::vec3(0.0f, 1.0f, 0.0f),
+                                glm::vec3(2.5f, 3.5f, 3.25f),
+                                glm::vec3(-2.5f, 3.5f, 3.25f),
+                                glm::vec3(0.0f, 3.5f, 5.25f));
 
             // Roof sides
-            glBegin(GL_QUADS);
-            // Left side
-            glNormal3f(-0.894f, 0.0f, 0.447f);
-            glVertex3f(-2.5f, -3.5f, 3.25f);
-            glVertex3f(-2.5f, 3.5f, 3.25f);
-            glVertex3f(0.0f, 3.5f, 5.25f);
-            glVertex3f(0.0f, -3.5f, 5.25f);
-
-            // Right side
-            glNormal3f(0.894f, 0.0f, 0.447f);
-            glVertex3f(2.5f, -3.5f, 3.25f);
-            glVertex3f(2.5f, 3.5f, 3.25f);
-            glVertex3f(0.0f, 3.5f, 5.25f);
-            glVertex3f(0.0f, -3.5f, 5.25f);
-            glEnd();
+            builder.addQuad(glm::vec3(-0.894f, 0.0f, 0.447f),
+                            glm::vec3(-2.5f, -3.5f, 3.25f),
+                            glm::vec3(-2.5f, 3.5f, 3.25f),
+                            glm::vec3(0.0f, 3.5f, 5.25f),
+                            glm::vec3(0.0f, -3.5f, 5.25f));
+
+            builder.addQuad(glm::vec3(0.894f, 0.0f, 0.447f),
+                            glm::vec3(2.5f, -3.5f, 3.25f),
+                            glm::vec3(2.5f, 3.5f, 3.25f),
+                            glm::vec3(0.0f, 3.5f, 5.25f),
+                            glm::vec3(0.0f, -3.5f, 5.25f));
 
             // Door
-            glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BROWN);
-            glMaterialfv(GL_FRONT, GL_SPECULAR, WHITE);
-            glMaterialf(GL_FRONT, GL_SHININESS, 10.0f);
-
-            glBegin(GL_QUADS);
-            glNormal3f(1.0f, 0.0f, 0.0f);
-            glVertex3f(2.51f, 0.75f, 0.0f);
-            glVertex3f(2.51f, -0.75f, 0.0f);
-            glVertex3f(2.51f, -0.75f, 2.25f);
-            glVertex3f(2.51f, 0.75f, 2.25f);
-            glEnd();
-
-            // Windows
-            glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, LIGHT_BLUE);
-            glMaterialfv(GL_FRONT, GL_SPECULAR, WHITE);
-            glMaterialf(GL_FRONT, GL_SHININESS, 5.0f);
+            builder.setMaterial(Material(BROWN, WHITE, 10.0f));
+
+            builder.addQuad(glm::vec3(1.0f, 0.0f, 0.0f),
+                            glm::vec3(2.51f, 0.75f, 0.0f),
+                            glm::vec3(2.51f, -0.75f, 0.0f),
+                            glm::vec3(2.51f, -0.75f, 2.25f),
+                            glm::vec3(2.51f, 0.75f, 2.25f));
 
             // Front windows
-            glBegin(GL_QUADS);
-            glNormal3f(1.0f, 0.0f, 0.0f);
-            glVertex3f(2.51f, 1.75f, 1.0f);
-            glVertex3f(2.51f, 2.5f, 1.0f);
-            glVertex3f(2.51f, 2.5f, 2.5f);
-            glVertex3f(2.51f, 1.75f, 2.5f);
-            glEnd();
-
-            glBegin(GL_QUADS);
-            glNormal3f(1.0f, 0.0f, 0.0f);
-            glVertex3f(2.51f, -1.75f, 1.0f);
-            glVertex3f(2.51f, -2.5f, 1.0f);
-            glVertex3f(2.51f, -2.5f, 2.5f);
-            glVertex3f(2.51f, -1.75f, 2.5f);
-            glEnd();
-
-            glDisable(GL_LIGHTING);
+            builder.setMaterial(Material(LIGHT_BLUE, WHITE, 5.0f));
+
+            builder.addQuad(glm::vec3(1.0f, 0.0f, 0.0f),
+                            glm::vec3(2.51f, 1.75f, 1.0f),
+                            glm::vec3(2.51f, 2.5f, 1.0f),
+                            glm::vec3(2.51f, 2.5f, 2.5f),
+                            glm::vec3(2.51f, 1.75f, 2.5f));
+
+            builder.addQuad(glm::vec3(1.0f, 0.0f, 0.0f),
+                            glm::vec3(2.51f, -1.75f, 1.0f),
+                            glm::vec3(2.51f, -2.5f, 1.0f),
+                            glm::vec3(2.51f, -2.5f, 2.5f),
+                            glm::vec3(2.51f, -1.75f, 2.5f));
         }
 
         // Shed
-        Shed::Shed() : GameObject("Shed") {
+        Shed::Shed() : StaticProp("Shed") {
+            setLocalBounds(Bounds(glm::vec3(-2.2f, -2.7f, 0.0f), glm::vec3(2.2f, 2.7f, 2.5f)));
+            setCollisionBounds(getLocalBounds());
         }
 
-        void Shed::onRender() {
-            glEnable(GL_LIGHTING);
-
-            // Get current sun intensity for dynamic metallic reflection
-            auto app = Application::getInstance();
-            auto uiManager = app->getUIManager();
-            float sunIntensity = uiManager ? uiManager->getSunIntensity() : 1.0f;
-
-            // Metallic walls with dynamic properties
-            glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, METALLIC_GRAY);
-            glMaterialfv(GL_FRONT, GL_EMISSION, BLACK);
-
-            // Strong specular reflection that varies with sun intensity
-            GLfloat dynamicSpecular[] = {
-                0.8f * sunIntensity,
-                0.8f * sunIntensity,
-                0.8f * sunIntensity,
-                1.0f
-            };
-            glMaterialfv(GL_FRONT, GL_SPECULAR, dynamicSpecular);
-            glMaterialf(GL_FRONT, GL_SHININESS, 90.0f); // Very shiny metal
+        void Shed::buildStaticGeometry(GeometryBuilder &builder) const {
+            // Metallic walls with a strong specular reflection that varies with sun intensity
+            Material metal(METALLIC_GRAY, glm::vec4(0.8f, 0.8f, 0.8f, 1.0f), 90.0f);
+            metal.specularBySun = true;
+            builder.setMaterial(metal);
 
             // Front wall
-            glBegin(GL_QUADS);
-            glNormal3f(0.0f, -1.0f, 0.0f);
-            glVertex3f(2.0f, -2.5f, 0.0f);
-            glVertex3f(-2.0f, -2.5f, 0.0f);
-            glVertex3f(-2.0f, -2.5f, 2.5f);
-            glVertex3f(2.0f, -2.5f, 2.5f);
-            glEnd();
+            builder.addQuad(glm::vec3(0.0f, -1.0f, 0.0f),
+                            glm::vec3(2.0f, -2.5f, 0.0f),
+                            glm::vec3(-2.0f, -2.5f, 0.0f),
+                            glm::vec3(-2.0f, -2.5f, 2.5f),
+                            glm::vec3(2.0f, -2.5f, 2.5f));
 
             // Back wall
-            glBegin(GL_QUADS);
-            glNormal3f(0.0f, 1.0f, 0.0f);
-            glVertex3f(-2.0f, 2.5f, 0.0f);
-            glVertex3f(2.0f, 2.5f, 0.0f);
-            glVertex3f(2.0f, 2.5f, 2.5f);
-            glVertex3f(-2.0f, 2.5f, 2.5f);
-            glEnd();
+            builder.addQuad(glm::vec3(0.0f, 1.0f, 0.0f),
+                            glm::vec3(-2.0f, 2.5f, 0.0f),
+                            glm::vec3(2.0f, 2.5f, 0.0f),
+                            glm::vec3(2.0f, 2.5f, 2.5f),
+                            glm::vec3(-2.0f, 2.5f, 2.5f));
 
             // Right wall
-            glBegin(GL_QUADS);
-            glNormal3f(1.0f, 0.0f, 0.0f);
-            glVertex3f(2.0f, -2.5f, 0.0f);
-            glVertex3f(2.0f, 2.5f, 0.0f);
-            glVertex3f(2.0f, 2.5f, 2.5f);
-            glVertex3f(2.0f, -2.5f, 2.5f);
-            glEnd();
+            builder.addQuad(glm::vec3(1.0f, 0.0f, 0.0f),
+                            glm::vec3(2.0f, -2.5f, 0.0f),
+                            glm::vec3(2.0f, 2.5f, 0.0f),
+                            glm::vec3(2.0f, 2.5f, 2.5f),
+                            glm::vec3(2.0f, -2.5f, 2.5f));
 
             // Left wall
-            glBegin(GL_QUADS);
-            glNormal3f(-1.0f, 0.0f, 0.0f);
-            glVertex3f(-2.0f, -2.5f, 0.0f);
-            glVertex3f(-2.0f, 2.5f, 0.0f);
-            glVertex3f(-2.0f, 2.5f, 2.5f);
-            glVertex3f(-2.0f, -2.5f, 2.5f);
-            glEnd();
-
-            // Flat metal roof
-            glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, MEDIUM_GRAY);
-            GLfloat roofSpecular[] = {1.0f, 1.0f, 1.0f, 1.0f};  // Maximum specular
-            glMaterialfv(GL_FRONT, GL_SPECULAR, roofSpecular);
-            glMaterialf(GL_FRONT, GL_SHININESS, 128.0f);  // Mirror-like
-
-            glBegin(GL_QUADS);
-            glNormal3f(0.0f, 0.0f, 1.0f);
-            glVertex3f(-2.2f, -2.7f, 2.5f);
-            glVertex3f(2.2f, -2.7f, 2.5f);
-            glVertex3f(2.2f, 2.7f, 2.5f);
-            glVertex3f(-2.2f, 2.7f, 2.5f);
-            glEnd();
+            builder.addQuad(glm::vec3(-1.0f, 0.0f, 0.0f),
+                            glm::vec3(-2.0f, -2.5f, 0.0f),
+                            glm::vec3(-2.0f, 2.5f, 0.0f),
+                            glm::vec3(-2.0f, 2.5f, 2.5f),
+                            glm::vec3(-2.0f, -2.5f, 2.5f));
+
+            // Flat metal roof, mirror-like
+            builder.setMaterial(Material(MEDIUM_GRAY, WHITE, 128.0f));
+
+            builder.addQuad(glm::vec3(0.0f, 0.0f, 1.0f),
+                            glm::vec3(-2.2f, -2.7f, 2.5f),
+                            glm::vec3(2.2f, -2.7f, 2.5f),
+                            glm::vec3(2.2f, 2.7f, 2.5f),
+                            glm::vec3(-2.2f, 2.7f, 2.5f));
 
             // Shed door (metallic sliding door)
-            glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, LIGHT_GRAY);
-            glMaterialfv(GL_FRONT, GL_SPECULAR, WHITE);
-            glMaterialf(GL_FRONT, GL_SHININESS, 60.0f);
-
-            glBegin(GL_QUADS);
-            glNormal3f(1.0f, 0.0f, 0.0f);
-            glVertex3f(2.01f, 1.0f, 0.0f);
-            glVertex3f(2.01f, -1.0f, 0.0f);
-            glVertex3f(2.01f, -1.0f, 2.0f);
-            glVertex3f(2.01f, 1.0f, 2.0f);
-            glEnd();
-
-            glDisable(GL_LIGHTING);
+            builder.setMaterial(Material(LIGHT_GRAY, WHITE, 60.0f));
+
+            builder.addQuad(glm::vec3(1.0f, 0.0f, 0.0f),
+                            glm::vec3(2.01f, 1.0f, 0.0f),
+                            glm::vec3(2.01f, -1.0f, 0.0f),
+                            glm::vec3(2.01f, -1.0f, 2.0f),
+                            glm::vec3(2.01f, 1.0f, 2.0f));
         }
 
         // Tree
+        bool Tree::s_instancingEnabled = true;
+
         Tree::Tree()
-            : GameObject("Tree") {
+            : StaticProp("Tree")
+              , m_tint(1.0f, 1.0f, 1.0f, 1.0f)
+              , m_lodLevel(0) {
+            setLocalBounds(Bounds(glm::vec3(-1.5f, -1.5f, 0.0f), glm::vec3(1.5f, 1.5f, 8.5f)));
+
+            // Just the trunk; cows can brush through the lowest leaves
+            setCollisionBounds(Bounds(glm::vec3(-0.5f, -0.5f, 0.0f), glm::vec3(0.5f, 0.5f, 8.0f)));
+        }
+
+        InstanceRenderer &Tree::getSharedRenderer() {
+            static InstanceRenderer renderer = [] {
+                GeometryBuilder builder;
+                buildModel(builder);
+                InstanceRenderer model(builder);
+
+                for (int level = 1; level < TREE_LEVEL_COUNT; ++level) {
+                    GeometryBuilder coarse;
+                    buildModel(coarse, level);
+                    model.addLevel(coarse);
+                }
+
+                model.setLodSettings({{40.0f, 90.0f}});
+                return model;
+            }();
+            return renderer;
+        }
+
+        void Tree::setLodSettings(const LodSettings &settings) {
+            getSharedRenderer().setLodSettings(settings);
+        }
+
+        const LodSettings &Tree::getLodSettings() {
+            return getSharedRenderer().getLodSettings();
+        }
+
+        InstanceRenderer *Tree::getInstanceRenderer() const {
+            return s_instancingEnabled ? &getSharedRenderer() : nullptr;
+        }
+
+        void Tree::onRender(const FrameContext &context) {
+            InstanceRenderer &model = getSharedRenderer();
+            const Camera *camera = context.camera;
+            if (camera) {
+                Bounds bounds = getWorldBounds();
+                float distance = (bounds.center - camera->getRenderPosition()).length();
+                int level = LevelOfDetail::selectLevel(model.getLodSettings(), bounds.radius, distance,
+                                                       camera->getRenderFOV(), m_lodLevel);
+                m_lodLevel = std::min(level, model.getLevelCount() - 1);
+            }
+
+            model.drawModel(context.lighting.globalAmbient, context.lighting.sunIntensity, m_lodLevel);
+            LevelOfDetail::record(model.getTriangleCount(0), model.getTriangleCount(m_lodLevel));
         }
 
-        void Tree::onRender() {
-            glEnable(GL_LIGHTING);
+        void Tree::buildStaticGeometry(GeometryBuilder &builder) const {
+            buildModel(builder);
+        }
 
-            GLUquadric *quadric = gluNewQuadric();
+        void Tree::buildModel(GeometryBuilder &builder, int level) {
+            const TreeDetail &detail = TREE_DETAIL[level];
 
             // Trunk
-            glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, DARK_BROWN);
-            glMaterialfv(GL_FRONT, GL_EMISSION, BLACK);
-            glMaterialfv(GL_FRONT, GL_SPECULAR, BLACK);
+            builder.setMaterial(Material(DARK_BROWN));
 
-            glutSolidCone(0.5f, 8.0f, 10, 10);
+            builder.addCone(0.5f, 8.0f, detail.trunkSlices, detail.trunkStacks);
 
             // Leaves (3 layers)
-            glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, DARK_GREEN);
-
-            glTranslatef(0.0f, 0.0f, 2.0f);
-            glRotatef(180.0f, 1.0f, 0.0f, 0.0f);
-            gluDisk(quadric, 0.0f, 1.5f, 25, 25);
-            glRotatef(-180.0f, 1.0f, 0.0f, 0.0f);
-            glutSolidCone(1.5f, 2.5f, 25, 25);
-
-            glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, FOREST_GREEN);
-
-            glTranslatef(0.0f, 0.0f, 2.0f);
-            glRotatef(180.0f, 1.0f, 0.0f, 0.0f);
-            gluDisk(quadric, 0.0f, 1.25f, 25, 25);
-            glRotatef(-180.0f, 1.0f, 0.0f, 0.0f);
-            glutSolidCone(1.25f, 2.5f, 25, 25);
-
-            glTranslatef(0.0f, 0.0f, 2.0f);
-            glRotatef(180.0f, 1.0f, 0.0f, 0.0f);
-            gluDisk(quadric, 0.0f, 1.0f, 25, 25);
-            glRotatef(-180.0f, 1.0f, 0.0f, 0.0f);
-            glutSolidCone(1.0f, 2.5f, 25, 25);
-
-            gluDeleteQuadric(quadric);
-            glDisable(GL_LIGHTING);
+            builder.setMaterial(Material(DARK_GREEN));
+
+            builder.translate(0.0f, 0.0f, 2.0f);
+            builder.rotate(180.0f, 1.0f, 0.0f, 0.0f);
+            builder.addDisk(1.5f, detail.leafSlices, detail.leafStacks);
+            builder.rotate(-180.0f, 1.0f, 0.0f, 0.0f);
+            builder.addCone(1.5f, 2.5f, detail.leafSlices, detail.leafStacks);
+
+            builder.setMaterial(Material(FOREST_GREEN));
+
+            builder.translate(0.0f, 0.0f, 2.0f);
+            builder.rotate(180.0f, 1.0f, 0.0f, 0.0f);
+            builder.addDisk(1.25f, detail.leafSlices, detail.leafStacks);
+            builder.rotate(-180.0f, 1.0f, 0.0f, 0.0f);
+            builder.addCone(1.25f, 2.5f, detail.leafSlices, detail.leafStacks);
+
+            builder.translate(0.0f, 0.0f, 2.0f);
+            builder.rotate(180.0f, 1.0f, 0.0f, 0.0f);
+            builder.addDisk(1.0f, detail.leafSlices, detail.leafStacks);
+            builder.rotate(-180.0f, 1.0f, 0.0f, 0.0f);
+            builder.addCone(1.0f, 2.5f, detail.leafSlices, detail.leafStacks);
         }
 
         // WaterTank
         WaterTank::WaterTank()
-            : GameObject("WaterTank") {
+            : StaticProp("WaterTank") {
+            setLocalBounds(Bounds(glm::vec3(-0.5f, -1.5f, 0.0f), glm::vec3(0.5f, 1.5f, 0.5f)));
+            setCollisionBounds(getLocalBounds());
         }
 
-        void WaterTank::onRender() {
-            glEnable(GL_LIGHTING);
-
+        void WaterTank::buildStaticGeometry(GeometryBuilder &builder) const {
             // Tank walls
-            glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, MEDIUM_GRAY);
-            glMaterialfv(GL_FRONT, GL_EMISSION, BLACK);
-            glMaterialfv(GL_FRONT, GL_SPECULAR, WHITE);
-            glMaterialf(GL_FRONT, GL_SHININESS, 15.0f);
+            builder.setMaterial(Material(MEDIUM_GRAY, WHITE, 15.0f));
 
-            // Simple box for water tank
-            glBegin(GL_QUADS);
             // Front
-            glNormal3f(0.0f, -1.0f, 0.0f);
-            glVertex3f(0.5f, -1.5f, 0.0f);
-            glVertex3f(-0.5f, -1.5f, 0.0f);
-            glVertex3f(-0.5f, -1.5f, 0.5f);
-            glVertex3f(0.5f, -1.5f, 0.5f);
+            builder.addQuad(glm::vec3(0.0f, -1.0f, 0.0f),
+                            glm::vec3(0.5f, -1.5f, 0.0f),
+                            glm::vec3(-0.5f, -1.5f, 0.0f),
+                            glm::vec3(-0.5f, -1.5f, 0.5f),
+                            glm::vec3(0.5f, -1.5f, 0.5f));
 
             // Back
-            glNormal3f(0.0f, 1.0f, 0.0f);
-            glVertex3f(-0.5f, 1.5f, 0.0f);
-            glVertex3f(0.5f, 1.5f, 0.0f);
-            glVertex3f(0.5f, 1.5f, 0.5f);
-            glVertex3f(-0.5f, 1.5f, 0.5f);
+            builder.addQuad(glm::vec3(0.0f, 1.0f, 0.0f),
+                            glm::vec3(-0.5f, 1.5f, 0.0f),
+                            glm::vec3(0.5f, 1.5f, 0.0f),
+                            glm::vec3(0.5f, 1.5f, 0.5f),
+                            glm::vec3(-0.5f, 1.5f, 0.5f));
 
             // Left
-            glNormal3f(-1.0f, 0.0f, 0.0f);
-            glVertex3f(-0.5f, -1.5f, 0.0f);
-            glVertex3f(-0.5f, 1.5f, 0.0f);
-            glVertex3f(-0.5f, 1.5f, 0.5f);
-            glVertex3f(-0.5f, -1.5f, 0.5f);
+            builder.addQuad(glm::vec3(-1.0f, 0.0f, 0.0f),
+                            glm::vec3(-0.5f, -1.5f, 0.0f),
+                            glm::vec3(-0.5f, 1.5f, 0.0f),
+                            glm::vec3(-0.5f, 1.5f, 0.5f),
+                            glm::vec3(-0.5f, -1.5f, 0.5f));
 
             // Right
-            glNormal3f(1.0f, 0.0f, 0.0f);
-            glVertex3f(0.5f, -1.5f, 0.0f);
-            glVertex3f(0.5f, 1.5f, 0.0f);
-            glVertex3f(0.5f, 1.5f, 0.5f);
-            glVertex3f(0.5f, -1.5f, 0.5f);
-            glEnd();
+            builder.addQuad(glm::vec3(1.0f, 0.0f, 0.0f),
+                            glm::vec3(0.5f, -1.5f, 0.0f),
+                            glm::vec3(0.5f, 1.5f, 0.0f),
+                            glm::vec3(0.5f, 1.5f, 0.5f),
+                            glm::vec3(0.5f, -1.5f, 0.5f));
 
             // Water
-            glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, WATER_BLUE);
-            glMaterialfv(GL_FRONT, GL_SPECULAR, WHITE);
-            glMaterialf(GL_FRONT, GL_SHININESS, 20.0f);
-
-            glBegin(GL_QUADS);
-            glNormal3f(0.0f, 0.0f, 1.0f);
-            glVertex3f(-0.5f, -1.5f, 0.35f);
-            glVertex3f(0.5f, -1.5f, 0.35f);
-            glVertex3f(0.5f, 1.5f, 0.35f);
-            glVertex3f(-0.5f, 1.5f, 0.35f);
-            glEnd();
-
-            glDisable(GL_LIGHTING);
+            builder.setMaterial(Material(WATER_BLUE, WHITE, 20.0f));
+
+            builder.addQuad(glm::vec3(0.0f, 0.0f, 1.0f),
+                            glm::vec3(-0.5f, -1.5f, 0.35f),
+                            glm::vec3(0.5f, -1.5f, 0.35f),
+                            glm::vec3(0.5f, 1.5f, 0.35f),
+                            glm::vec3(-0.5f, 1.5f, 0.35f));
         }
     } // namespace Environment
 } // namespace CowGL
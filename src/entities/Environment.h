@@ -8,48 +8,104 @@
 #define ENVIRONMENT_H
 
 
+#include <memory>
 #include "scene/GameObject.h"
+#include "graphics/LevelOfDetail.h"
 
 namespace CowGL {
+    class StaticBatch;
+
     namespace Environment {
-        class Ground : public GameObject {
+        // Base for scenery that never moves. Geometry is described once through
+        // buildStaticGeometry; the renderer normally bakes it into the scene-wide
+        // static batch, and onRender draws a private copy when it is not baked.
+        class StaticProp : public GameObject {
         public:
-            Ground();
+            explicit StaticProp(const std::string &name);
+
+            ~StaticProp() override;
+
+            bool hasStaticGeometry() const override { return true; }
+
+            UpdateAccess getUpdateAccess() const override { return {Systems::NONE, Systems::NONE}; }
+
+            bool needsUpdate() const override { return false; }
 
         protected:
-            void onRender() override;
+            void onRender(const FrameContext &context) override;
+
+        private:
+            std::unique_ptr<StaticBatch> m_localBatch;
         };
 
-        class House : public GameObject {
+        class Ground : public StaticProp {
+        public:
+            Ground();
+
+            void buildStaticGeometry(GeometryBuilder &builder) const override;
+        };
+
+        class House : public StaticProp {
         public:
             House();
 
-        protected:
-            void onRender() override;
+            void buildStaticGeometry(GeometryBuilder &builder) const override;
         };
 
-        class Shed : public GameObject {
+        class Shed : public StaticProp {
         public:
             Shed();
 
-        protected:
-            void onRender() override;
+            void buildStaticGeometry(GeometryBuilder &builder) const override;
         };
 
-        class Tree : public GameObject {
+        // Trees are too numerous to bake, so they share one model and are drawn
+        // through an instance renderer with per-tree culling
+        class Tree : public StaticProp {
         public:
             Tree();
 
+            bool hasStaticGeometry() const override { return false; }
+
+            void buildStaticGeometry(GeometryBuilder &builder) const override;
+
+            InstanceRenderer *getInstanceRenderer() const override;
+
+            glm::vec4 getInstanceTint() const override { return m_tint; }
+
+            void setTint(const glm::vec4 &tint) { m_tint = tint; }
+
+            // Disabling instancing makes every tree draw itself individually;
+            // it only affects scenes the renderer has not baked yet
+            static void setInstancingEnabled(bool enabled) { s_instancingEnabled = enabled; }
+            static bool isInstancingEnabled() { return s_instancingEnabled; }
+
+            // Switch distances between the tree's detail levels, shared by all trees
+            static void setLodSettings(const LodSettings &settings);
+            static const LodSettings &getLodSettings();
+
         protected:
-            void onRender() override;
+            void onRender(const FrameContext &context) override;
+
+        private:
+            // Level 0 is the full model, higher levels use fewer slices and stacks
+            static void buildModel(GeometryBuilder &builder, int level = 0);
+
+            static InstanceRenderer &getSharedRenderer();
+
+            static bool s_instancingEnabled;
+
+            glm::vec4 m_tint;
+
+            // Detail level drawn last frame when not instanced
+            int m_lodLevel;
         };
 
-        class WaterTank : public GameObject {
+        class WaterTank : public StaticProp {
         public:
             WaterTank();
 
-        protected:
-            void onRender() override;
+            void buildStaticGeometry(GeometryBuilder &builder) const override;
         };
     } // namespace Environment
 } // namespace CowGL
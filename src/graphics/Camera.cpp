@@ -5,29 +5,46 @@
 //==============================================================================
 
 #include "graphics/Camera.h"
-#include "core/Application.h"
-#include "scene/Scene.h"
+#include "scene/RenderSnapshot.h"
 #include "entities/Cow.h"
+#include "scene/CollisionWorld.h"
 #include <algorithm>
 
 namespace CowGL {
+    namespace {
+        // Room kept between the third person camera and what it backs into,
+        // wider than the near plane so walls don't get clipped
+        const float ORBIT_CLEARANCE = 0.3f;
+    }
+
     Camera::Camera()
         : m_position(0.0f, -10.0f, 5.0f)
           , m_target(0.0f, 0.0f, 0.0f)
           , m_up(0.0f, 0.0f, 1.0f)
+          , m_renderPosition(m_position)
+          , m_renderTarget(m_target)
+          , m_renderFov(60.0f)
+          , m_renderMode(Mode::ThirdPerson)
+          , m_interpolated(false)
           , m_mode(Mode::ThirdPerson)
           , m_fov(60.0f)
           , m_nearPlane(0.1f)
           , m_farPlane(200.0f)
           , m_yaw(0.0f)
           , m_pitch(0.0f)
+          , m_firstPersonSource(nullptr)
           , m_followTarget(nullptr)
           , m_orbitDistance(10.0f)
           , m_orbitHorizontalAngle(180.0f)
-          , m_orbitVerticalAngle(35.0f) {
+          , m_orbitVerticalAngle(35.0f)
+          , m_collisionWorld(nullptr)
+          , m_revision(0) {
     }
 
     void Camera::update(float deltaTime) {
+        glm::vec3 position = m_position;
+        glm::vec3 target = m_target;
+
         switch (m_mode) {
             case Mode::FirstPerson:
                 updateFirstPerson();
@@ -37,19 +54,14 @@ namespace CowGL {
                 break;
         }
 
+        if (m_position != position || m_target != target) {
+            ++m_revision;
+        }
     }
     void Camera::updateFirstPerson() {
-        if (m_followTarget) {
-            // Get cow to determine eye position and look direction
-            auto scene = Application::getInstance()->getScene();
-            auto cowObj = scene->findGameObject("MainCow");
-            if (cowObj) {
-                auto cow = std::dynamic_pointer_cast<Cow>(cowObj);
-                if (cow) {
-                    m_position = cow->getEyePosition();
-                    m_target = m_position + cow->getLookDirection();
-                }
-            }
+        if (m_followTarget && m_firstPersonSource) {
+            m_position = m_firstPersonSource->getEyePosition();
+            m_target = m_position + m_firstPersonSource->getLookDirection();
         }
     }
 
@@ -66,10 +78,17 @@ namespace CowGL {
                              m_orbitDistance * std::sin(vAngleRad) * std::sin(hAngleRad),
                              m_orbitDistance * std::cos(vAngleRad)
                          );
+
+            // Pull in to where its sphere first touches anything between the cow and the camera
+            CollisionWorld::Hit hit;
+            if (m_collisionWorld && m_collisionWorld->sweepSphere(m_target, m_position, ORBIT_CLEARANCE, hit)) {
+                m_position = m_target + (m_position - m_target) * hit.fraction;
+            }
         }
     }
 
     void Camera::rotate(float yaw, float pitch) {
+        ++m_revision;
         if (m_mode == Mode::FirstPerson) {
             m_yaw += yaw;
             m_pitch = std::clamp(m_pitch + pitch, -89.0f, 89.0f);
@@ -80,6 +99,7 @@ namespace CowGL {
     }
 
     void Camera::zoom(float delta) {
+        ++m_revision;
         if (m_mode == Mode::ThirdPerson) {
             m_orbitDistance = std::clamp(m_orbitDistance + delta, 2.0f, 20.0f);
         } else {
@@ -87,7 +107,33 @@ namespace CowGL {
         }
     }
 
+    Frustum Camera::getFrustum(float aspectRatio) const {
+        return Frustum::fromPerspective(getRenderPosition(), getRenderTarget(), m_up, getRenderFOV(),
+                                        aspectRatio, m_nearPlane, m_farPlane);
+    }
+
+    void Camera::captureState(CameraState &state) const {
+        state.position = m_position;
+        state.target = m_target;
+        state.fov = m_fov;
+        state.mode = m_mode;
+    }
+
+    void Camera::applyState(const CameraState &from, const CameraState &to, float alpha) {
+        // A mode switch jumps to the new view instead of sweeping across the scene
+        if (from.mode != to.mode) {
+            alpha = 1.0f;
+        }
+
+        m_renderPosition = from.position + (to.position - from.position) * alpha;
+        m_renderTarget = from.target + (to.target - from.target) * alpha;
+        m_renderFov = from.fov + (to.fov - from.fov) * alpha;
+        m_renderMode = to.mode;
+        m_interpolated = true;
+    }
+
     void Camera::setOrbitAngles(float horizontal, float vertical) {
+        ++m_revision;
         m_orbitHorizontalAngle = horizontal;
         m_orbitVerticalAngle = std::clamp(vertical, 15.0f, 89.0f);
     }
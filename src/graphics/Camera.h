@@ -8,11 +8,15 @@
 #define CAMERA_H
 
 
-#include "entities/Cow.h"
-#include "scene/Scene.h"
+#include "graphics/Frustum.h"
 #include "utils/Math.h"
+#include <cstdint>
 
 namespace CowGL {
+    struct CameraState;
+    class Cow;
+    class CollisionWorld;
+
     class Camera {
     public:
         enum class Mode {
@@ -27,13 +31,13 @@ namespace CowGL {
         void update(float deltaTime);
 
         // Setters
-        void setPosition(const glm::vec3 &position) { m_position = position; }
-        void setTarget(const glm::vec3 &target) { m_target = target; }
-        void setUp(const glm::vec3 &up) { m_up = up; }
-        void setMode(Mode mode) { m_mode = mode; }
-        void setFOV(float fov) { m_fov = fov; }
-        void setNearPlane(float near) { m_nearPlane = near; }
-        void setFarPlane(float far) { m_farPlane = far; }
+        void setPosition(const glm::vec3 &position) { m_position = position; ++m_revision; }
+        void setTarget(const glm::vec3 &target) { m_target = target; ++m_revision; }
+        void setUp(const glm::vec3 &up) { m_up = up; ++m_revision; }
+        void setMode(Mode mode) { m_mode = mode; ++m_revision; }
+        void setFOV(float fov) { m_fov = fov; ++m_revision; }
+        void setNearPlane(float near) { m_nearPlane = near; ++m_revision; }
+        void setFarPlane(float far) { m_farPlane = far; ++m_revision; }
 
         // Getters
         const glm::vec3 &getPosition() const { return m_position; }
@@ -44,20 +48,43 @@ namespace CowGL {
         float getNearPlane() const { return m_nearPlane; }
         float getFarPlane() const { return m_farPlane; }
 
+        // View blended between the last two simulation ticks, for drawing; a camera
+        // that was never captured draws its simulation state
+        void captureState(CameraState &state) const;
+
+        void applyState(const CameraState &from, const CameraState &to, float alpha);
+
+        const glm::vec3 &getRenderPosition() const { return m_interpolated ? m_renderPosition : m_position; }
+        const glm::vec3 &getRenderTarget() const { return m_interpolated ? m_renderTarget : m_target; }
+        float getRenderFOV() const { return m_interpolated ? m_renderFov : m_fov; }
+        Mode getRenderMode() const { return m_interpolated ? m_renderMode : m_mode; }
+
+        // The six view planes for the render view and near/far planes
+        Frustum getFrustum(float aspectRatio) const;
+
         // Camera controls
         void rotate(float yaw, float pitch);
 
         void zoom(float delta);
 
-        void setFollowTarget(const glm::vec3 *target) { m_followTarget = target; }
+        void setFollowTarget(const glm::vec3 *target) { m_followTarget = target; ++m_revision; }
+
+        // Cow whose eyes the first person view looks through
+        void setFirstPersonSource(const Cow *cow) { m_firstPersonSource = cow; ++m_revision; }
 
         // Third person camera controls
-        void setOrbitDistance(float distance) { m_orbitDistance = distance; }
+        void setOrbitDistance(float distance) { m_orbitDistance = distance; ++m_revision; }
 
         void setOrbitAngles(float horizontal, float vertical);
 
+        // The third person camera moves in front of solid objects rather than into them
+        void setCollisionWorld(const CollisionWorld *world) { m_collisionWorld = world; ++m_revision; }
+
         float getOrbitDistance() const { return m_orbitDistance; }
 
+        // Changes whenever the view does
+        uint64_t getRevision() const { return m_revision; }
+
 
     private:
         void updateFirstPerson();
@@ -68,6 +95,13 @@ namespace CowGL {
         glm::vec3 m_target;
         glm::vec3 m_up;
 
+        // Render view, written by applyState on the render thread
+        glm::vec3 m_renderPosition;
+        glm::vec3 m_renderTarget;
+        float m_renderFov;
+        Mode m_renderMode;
+        bool m_interpolated;
+
         Mode m_mode;
         float m_fov;
         float m_nearPlane;
@@ -76,12 +110,16 @@ namespace CowGL {
         // First person
         float m_yaw;
         float m_pitch;
+        const Cow *m_firstPersonSource;
 
         // Third person
         const glm::vec3 *m_followTarget;
         float m_orbitDistance;
         float m_orbitHorizontalAngle;
         float m_orbitVerticalAngle;
+        const CollisionWorld *m_collisionWorld;
+
+        uint64_t m_revision;
     };
 } // namespace CowGL
 
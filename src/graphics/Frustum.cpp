@@ -0,0 +1,85 @@
+//==============================================================================
+// File: graphics/Frustum.cpp
+// Purpose: Frustum implementation
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "graphics/Frustum.h"
+
+namespace CowGL {
+    Frustum Frustum::fromMatrix(const glm::mat4 &viewProjection) {
+        const float *m = viewProjection.m;
+        auto row = [m](int r) { return glm::vec4(m[r], m[4 + r], m[8 + r], m[12 + r]); };
+
+        glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+        glm::vec4 planes[Count] = {
+            glm::vec4(r3.x + r0.x, r3.y + r0.y, r3.z + r0.z, r3.w + r0.w), // Left
+            glm::vec4(r3.x - r0.x, r3.y - r0.y, r3.z - r0.z, r3.w - r0.w), // Right
+            glm::vec4(r3.x + r1.x, r3.y + r1.y, r3.z + r1.z, r3.w + r1.w), // Bottom
+            glm::vec4(r3.x - r1.x, r3.y - r1.y, r3.z - r1.z, r3.w - r1.w), // Top
+            glm::vec4(r3.x + r2.x, r3.y + r2.y, r3.z + r2.z, r3.w + r2.w), // Near
+            glm::vec4(r3.x - r2.x, r3.y - r2.y, r3.z - r2.z, r3.w - r2.w) // Far
+        };
+
+        Frustum frustum;
+        for (int i = 0; i < Count; ++i) {
+            glm::vec3 normal(planes[i].x, planes[i].y, planes[i].z);
+            float length = normal.length();
+            frustum.m_planes[i].normal = normal * (1.0f / length);
+            frustum.m_planes[i].distance = planes[i].w / length;
+        }
+        return frustum;
+    }
+
+    Frustum Frustum::fromPerspective(const glm::vec3 &position, const glm::vec3 &target, const glm::vec3 &up,
+                                     float fovY, float aspectRatio, float nearPlane, float farPlane) {
+        // Camera basis, as gluLookAt builds it
+        glm::vec3 forward = (target - position).normalized();
+        glm::vec3 right = glm::vec3::cross(forward, up).normalized();
+        glm::vec3 cameraUp = glm::vec3::cross(right, forward);
+
+        float halfHeight = std::tan(glm::radians(fovY) * 0.5f);
+        float halfWidth = halfHeight * aspectRatio;
+
+        auto makePlane = [&position](const glm::vec3 &normal) {
+            Plane plane;
+            plane.normal = normal.normalized();
+            plane.distance = -glm::vec3::dot(plane.normal, position);
+            return plane;
+        };
+
+        // Side planes pass through the eye; their normals lean inwards from the edge directions
+        Frustum frustum;
+        frustum.m_planes[Left] = makePlane(glm::vec3::cross(forward - right * halfWidth, cameraUp));
+        frustum.m_planes[Right] = makePlane(glm::vec3::cross(cameraUp, forward + right * halfWidth));
+        frustum.m_planes[Bottom] = makePlane(glm::vec3::cross(right, forward - cameraUp * halfHeight));
+        frustum.m_planes[Top] = makePlane(glm::vec3::cross(forward + cameraUp * halfHeight, right));
+
+        frustum.m_planes[Near].normal = forward;
+        frustum.m_planes[Near].distance = -glm::vec3::dot(forward, position + forward * nearPlane);
+        frustum.m_planes[Far].normal = -forward;
+        frustum.m_planes[Far].distance = glm::vec3::dot(forward, position + forward * farPlane);
+        return frustum;
+    }
+
+    bool Frustum::intersectsSphere(const glm::vec3 &center, float radius) const {
+        for (const Plane &plane: m_planes) {
+            if (plane.signedDistance(center) < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Frustum::intersectsBox(const glm::vec3 &min, const glm::vec3 &max) const {
+        for (const Plane &plane: m_planes) {
+            glm::vec3 positive(plane.normal.x >= 0.0f ? max.x : min.x,
+                               plane.normal.y >= 0.0f ? max.y : min.y,
+                               plane.normal.z >= 0.0f ? max.z : min.z);
+            if (plane.signedDistance(positive) < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace CowGL
@@ -0,0 +1,59 @@
+//==============================================================================
+// File: graphics/Frustum.h
+// Purpose: View frustum planes for visibility tests
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+
+#include <array>
+#include "utils/Math.h"
+
+namespace CowGL {
+    class Frustum {
+    public:
+        enum Side {
+            Left,
+            Right,
+            Bottom,
+            Top,
+            Near,
+            Far,
+            Count
+        };
+
+        // Plane as (normal, distance) with the normal pointing into the frustum
+        struct Plane {
+            glm::vec3 normal;
+            float distance = 0.0f;
+
+            float signedDistance(const glm::vec3 &point) const {
+                return glm::vec3::dot(normal, point) + distance;
+            }
+        };
+
+        Frustum() = default;
+
+        // Gribb/Hartmann extraction from a combined projection * view matrix
+        static Frustum fromMatrix(const glm::mat4 &viewProjection);
+
+        // Planes built directly from a perspective camera (vertical FOV in degrees)
+        static Frustum fromPerspective(const glm::vec3 &position, const glm::vec3 &target, const glm::vec3 &up,
+                                       float fovY, float aspectRatio, float nearPlane, float farPlane);
+
+        bool intersectsSphere(const glm::vec3 &center, float radius) const;
+
+        // Conservative box test against the plane-facing corner of the box
+        bool intersectsBox(const glm::vec3 &min, const glm::vec3 &max) const;
+
+        const Plane &getPlane(Side side) const { return m_planes[side]; }
+
+    private:
+        std::array<Plane, Count> m_planes;
+    };
+} // namespace CowGL
+
+
+#endif //FRUSTUM_H
@@ -0,0 +1,194 @@
+//==============================================================================
+// File: graphics/GeometryBuilder.cpp
+// Purpose: Geometry builder implementation
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "graphics/GeometryBuilder.h"
+#include "graphics/Primitives.h"
+#include "utils/OpenGL.h"
+
+namespace CowGL {
+    GeometryBuilder::GeometryBuilder()
+        : m_matrixStack(1)
+          , m_currentBucket(0)
+          , m_immediate(false)
+          , m_globalAmbient(0.0f)
+          , m_sunIntensity(0.0f) {
+        m_buckets.emplace_back();
+    }
+
+    void GeometryBuilder::drawImmediately(float globalAmbient, float sunIntensity) {
+        m_immediate = true;
+        m_globalAmbient = globalAmbient;
+        m_sunIntensity = sunIntensity;
+    }
+
+    void GeometryBuilder::pushMatrix() {
+        m_matrixStack.push_back(m_matrixStack.back());
+    }
+
+    void GeometryBuilder::popMatrix() {
+        if (m_matrixStack.size() > 1) {
+            m_matrixStack.pop_back();
+        }
+    }
+
+    void GeometryBuilder::loadMatrix(const glm::mat4 &matrix) {
+        m_matrixStack.back() = matrix;
+    }
+
+    void GeometryBuilder::translate(float x, float y, float z) {
+        m_matrixStack.back() = m_matrixStack.back() * glm::mat4::translate(glm::vec3(x, y, z));
+    }
+
+    void GeometryBuilder::rotate(float degrees, float x, float y, float z) {
+        m_matrixStack.back() = m_matrixStack.back() * glm::mat4::rotate(glm::radians(degrees), glm::vec3(x, y, z));
+    }
+
+    void GeometryBuilder::scale(float x, float y, float z) {
+        m_matrixStack.back() = m_matrixStack.back() * glm::mat4::scale(glm::vec3(x, y, z));
+    }
+
+    void GeometryBuilder::setMaterial(const Material &material) {
+        if (m_immediate) {
+            material.apply(m_globalAmbient, m_sunIntensity);
+            return;
+        }
+
+        for (size_t i = 0; i < m_buckets.size(); ++i) {
+            if (m_buckets[i].material == material) {
+                m_currentBucket = i;
+                return;
+            }
+        }
+
+        // Reuse the default bucket if nothing has been added to it yet
+        if (m_buckets.size() == 1 && m_buckets[0].vertices.empty()) {
+            m_buckets[0].material = material;
+            m_currentBucket = 0;
+            return;
+        }
+
+        m_buckets.push_back({material, {}, {}});
+        m_currentBucket = m_buckets.size() - 1;
+    }
+
+    GeometryBuilder::Bucket &GeometryBuilder::currentBucket() {
+        return m_buckets[m_currentBucket];
+    }
+
+    void GeometryBuilder::addTriangle(const glm::vec3 &normal, const glm::vec3 &a, const glm::vec3 &b,
+                                      const glm::vec3 &c) {
+        const glm::mat4 &matrix = m_matrixStack.back();
+        if (m_immediate) {
+            glPushMatrix();
+            glMultMatrixf(matrix.m);
+            glBegin(GL_TRIANGLES);
+            glNormal3f(normal.x, normal.y, normal.z);
+            glVertex3f(a.x, a.y, a.z);
+            glVertex3f(b.x, b.y, b.z);
+            glVertex3f(c.x, c.y, c.z);
+            glEnd();
+            glPopMatrix();
+            return;
+        }
+
+        glm::vec3 n = matrix.normalMatrix().transformDirection(normal).normalized();
+
+        Bucket &bucket = currentBucket();
+        uint32_t base = static_cast<uint32_t>(bucket.vertices.size());
+        bucket.vertices.push_back({matrix.transformPoint(a), n});
+        bucket.vertices.push_back({matrix.transformPoint(b), n});
+        bucket.vertices.push_back({matrix.transformPoint(c), n});
+        bucket.indices.insert(bucket.indices.end(), {base, base + 1, base + 2});
+    }
+
+    void GeometryBuilder::addQuad(const glm::vec3 &normal, const glm::vec3 &a, const glm::vec3 &b,
+                                  const glm::vec3 &c, const glm::vec3 &d) {
+        const glm::mat4 &matrix = m_matrixStack.back();
+        if (m_immediate) {
+            glPushMatrix();
+            glMultMatrixf(matrix.m);
+            glBegin(GL_QUADS);
+            glNormal3f(normal.x, normal.y, normal.z);
+            glVertex3f(a.x, a.y, a.z);
+            glVertex3f(b.x, b.y, b.z);
+            glVertex3f(c.x, c.y, c.z);
+            glVertex3f(d.x, d.y, d.z);
+            glEnd();
+            glPopMatrix();
+            return;
+        }
+
+        glm::vec3 n = matrix.normalMatrix().transformDirection(normal).normalized();
+
+        Bucket &bucket = currentBucket();
+        uint32_t base = static_cast<uint32_t>(bucket.vertices.size());
+        bucket.vertices.push_back({matrix.transformPoint(a), n});
+        bucket.vertices.push_back({matrix.transformPoint(b), n});
+        bucket.vertices.push_back({matrix.transformPoint(c), n});
+        bucket.vertices.push_back({matrix.transformPoint(d), n});
+        bucket.indices.insert(bucket.indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+    }
+
+    void GeometryBuilder::addMesh(const Mesh &mesh) {
+        const glm::mat4 &matrix = m_matrixStack.back();
+        if (m_immediate) {
+            glPushMatrix();
+            glMultMatrixf(matrix.m);
+            mesh.draw();
+            glPopMatrix();
+            return;
+        }
+
+        glm::mat4 normalMatrix = matrix.normalMatrix();
+
+        Bucket &bucket = currentBucket();
+        uint32_t base = static_cast<uint32_t>(bucket.vertices.size());
+        for (const Vertex &v: mesh.getVertices()) {
+            bucket.vertices.push_back({
+                matrix.transformPoint(v.position),
+                normalMatrix.transformDirection(v.normal).normalized()
+            });
+        }
+        for (uint32_t index: mesh.getIndices()) {
+            bucket.indices.push_back(base + index);
+        }
+    }
+
+    void GeometryBuilder::addSphere(float radius, int slices, int stacks) {
+        pushMatrix();
+        scale(radius, radius, radius);
+        addMesh(*Primitives::sphere(slices, stacks));
+        popMatrix();
+    }
+
+    void GeometryBuilder::addCylinder(float radius, float height, int slices, int stacks) {
+        pushMatrix();
+        scale(radius, radius, height);
+        addMesh(*Primitives::cylinder(slices, stacks));
+        popMatrix();
+    }
+
+    void GeometryBuilder::addCone(float base, float height, int slices, int stacks) {
+        pushMatrix();
+        scale(base, base, height);
+        addMesh(*Primitives::cone(slices, stacks));
+        popMatrix();
+    }
+
+    void GeometryBuilder::addDisk(float radius, int slices, int loops) {
+        pushMatrix();
+        scale(radius, radius, 1.0f);
+        addMesh(*Primitives::disk(slices, loops));
+        popMatrix();
+    }
+
+    void GeometryBuilder::clear() {
+        m_matrixStack.assign(1, glm::mat4());
+        m_buckets.clear();
+        m_buckets.emplace_back();
+        m_currentBucket = 0;
+    }
+} // namespace CowGL
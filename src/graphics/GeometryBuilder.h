@@ -0,0 +1,82 @@
+//==============================================================================
+// File: graphics/GeometryBuilder.h
+// Purpose: Records geometry on the CPU, grouped by material, for baking
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef GEOMETRYBUILDER_H
+#define GEOMETRYBUILDER_H
+
+
+#include <vector>
+#include <cstdint>
+#include "graphics/Mesh.h"
+#include "graphics/Material.h"
+#include "utils/Math.h"
+
+namespace CowGL {
+    class GeometryBuilder {
+    public:
+        struct Bucket {
+            Material material;
+            std::vector<Vertex> vertices;
+            std::vector<uint32_t> indices;
+        };
+
+        GeometryBuilder();
+
+        // Draws every shape as it is added, one fixed-function draw per primitive under
+        // the current GL matrix, instead of recording it; materials are applied with
+        // these lighting-menu values. For comparing against baked geometry.
+        void drawImmediately(float globalAmbient, float sunIntensity);
+
+        // Matrix stack, mirroring the fixed-function calls the geometry replaces
+        void pushMatrix();
+
+        void popMatrix();
+
+        void loadMatrix(const glm::mat4 &matrix);
+
+        void translate(float x, float y, float z);
+
+        void rotate(float degrees, float x, float y, float z);
+
+        void scale(float x, float y, float z);
+
+        void setMaterial(const Material &material);
+
+        void addTriangle(const glm::vec3 &normal, const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c);
+
+        void addQuad(const glm::vec3 &normal, const glm::vec3 &a, const glm::vec3 &b,
+                     const glm::vec3 &c, const glm::vec3 &d);
+
+        void addMesh(const Mesh &mesh);
+
+        // Shapes from the shared primitive cache, same parameters as Primitives::draw*
+        void addSphere(float radius, int slices, int stacks);
+
+        void addCylinder(float radius, float height, int slices, int stacks);
+
+        void addCone(float base, float height, int slices, int stacks);
+
+        void addDisk(float radius, int slices, int loops);
+
+        const std::vector<Bucket> &getBuckets() const { return m_buckets; }
+
+        void clear();
+
+    private:
+        Bucket &currentBucket();
+
+        std::vector<glm::mat4> m_matrixStack;
+        std::vector<Bucket> m_buckets;
+        size_t m_currentBucket;
+
+        bool m_immediate;
+        float m_globalAmbient;
+        float m_sunIntensity;
+    };
+} // namespace CowGL
+
+
+#endif //GEOMETRYBUILDER_H
@@ -0,0 +1,201 @@
+//==============================================================================
+// File: graphics/InstanceRenderer.cpp
+// Purpose: Instanced rendering implementation
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "graphics/InstanceRenderer.h"
+#include "graphics/Frustum.h"
+#include "utils/OpenGL.h"
+
+namespace CowGL {
+    InstanceRenderer::InstanceRenderer(const GeometryBuilder &model)
+        : m_boundRadius(0.0f) {
+        addLevel(model);
+
+        // Coarser levels sit inside the full model, so its bounds cover them all
+        glm::vec3 minCorner(1e30f), maxCorner(-1e30f);
+        for (const Part &part: m_levels.front().parts) {
+            for (const Vertex &v: part.mesh->getVertices()) {
+                minCorner = glm::vec3(std::min(minCorner.x, v.position.x),
+                                      std::min(minCorner.y, v.position.y),
+                                      std::min(minCorner.z, v.position.z));
+                maxCorner = glm::vec3(std::max(maxCorner.x, v.position.x),
+                                      std::max(maxCorner.y, v.position.y),
+                                      std::max(maxCorner.z, v.position.z));
+            }
+        }
+
+        m_modelBox = Bounds(minCorner, maxCorner);
+        m_boundCenter = m_modelBox.center;
+        for (const Part &part: m_levels.front().parts) {
+            for (const Vertex &v: part.mesh->getVertices()) {
+                m_boundRadius = std::max(m_boundRadius, (v.position - m_boundCenter).length());
+            }
+        }
+    }
+
+    InstanceRenderer::~InstanceRenderer() = default;
+
+    InstanceRenderer::InstanceRenderer(InstanceRenderer &&other) noexcept = default;
+
+    void InstanceRenderer::addLevel(const GeometryBuilder &model) {
+        Level level;
+        for (const auto &bucket: model.getBuckets()) {
+            if (bucket.indices.empty()) continue;
+
+            Part part;
+            part.material = bucket.material;
+            part.mesh = std::make_unique<Mesh>(bucket.vertices, bucket.indices);
+            level.triangleCount += part.mesh->getTriangleCount();
+            level.parts.push_back(std::move(part));
+        }
+        m_levels.push_back(std::move(level));
+    }
+
+    void InstanceRenderer::clearInstances() {
+        m_transforms.clear();
+        m_tints.clear();
+        m_worldBounds.clear();
+        m_worldBoxMins.clear();
+        m_worldBoxMaxs.clear();
+        m_instanceLevels.clear();
+        m_visible.clear();
+        for (Level &level: m_levels) {
+            level.visible.clear();
+        }
+    }
+
+    void InstanceRenderer::reserve(size_t count) {
+        m_transforms.reserve(count);
+        m_tints.reserve(count);
+        m_worldBounds.reserve(count);
+        m_worldBoxMins.reserve(count);
+        m_worldBoxMaxs.reserve(count);
+        m_instanceLevels.reserve(count);
+        m_visible.reserve(count);
+    }
+
+    void InstanceRenderer::addInstance(const glm::mat4 &transform, const glm::vec4 &tint) {
+        // Largest axis scale keeps the sphere conservative under non-uniform scaling
+        float scale = std::max({
+            transform.transformDirection(glm::vec3(1.0f, 0.0f, 0.0f)).length(),
+            transform.transformDirection(glm::vec3(0.0f, 1.0f, 0.0f)).length(),
+            transform.transformDirection(glm::vec3(0.0f, 0.0f, 1.0f)).length()
+        });
+
+        m_transforms.push_back(transform);
+        m_tints.push_back(tint);
+        m_worldBounds.emplace_back(transform.transformPoint(m_boundCenter), m_boundRadius * scale);
+
+        Bounds box = m_modelBox.transformed(transform);
+        m_worldBoxMins.push_back(box.min);
+        m_worldBoxMaxs.push_back(box.max);
+        m_instanceLevels.push_back(0);
+    }
+
+    size_t InstanceRenderer::cull(const Frustum &frustum) {
+        m_visible.clear();
+        for (size_t i = 0; i < m_worldBounds.size(); ++i) {
+            const glm::vec4 &bounds = m_worldBounds[i];
+            if (!frustum.intersectsSphere(glm::vec3(bounds.x, bounds.y, bounds.z), bounds.w)) continue;
+
+            // A tall model's sphere reaches far past its sides; the box is the tighter test,
+            // as it is for objects drawn one by one
+            if (frustum.intersectsBox(m_worldBoxMins[i], m_worldBoxMaxs[i])) {
+                m_visible.push_back(static_cast<uint32_t>(i));
+            }
+        }
+
+        // Until selectLevels runs, instances keep the level they had last frame
+        for (Level &level: m_levels) {
+            level.visible.clear();
+        }
+        for (uint32_t index: m_visible) {
+            m_levels[m_instanceLevels[index]].visible.push_back(index);
+        }
+
+        return m_visible.size();
+    }
+
+    void InstanceRenderer::selectLevels(const glm::vec3 &eyePosition, float fovY) {
+        int coarsest = static_cast<int>(m_levels.size()) - 1;
+        if (coarsest == 0) return;
+
+        for (Level &level: m_levels) {
+            level.visible.clear();
+        }
+
+        for (uint32_t index: m_visible) {
+            const glm::vec4 &bounds = m_worldBounds[index];
+            float distance = (glm::vec3(bounds.x, bounds.y, bounds.z) - eyePosition).length();
+            int level = LevelOfDetail::selectLevel(m_lodSettings, bounds.w, distance, fovY, m_instanceLevels[index]);
+            level = std::min(level, coarsest);
+
+            m_instanceLevels[index] = static_cast<uint8_t>(level);
+            m_levels[level].visible.push_back(index);
+        }
+    }
+
+    void InstanceRenderer::draw(float globalAmbient, float sunIntensity) const {
+        if (m_visible.empty()) return;
+
+        // Each instance's view transform is composed once here and loaded whole for
+        // every part, instead of a push, multiply and pop per part
+        glm::mat4 view;
+        glGetFloatv(GL_MODELVIEW_MATRIX, view.m);
+        m_modelViews.resize(m_transforms.size());
+        for (uint32_t index: m_visible) {
+            m_modelViews[index] = view * m_transforms[index];
+        }
+
+        glEnable(GL_LIGHTING);
+
+        // Tints go through glColor, which is far cheaper than a glMaterial per instance
+        glColorMaterial(GL_FRONT, GL_AMBIENT_AND_DIFFUSE);
+        glEnable(GL_COLOR_MATERIAL);
+
+        float ambientTint = 0.7f + 0.3f * globalAmbient;
+        size_t trianglesDrawn = 0;
+        for (const Level &level: m_levels) {
+            if (level.visible.empty()) continue;
+            trianglesDrawn += level.visible.size() * level.triangleCount;
+
+            for (const Part &part: level.parts) {
+                part.material.apply(globalAmbient, sunIntensity);
+
+                glm::vec4 base = part.material.ambientDiffuse;
+                if (part.material.tintByAmbient) {
+                    base = glm::vec4(base.x * ambientTint, base.y * ambientTint, base.z * ambientTint, base.w);
+                }
+
+                part.mesh->bind();
+                for (uint32_t index: level.visible) {
+                    const glm::vec4 &tint = m_tints[index];
+                    glColor4f(base.x * tint.x, base.y * tint.y, base.z * tint.z, base.w * tint.w);
+
+                    glLoadMatrixf(m_modelViews[index].m);
+                    part.mesh->drawBound();
+                }
+            }
+        }
+        Mesh::unbind();
+        glLoadMatrixf(view.m);
+
+        LevelOfDetail::record(m_visible.size() * m_levels.front().triangleCount, trianglesDrawn, m_visible.size());
+
+        glDisable(GL_COLOR_MATERIAL);
+        glDisable(GL_LIGHTING);
+    }
+
+    void InstanceRenderer::drawModel(float globalAmbient, float sunIntensity, int level) const {
+        glEnable(GL_LIGHTING);
+
+        for (const Part &part: m_levels[level].parts) {
+            part.material.apply(globalAmbient, sunIntensity);
+            part.mesh->draw();
+        }
+
+        glDisable(GL_LIGHTING);
+    }
+} // namespace CowGL
@@ -0,0 +1,101 @@
+//==============================================================================
+// File: graphics/InstanceRenderer.h
+// Purpose: Draws many copies of one model from a per-instance buffer
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef INSTANCERENDERER_H
+#define INSTANCERENDERER_H
+
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "graphics/GeometryBuilder.h"
+#include "graphics/LevelOfDetail.h"
+#include "scene/Bounds.h"
+
+namespace CowGL {
+    class Frustum;
+
+    class InstanceRenderer {
+    public:
+        // The model is merged into one shared mesh per material
+        explicit InstanceRenderer(const GeometryBuilder &model);
+
+        ~InstanceRenderer();
+
+        InstanceRenderer(InstanceRenderer &&other) noexcept;
+
+        // Coarser versions of the model, in order; the full model is level 0
+        void addLevel(const GeometryBuilder &model);
+
+        void setLodSettings(const LodSettings &settings) { m_lodSettings = settings; }
+        const LodSettings &getLodSettings() const { return m_lodSettings; }
+
+        void clearInstances();
+
+        void reserve(size_t count);
+
+        void addInstance(const glm::mat4 &transform, const glm::vec4 &tint);
+
+        // Tests every instance's bounding sphere, then its box, and compacts the
+        // survivors into the visible list used by draw(); returns the number visible
+        size_t cull(const Frustum &frustum);
+
+        // Re-selects the detail level of every visible instance for this viewpoint
+        void selectLevels(const glm::vec3 &eyePosition, float fovY);
+
+        // Binds each part's mesh and material once, then streams the visible
+        // instances' transforms and tints through it
+        void draw(float globalAmbient, float sunIntensity) const;
+
+        // Draws a single copy at the current modelview matrix
+        void drawModel(float globalAmbient, float sunIntensity, int level = 0) const;
+
+        size_t getInstanceCount() const { return m_transforms.size(); }
+        size_t getVisibleCount() const { return m_visible.size(); }
+        size_t getPartCount() const { return m_levels.front().parts.size(); }
+        int getLevelCount() const { return static_cast<int>(m_levels.size()); }
+        size_t getTriangleCount(int level) const { return m_levels[level].triangleCount; }
+
+        // Model-space bounding sphere radius
+        float getBoundRadius() const { return m_boundRadius; }
+
+    private:
+        struct Part {
+            Material material;
+            std::unique_ptr<Mesh> mesh;
+        };
+
+        struct Level {
+            std::vector<Part> parts;
+            size_t triangleCount = 0;
+            std::vector<uint32_t> visible;
+        };
+
+        std::vector<Level> m_levels;
+        LodSettings m_lodSettings;
+
+        // Model-space bounding sphere and box
+        glm::vec3 m_boundCenter;
+        float m_boundRadius;
+        Bounds m_modelBox;
+
+        // Per-instance buffer (structure of arrays)
+        std::vector<glm::mat4> m_transforms;
+        std::vector<glm::vec4> m_tints;
+        std::vector<glm::vec4> m_worldBounds; // xyz centre, w radius
+        std::vector<glm::vec3> m_worldBoxMins;
+        std::vector<glm::vec3> m_worldBoxMaxs;
+        std::vector<uint8_t> m_instanceLevels;
+
+        std::vector<uint32_t> m_visible;
+
+        // View times instance transform of the visible instances, rebuilt every draw
+        mutable std::vector<glm::mat4> m_modelViews;
+    };
+} // namespace CowGL
+
+
+#endif //INSTANCERENDERER_H
@@ -0,0 +1,59 @@
+//==============================================================================
+// File: graphics/LevelOfDetail.cpp
+// Purpose: Level of detail implementation
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "graphics/LevelOfDetail.h"
+#include "utils/Math.h"
+
+#include <algorithm>
+
+namespace CowGL {
+    namespace LevelOfDetail {
+        namespace {
+            Stats s_stats;
+        }
+
+        float projectedSize(float radius, float distance, float fovY) {
+            float halfHeight = std::max(distance, 1e-4f) * std::tan(glm::radians(fovY) * 0.5f);
+            return radius / halfHeight;
+        }
+
+        int selectLevel(const LodSettings &settings, float radius, float distance, float fovY, int current) {
+            float size = projectedSize(radius, distance, fovY);
+            int lastBoundary = static_cast<int>(settings.distances.size());
+            int level = std::clamp(current, 0, lastBoundary);
+
+            // Coarser once the object is clearly smaller than the next boundary...
+            while (level < lastBoundary &&
+                   size < projectedSize(radius, settings.distances[level], settings.referenceFov) *
+                   (1.0f - settings.hysteresis)) {
+                ++level;
+            }
+
+            // ...and finer only once it is clearly larger than the previous one
+            while (level > 0 &&
+                   size > projectedSize(radius, settings.distances[level - 1], settings.referenceFov) *
+                   (1.0f + settings.hysteresis)) {
+                --level;
+            }
+
+            return level;
+        }
+
+        void resetStats() {
+            s_stats = Stats();
+        }
+
+        void record(size_t fullDetailTriangles, size_t drawnTriangles, size_t objects) {
+            s_stats.objects += objects;
+            s_stats.trianglesFullDetail += fullDetailTriangles;
+            s_stats.trianglesDrawn += drawnTriangles;
+        }
+
+        const Stats &getStats() {
+            return s_stats;
+        }
+    } // namespace LevelOfDetail
+} // namespace CowGL
@@ -0,0 +1,49 @@
+//==============================================================================
+// File: graphics/LevelOfDetail.h
+// Purpose: Screen-size based detail level selection with hysteresis
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef LEVELOFDETAIL_H
+#define LEVELOFDETAIL_H
+
+
+#include <vector>
+#include <cstddef>
+
+namespace CowGL {
+    // Switch points for one entity type. distances[i] is where level i + 1 takes
+    // over, measured at the reference FOV; selection compares projected sizes,
+    // so narrowing the FOV keeps more detail at the same distance.
+    struct LodSettings {
+        std::vector<float> distances;
+        float hysteresis = 0.1f;     // Fraction a boundary must be overshot before switching
+        float referenceFov = 60.0f;
+
+        int getLevelCount() const { return static_cast<int>(distances.size()) + 1; }
+    };
+
+    namespace LevelOfDetail {
+        // Fraction of the viewport half-height covered by a bounding sphere
+        float projectedSize(float radius, float distance, float fovY);
+
+        // Level for an object that was drawn at `current` last frame
+        int selectLevel(const LodSettings &settings, float radius, float distance, float fovY, int current);
+
+        // Triangles of LOD-managed objects this frame, at full detail and as drawn
+        struct Stats {
+            size_t objects = 0;
+            size_t trianglesFullDetail = 0;
+            size_t trianglesDrawn = 0;
+        };
+
+        void resetStats();
+
+        void record(size_t fullDetailTriangles, size_t drawnTriangles, size_t objects = 1);
+
+        const Stats &getStats();
+    } // namespace LevelOfDetail
+} // namespace CowGL
+
+
+#endif //LEVELOFDETAIL_H
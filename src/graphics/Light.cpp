@@ -5,7 +5,7 @@
 //==============================================================================
 
 #include "graphics/Light.h"
-#include <OpenGL/gl.h>
+#include "utils/OpenGL.h"
 
 namespace CowGL {
     Light::Light(Type type)
@@ -0,0 +1,81 @@
+//==============================================================================
+// File: graphics/Material.cpp
+// Purpose: Material implementation
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "graphics/Material.h"
+#include "utils/OpenGL.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace CowGL {
+    bool Material::operator==(const Material &other) const {
+        auto same = [](const glm::vec4 &a, const glm::vec4 &b) {
+            return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+        };
+        return same(ambientDiffuse, other.ambientDiffuse) &&
+               same(specular, other.specular) &&
+               shininess == other.shininess &&
+               tintByAmbient == other.tintByAmbient &&
+               specularBySun == other.specularBySun;
+    }
+
+    void Material::apply(float globalAmbient, float sunIntensity) const {
+        float diffuseScale = tintByAmbient ? 0.7f + 0.3f * globalAmbient : 1.0f;
+        GLfloat diffuse[] = {
+            ambientDiffuse.x * diffuseScale,
+            ambientDiffuse.y * diffuseScale,
+            ambientDiffuse.z * diffuseScale,
+            ambientDiffuse.w
+        };
+
+        float specularScale = specularBySun ? sunIntensity : 1.0f;
+        GLfloat highlight[] = {
+            specular.x * specularScale,
+            specular.y * specularScale,
+            specular.z * specularScale,
+            specular.w
+        };
+
+        const GLfloat black[] = {0.0f, 0.0f, 0.0f, 1.0f};
+        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, diffuse);
+        glMaterialfv(GL_FRONT, GL_SPECULAR, highlight);
+        glMaterialfv(GL_FRONT, GL_EMISSION, black);
+        glMaterialf(GL_FRONT, GL_SHININESS, shininess);
+    }
+
+    namespace Materials {
+        namespace {
+            std::vector<Material> &getTable() {
+                static std::vector<Material> table;
+                return table;
+            }
+        }
+
+        MaterialId intern(const Material &material) {
+            std::vector<Material> &table = getTable();
+            for (size_t i = 0; i < table.size(); ++i) {
+                if (table[i] == material) {
+                    return static_cast<MaterialId>(i);
+                }
+            }
+
+            if (table.size() > UINT16_MAX) {
+                throw std::runtime_error("Material table is full");
+            }
+
+            table.push_back(material);
+            return static_cast<MaterialId>(table.size() - 1);
+        }
+
+        const Material &get(MaterialId id) {
+            return getTable()[id];
+        }
+
+        size_t count() {
+            return getTable().size();
+        }
+    } // namespace Materials
+} // namespace CowGL
@@ -0,0 +1,53 @@
+//==============================================================================
+// File: graphics/Material.h
+// Purpose: Surface material description and the shared material table
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+
+#include <cstdint>
+#include <cstddef>
+#include "utils/Math.h"
+
+namespace CowGL {
+    struct Material {
+        glm::vec4 ambientDiffuse = glm::vec4(0.8f, 0.8f, 0.8f, 1.0f);
+        glm::vec4 specular = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        float shininess = 0.0f;
+
+        // Driven by the lighting menu, applied at draw time
+        bool tintByAmbient = false; // diffuse *= 0.7 + 0.3 * global ambient
+        bool specularBySun = false; // specular *= sun intensity
+
+        Material() = default;
+
+        explicit Material(const glm::vec4 &color,
+                          const glm::vec4 &specularColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
+                          float specularShininess = 0.0f)
+            : ambientDiffuse(color), specular(specularColor), shininess(specularShininess) {
+        }
+
+        bool operator==(const Material &other) const;
+
+        // Uploads the material, scaled by the current lighting-menu values
+        void apply(float globalAmbient, float sunIntensity) const;
+    };
+
+    // Small integer name of a material in the shared table, used in sort keys
+    using MaterialId = uint16_t;
+
+    namespace Materials {
+        // Returns the id of an identical material if one is registered already
+        MaterialId intern(const Material &material);
+
+        const Material &get(MaterialId id);
+
+        size_t count();
+    } // namespace Materials
+} // namespace CowGL
+
+
+#endif //MATERIAL_H
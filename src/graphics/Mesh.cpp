@@ -0,0 +1,66 @@
+//==============================================================================
+// File: graphics/Mesh.cpp
+// Purpose: Mesh implementation
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "graphics/Mesh.h"
+#include "utils/OpenGL.h"
+
+#include <cstddef>
+
+namespace CowGL {
+    Mesh::Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices)
+        : m_vertices(std::move(vertices))
+          , m_indices(std::move(indices)) {
+        static uint32_t nextId = 0;
+        m_id = nextId++;
+    }
+
+    Mesh::~Mesh() {
+        if (m_vertexBuffer) glDeleteBuffers(1, &m_vertexBuffer);
+        if (m_indexBuffer) glDeleteBuffers(1, &m_indexBuffer);
+    }
+
+    void Mesh::upload() const {
+        glGenBuffers(1, &m_vertexBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), m_vertices.data(), GL_STATIC_DRAW);
+
+        glGenBuffers(1, &m_indexBuffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(uint32_t), m_indices.data(), GL_STATIC_DRAW);
+    }
+
+    void Mesh::draw() const {
+        bind();
+        drawBound();
+        unbind();
+    }
+
+    void Mesh::bind() const {
+        if (!m_vertexBuffer) {
+            upload();
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glVertexPointer(3, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void *>(offsetof(Vertex, position)));
+        glNormalPointer(GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void *>(offsetof(Vertex, normal)));
+    }
+
+    void Mesh::drawBound() const {
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()), GL_UNSIGNED_INT, nullptr);
+    }
+
+    void Mesh::unbind() {
+        glDisableClientState(GL_NORMAL_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+} // namespace CowGL
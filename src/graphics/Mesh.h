@@ -0,0 +1,66 @@
+//==============================================================================
+// File: graphics/Mesh.h
+// Purpose: Indexed triangle mesh stored in GPU buffers
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef MESH_H
+#define MESH_H
+
+
+#include <vector>
+#include <cstdint>
+#include "utils/Math.h"
+
+namespace CowGL {
+    struct Vertex {
+        glm::vec3 position;
+        glm::vec3 normal;
+    };
+
+    class Mesh {
+    public:
+        Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices);
+
+        ~Mesh();
+
+        // Meshes own GL buffers, so they are shared by handle rather than copied
+        Mesh(const Mesh &) = delete;
+
+        Mesh &operator=(const Mesh &) = delete;
+
+        // Binds, draws and unbinds in one go
+        void draw() const;
+
+        // For drawing the same mesh many times in a row
+        void bind() const;
+
+        void drawBound() const;
+
+        static void unbind();
+
+        size_t getVertexCount() const { return m_vertices.size(); }
+        size_t getIndexCount() const { return m_indices.size(); }
+        size_t getTriangleCount() const { return m_indices.size() / 3; }
+
+        const std::vector<Vertex> &getVertices() const { return m_vertices; }
+        const std::vector<uint32_t> &getIndices() const { return m_indices; }
+
+        // Unique per mesh for the lifetime of the program, used in sort keys
+        uint32_t getId() const { return m_id; }
+
+    private:
+        // Buffers are created on first use so meshes can be built before a GL context exists
+        void upload() const;
+
+        std::vector<Vertex> m_vertices;
+        std::vector<uint32_t> m_indices;
+        uint32_t m_id;
+
+        mutable unsigned int m_vertexBuffer = 0;
+        mutable unsigned int m_indexBuffer = 0;
+    };
+} // namespace CowGL
+
+
+#endif //MESH_H
@@ -0,0 +1,409 @@
+//==============================================================================
+// File: graphics/Primitives.cpp
+// Purpose: Primitive tessellation and cache
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "graphics/Primitives.h"
+#include "utils/OpenGL.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <tuple>
+
+namespace CowGL {
+    namespace Primitives {
+        namespace {
+            const int VERTEX_CACHE_SIZE = 32;
+
+            struct CacheEntry {
+                MeshHandle mesh;
+                double generationMs;
+                float acmrBefore;
+                float acmrAfter;
+            };
+
+            using CacheKey = std::tuple<Shape, int, int>;
+
+            std::map<CacheKey, CacheEntry> &getCache() {
+                static std::map<CacheKey, CacheEntry> cache;
+                return cache;
+            }
+
+            const char *shapeName(Shape shape) {
+                switch (shape) {
+                    case Shape::Sphere: return "sphere";
+                    case Shape::Cylinder: return "cylinder";
+                    case Shape::Cone: return "cone";
+                    case Shape::Disk: return "disk";
+                }
+                return "unknown";
+            }
+
+            void addTriangle(std::vector<uint32_t> &indices, uint32_t a, uint32_t b, uint32_t c) {
+                indices.push_back(a);
+                indices.push_back(b);
+                indices.push_back(c);
+            }
+
+            void buildSphere(int slices, int stacks, std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+                // Rows run from the north pole (+z) to the south pole, seam duplicated
+                for (int i = 0; i <= stacks; ++i) {
+                    float theta = PI * i / stacks;
+                    for (int j = 0; j <= slices; ++j) {
+                        float phi = TWO_PI * j / slices;
+                        glm::vec3 p(std::sin(theta) * std::cos(phi),
+                                    std::sin(theta) * std::sin(phi),
+                                    std::cos(theta));
+                        vertices.push_back({p, p});
+                    }
+                }
+
+                uint32_t row = slices + 1;
+                for (int i = 0; i < stacks; ++i) {
+                    for (int j = 0; j < slices; ++j) {
+                        uint32_t a = i * row + j;
+                        uint32_t b = (i + 1) * row + j;
+                        uint32_t c = (i + 1) * row + j + 1;
+                        uint32_t d = i * row + j + 1;
+                        // Skip the degenerate half of each quad touching a pole
+                        if (i != stacks - 1) addTriangle(indices, a, b, c);
+                        if (i != 0) addTriangle(indices, a, c, d);
+                    }
+                }
+            }
+
+            void buildCylinder(int slices, int stacks, std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+                for (int i = 0; i <= stacks; ++i) {
+                    float z = static_cast<float>(i) / stacks;
+                    for (int j = 0; j <= slices; ++j) {
+                        float phi = TWO_PI * j / slices;
+                        glm::vec3 n(std::cos(phi), std::sin(phi), 0.0f);
+                        vertices.push_back({glm::vec3(n.x, n.y, z), n});
+                    }
+                }
+
+                uint32_t row = slices + 1;
+                for (int i = 0; i < stacks; ++i) {
+                    for (int j = 0; j < slices; ++j) {
+                        uint32_t a = i * row + j;
+                        uint32_t b = i * row + j + 1;
+                        uint32_t c = (i + 1) * row + j + 1;
+                        uint32_t d = (i + 1) * row + j;
+                        addTriangle(indices, a, b, c);
+                        addTriangle(indices, a, c, d);
+                    }
+                }
+            }
+
+            void buildCone(int slices, int stacks, std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+                // Side: radius shrinks linearly to the apex, normals tilted 45 degrees up
+                for (int i = 0; i <= stacks; ++i) {
+                    float z = static_cast<float>(i) / stacks;
+                    float r = 1.0f - z;
+                    for (int j = 0; j <= slices; ++j) {
+                        float phi = TWO_PI * j / slices;
+                        glm::vec3 n = glm::vec3(std::cos(phi), std::sin(phi), 1.0f).normalized();
+                        vertices.push_back({glm::vec3(r * std::cos(phi), r * std::sin(phi), z), n});
+                    }
+                }
+
+                uint32_t row = slices + 1;
+                for (int i = 0; i < stacks; ++i) {
+                    for (int j = 0; j < slices; ++j) {
+                        uint32_t a = i * row + j;
+                        uint32_t b = i * row + j + 1;
+                        uint32_t c = (i + 1) * row + j + 1;
+                        uint32_t d = (i + 1) * row + j;
+                        addTriangle(indices, a, b, c);
+                        if (i != stacks - 1) addTriangle(indices, a, c, d);
+                    }
+                }
+
+                // Base cap facing down
+                uint32_t center = static_cast<uint32_t>(vertices.size());
+                glm::vec3 down(0.0f, 0.0f, -1.0f);
+                vertices.push_back({glm::vec3(0.0f, 0.0f, 0.0f), down});
+                for (int j = 0; j < slices; ++j) {
+                    float phi = TWO_PI * j / slices;
+                    vertices.push_back({glm::vec3(std::cos(phi), std::sin(phi), 0.0f), down});
+                }
+                for (int j = 0; j < slices; ++j) {
+                    addTriangle(indices, center, center + 1 + (j + 1) % slices, center + 1 + j);
+                }
+            }
+
+            void buildDisk(int slices, int loops, std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+                glm::vec3 up(0.0f, 0.0f, 1.0f);
+                vertices.push_back({glm::vec3(0.0f, 0.0f, 0.0f), up});
+                for (int l = 1; l <= loops; ++l) {
+                    float r = static_cast<float>(l) / loops;
+                    for (int j = 0; j < slices; ++j) {
+                        float phi = TWO_PI * j / slices;
+                        vertices.push_back({glm::vec3(r * std::cos(phi), r * std::sin(phi), 0.0f), up});
+                    }
+                }
+
+                auto ring = [slices](int loop, int j) {
+                    return static_cast<uint32_t>(1 + (loop - 1) * slices + j % slices);
+                };
+
+                for (int j = 0; j < slices; ++j) {
+                    addTriangle(indices, 0, ring(1, j), ring(1, j + 1));
+                }
+                for (int l = 1; l < loops; ++l) {
+                    for (int j = 0; j < slices; ++j) {
+                        uint32_t a = ring(l, j);
+                        uint32_t b = ring(l + 1, j);
+                        uint32_t c = ring(l + 1, j + 1);
+                        uint32_t d = ring(l, j + 1);
+                        addTriangle(indices, a, b, c);
+                        addTriangle(indices, a, c, d);
+                    }
+                }
+            }
+
+            // Average cache miss ratio (vertex shader runs per triangle) for a FIFO cache
+            float computeACMR(const std::vector<uint32_t> &indices, size_t vertexCount) {
+                if (indices.empty()) return 0.0f;
+
+                std::vector<int> insertedAt(vertexCount, -VERTEX_CACHE_SIZE - 1);
+                int misses = 0;
+                for (uint32_t index: indices) {
+                    if (misses - insertedAt[index] > VERTEX_CACHE_SIZE) {
+                        insertedAt[index] = misses;
+                        ++misses;
+                    }
+                }
+                return static_cast<float>(misses) / (indices.size() / 3);
+            }
+
+            // Tom Forsyth's linear-speed vertex cache optimisation: greedily emit the
+            // triangle whose vertices score best given an LRU model of the cache
+            float vertexScore(int cachePosition, int remainingTriangles) {
+                if (remainingTriangles == 0) return -1.0f;
+
+                float score = 0.0f;
+                if (cachePosition >= 0) {
+                    if (cachePosition < 3) {
+                        score = 0.75f;
+                    } else {
+                        float scaler = 1.0f / (VERTEX_CACHE_SIZE - 3);
+                        score = std::pow(1.0f - (cachePosition - 3) * scaler, 1.5f);
+                    }
+                }
+                return score + 2.0f * std::pow(static_cast<float>(remainingTriangles), -0.5f);
+            }
+
+            void optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount) {
+                size_t triangleCount = indices.size() / 3;
+                if (triangleCount == 0) return;
+
+                // Vertex -> triangles adjacency
+                std::vector<int> remaining(vertexCount, 0);
+                for (uint32_t index: indices) ++remaining[index];
+
+                std::vector<size_t> adjacencyStart(vertexCount + 1, 0);
+                for (size_t v = 0; v < vertexCount; ++v) adjacencyStart[v + 1] = adjacencyStart[v] + remaining[v];
+                std::vector<uint32_t> adjacency(indices.size());
+                std::vector<size_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+                for (size_t t = 0; t < triangleCount; ++t) {
+                    for (int k = 0; k < 3; ++k) adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+                }
+
+                std::vector<int> cachePosition(vertexCount, -1);
+                std::vector<float> score(vertexCount);
+                for (size_t v = 0; v < vertexCount; ++v) score[v] = vertexScore(-1, remaining[v]);
+
+                std::vector<float> triangleScore(triangleCount);
+                std::vector<bool> emitted(triangleCount, false);
+                for (size_t t = 0; t < triangleCount; ++t) {
+                    triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+                }
+
+                std::vector<uint32_t> output;
+                output.reserve(indices.size());
+                std::vector<uint32_t> cache;
+                cache.reserve(VERTEX_CACHE_SIZE + 3);
+
+                size_t scanCursor = 0;
+                int best = -1;
+                while (output.size() < indices.size()) {
+                    if (best < 0) {
+                        // Nothing adjacent to the cache: fall back to a linear scan
+                        float bestScore = -1.0f;
+                        for (size_t t = scanCursor; t < triangleCount; ++t) {
+                            if (!emitted[t] && triangleScore[t] > bestScore) {
+                                bestScore = triangleScore[t];
+                                best = static_cast<int>(t);
+                            }
+                        }
+                        while (scanCursor < triangleCount && emitted[scanCursor]) ++scanCursor;
+                    }
+
+                    emitted[best] = true;
+                    for (int k = 0; k < 3; ++k) {
+                        uint32_t v = indices[best * 3 + k];
+                        output.push_back(v);
+                        --remaining[v];
+
+                        // Remove the triangle from the vertex's active list
+                        size_t begin = adjacencyStart[v];
+                        size_t end = begin + remaining[v];
+                        for (size_t a = begin; a <= end; ++a) {
+                            if (adjacency[a] == static_cast<uint32_t>(best)) {
+                                std::swap(adjacency[a], adjacency[end]);
+                                break;
+                            }
+                        }
+
+                        auto it = std::find(cache.begin(), cache.end(), v);
+                        if (it != cache.end()) cache.erase(it);
+                        cache.insert(cache.begin(), v);
+                    }
+
+                    // Vertices pushed out of the cache lose their cache bonus
+                    for (size_t c = 0; c < cache.size(); ++c) {
+                        uint32_t v = cache[c];
+                        cachePosition[v] = c < VERTEX_CACHE_SIZE ? static_cast<int>(c) : -1;
+                        score[v] = vertexScore(cachePosition[v], remaining[v]);
+                    }
+
+                    best = -1;
+                    float bestScore = -1.0f;
+                    for (uint32_t v: cache) {
+                        for (size_t a = adjacencyStart[v]; a < adjacencyStart[v] + remaining[v]; ++a) {
+                            uint32_t t = adjacency[a];
+                            triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+                            if (triangleScore[t] > bestScore) {
+                                bestScore = triangleScore[t];
+                                best = static_cast<int>(t);
+                            }
+                        }
+                    }
+
+                    if (cache.size() > VERTEX_CACHE_SIZE) cache.resize(VERTEX_CACHE_SIZE);
+                }
+
+                indices.swap(output);
+            }
+        }
+
+        MeshHandle get(Shape shape, int slices, int stacks) {
+            auto &cache = getCache();
+            CacheKey key(shape, slices, stacks);
+
+            auto it = cache.find(key);
+            if (it != cache.end()) {
+                return it->second.mesh;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+
+            std::vector<Vertex> vertices;
+            std::vector<uint32_t> indices;
+            switch (shape) {
+                case Shape::Sphere: buildSphere(slices, stacks, vertices, indices);
+                    break;
+                case Shape::Cylinder: buildCylinder(slices, stacks, vertices, indices);
+                    break;
+                case Shape::Cone: buildCone(slices, stacks, vertices, indices);
+                    break;
+                case Shape::Disk: buildDisk(slices, stacks, vertices, indices);
+                    break;
+            }
+
+            CacheEntry entry;
+            entry.acmrBefore = computeACMR(indices, vertices.size());
+
+            // Narrow ring layouts already fit the cache; keep whichever order is better
+            std::vector<uint32_t> optimized = indices;
+            optimizeVertexCache(optimized, vertices.size());
+            float optimizedACMR = computeACMR(optimized, vertices.size());
+            if (optimizedACMR < entry.acmrBefore) {
+                indices.swap(optimized);
+            }
+            entry.acmrAfter = std::min(optimizedACMR, entry.acmrBefore);
+            entry.mesh = std::make_shared<const Mesh>(std::move(vertices), std::move(indices));
+            entry.generationMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+
+            cache.emplace(key, entry);
+            return entry.mesh;
+        }
+
+        MeshHandle sphere(int slices, int stacks) {
+            return get(Shape::Sphere, slices, stacks);
+        }
+
+        MeshHandle cylinder(int slices, int stacks) {
+            return get(Shape::Cylinder, slices, stacks);
+        }
+
+        MeshHandle cone(int slices, int stacks) {
+            return get(Shape::Cone, slices, stacks);
+        }
+
+        MeshHandle disk(int slices, int loops) {
+            return get(Shape::Disk, slices, loops);
+        }
+
+        void drawSphere(float radius, int slices, int stacks) {
+            glPushMatrix();
+            glScalef(radius, radius, radius);
+            sphere(slices, stacks)->draw();
+            glPopMatrix();
+        }
+
+        void drawCylinder(float radius, float height, int slices, int stacks) {
+            glPushMatrix();
+            glScalef(radius, radius, height);
+            cylinder(slices, stacks)->draw();
+            glPopMatrix();
+        }
+
+        void drawCone(float base, float height, int slices, int stacks) {
+            glPushMatrix();
+            glScalef(base, base, height);
+            cone(slices, stacks)->draw();
+            glPopMatrix();
+        }
+
+        void drawDisk(float radius, int slices, int loops) {
+            glPushMatrix();
+            glScalef(radius, radius, 1.0f);
+            disk(slices, loops)->draw();
+            glPopMatrix();
+        }
+
+        void printStats(std::ostream &out) {
+            char line[160];
+            std::snprintf(line, sizeof(line), "%-10s %7s %7s %9s %9s %11s %9s %9s\n",
+                          "shape", "slices", "stacks", "vertices", "indices", "bytes", "gen (ms)", "ACMR");
+            out << line;
+
+            size_t totalVertices = 0, totalIndices = 0, totalBytes = 0;
+            double totalMs = 0.0;
+            for (const auto &[key, entry]: getCache()) {
+                size_t bytes = entry.mesh->getVertexCount() * sizeof(Vertex) +
+                               entry.mesh->getIndexCount() * sizeof(uint32_t);
+                std::snprintf(line, sizeof(line), "%-10s %7d %7d %9zu %9zu %11zu %9.3f %4.2f->%4.2f\n",
+                              shapeName(std::get<0>(key)), std::get<1>(key), std::get<2>(key),
+                              entry.mesh->getVertexCount(), entry.mesh->getIndexCount(), bytes,
+                              entry.generationMs, entry.acmrBefore, entry.acmrAfter);
+                out << line;
+
+                totalVertices += entry.mesh->getVertexCount();
+                totalIndices += entry.mesh->getIndexCount();
+                totalBytes += bytes;
+                totalMs += entry.generationMs;
+            }
+
+            std::snprintf(line, sizeof(line), "%-10s %7s %7s %9zu %9zu %11zu %9.3f\n",
+                          "total", "", "", totalVertices, totalIndices, totalBytes, totalMs);
+            out << line;
+        }
+    } // namespace Primitives
+} // namespace CowGL
@@ -0,0 +1,57 @@
+//==============================================================================
+// File: graphics/Primitives.h
+// Purpose: Shared, tessellate-once sphere/cylinder/cone/disk meshes
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef PRIMITIVES_H
+#define PRIMITIVES_H
+
+
+#include <memory>
+#include <ostream>
+#include "graphics/Mesh.h"
+
+namespace CowGL {
+    namespace Primitives {
+        enum class Shape {
+            Sphere,
+            Cylinder,
+            Cone,
+            Disk
+        };
+
+        using MeshHandle = std::shared_ptr<const Mesh>;
+
+        // Unit-sized meshes, tessellated on first request and shared afterwards:
+        //   Sphere   - radius 1 around the origin
+        //   Cylinder - radius 1 from z=0 to z=1, open ends (like gluCylinder)
+        //   Cone     - base radius 1 at z=0, apex at z=1, capped base (like glutSolidCone)
+        //   Disk     - radius 1 in the z=0 plane facing +z (like gluDisk)
+        MeshHandle get(Shape shape, int slices, int stacks);
+
+        MeshHandle sphere(int slices, int stacks);
+
+        MeshHandle cylinder(int slices, int stacks);
+
+        MeshHandle cone(int slices, int stacks);
+
+        MeshHandle disk(int slices, int loops);
+
+        // Drop-in replacements for the GLUT/GLU calls; they scale the unit meshes,
+        // so GL_NORMALIZE must be enabled for lighting to stay correct
+        void drawSphere(float radius, int slices, int stacks);
+
+        void drawCylinder(float radius, float height, int slices, int stacks);
+
+        void drawCone(float base, float height, int slices, int stacks);
+
+        void drawDisk(float radius, int slices, int loops);
+
+        // Vertex/index counts, generation time and post-transform cache efficiency
+        void printStats(std::ostream &out);
+    } // namespace Primitives
+} // namespace CowGL
+
+
+#endif //PRIMITIVES_H
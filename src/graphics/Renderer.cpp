@@ -6,18 +6,26 @@
 
 #include "graphics/Renderer.h"
 #include "graphics/Camera.h"
+#include "graphics/StaticBatch.h"
+#include "graphics/InstanceRenderer.h"
+#include "graphics/Frustum.h"
+#include "graphics/LevelOfDetail.h"
 #include "scene/Scene.h"
 #include "scene/GameObject.h"
-#include "core/Application.h"
-#include "core/Window.h"
+#include "core/FrameContext.h"
+#include "core/Profiler.h"
 
-#include <OpenGL/gl.h>
-#include <GLUT/glut.h>
+#include "utils/OpenGL.h"
 
-#include "ui/UIManager.h"
+#include <algorithm>
 
 namespace CowGL {
-    Renderer::Renderer() {
+    Renderer::Renderer()
+        : m_hasFrustum(false)
+          , m_cameraFov(60.0f)
+          , m_staticBatch(std::make_unique<StaticBatch>())
+          , m_staticBatchScene(nullptr)
+          , m_staticBatchRevision(0) {
         // Renderer will be initialized after OpenGL context is created
     }
 
@@ -32,6 +40,9 @@ namespace CowGL {
         glEnable(GL_LIGHTING);
         glEnable(GL_LIGHT0);
 
+        // Shared primitives are unit meshes scaled into place, so normals need renormalising
+        glEnable(GL_NORMALIZE);
+
         // Set up default material properties
         GLfloat mat_specular[] = {1.0, 1.0, 1.0, 1.0};
         GLfloat mat_shininess[] = {50.0};
@@ -47,15 +58,20 @@ namespace CowGL {
         // Don't swap buffers here - let Application handle it after UI rendering
     }
 
-    void Renderer::renderScene(Scene *scene) {
+    void Renderer::renderScene(Scene *scene, const FrameContext &context) {
         if (!scene) return;
+        COWGL_PROFILE_SCOPE("Render scene");
+
+        m_stats = RenderStats();
+        m_hasFrustum = false;
+        LevelOfDetail::resetStats();
 
         // Setup camera
-        Camera *camera = scene->getActiveCamera();
+        const Camera *camera = context.camera;
         if (camera) {
-            auto window = Application::getInstance()->getWindow();
-            int width = window->getWidth();
-            int height = window->getHeight();
+            int width = context.width;
+            int height = context.height;
+            float aspectRatio = (float) width / (float) height;
 
             // Set viewport for main scene (accounting for UI)
             glViewport(0, 0, width, height);
@@ -63,8 +79,8 @@ namespace CowGL {
             // Setup projection matrix
             glMatrixMode(GL_PROJECTION);
             glLoadIdentity();
-            gluPerspective(camera->getFOV(),
-                           (float) width / (float) height,
+            gluPerspective(camera->getRenderFOV(),
+                           aspectRatio,
                            camera->getNearPlane(),
                            camera->getFarPlane());
 
@@ -72,27 +88,148 @@ namespace CowGL {
             glMatrixMode(GL_MODELVIEW);
             glLoadIdentity();
 
-            glm::vec3 pos = camera->getPosition();
-            glm::vec3 target = camera->getTarget();
+            glm::vec3 pos = camera->getRenderPosition();
+            glm::vec3 target = camera->getRenderTarget();
             glm::vec3 up = camera->getUp();
 
             gluLookAt(pos.x, pos.y, pos.z,
                       target.x, target.y, target.z,
                       up.x, up.y, up.z);
+
+            m_frustum = camera->getFrustum(aspectRatio);
+            m_hasFrustum = true;
+            m_cameraPosition = pos;
+            m_cameraFov = camera->getRenderFOV();
         }
 
         // Setup lighting
-        setupLighting(scene);
+        const LightingState &lighting = context.lighting;
+        setupLighting(lighting);
+
+        // Sky and sun behind everything else
+        if (camera) {
+            COWGL_PROFILE_SCOPE("Sky");
+            m_skyPass.draw(*camera, lighting.sunAngle, lighting.sunIntensity);
+        }
+
+        // Static world in one packet per material, instanced models in one pass each
+        {
+            COWGL_PROFILE_SCOPE("Static geometry");
+            updateStaticGeometry(scene);
+        }
 
-        // Render skybox/background
-        renderSkybox();
+        m_queue.clear();
+        if (camera) {
+            m_queue.setView(camera->getRenderPosition(), camera->getFarPlane());
+        }
+        m_staticBatch->enqueue(m_queue);
+        renderInstances(lighting.globalAmbient, lighting.sunIntensity);
 
-        // Render all game objects
+        // Remaining game objects that the camera can see go into the queue when they
+        // can, the rest draw themselves immediately
         const auto &objects = scene->getGameObjects();
         for (const auto &obj: objects) {
-            if (obj->isActive()) {
-                obj->render();
+            if (!obj->isActive() || isDrawnInBatch(*obj)) continue;
+
+            if (!isVisible(*obj)) {
+                m_stats.objectsCulled++;
+                continue;
+            }
+
+            m_stats.objectsDrawn++;
+            if (!obj->enqueue(m_queue, context)) {
+                obj->render(context);
+            }
+        }
+
+        // State changes are grouped by material and mesh rather than scene order
+        {
+            COWGL_PROFILE_SCOPE("Queue sort");
+            m_queue.sort();
+        }
+        {
+            COWGL_PROFILE_SCOPE("Queue execute");
+            m_queue.execute(lighting.globalAmbient, lighting.sunIntensity);
+        }
+
+        const RenderQueue::Stats &queueStats = m_queue.getStats();
+        m_stats.drawPackets = queueStats.packets;
+        m_stats.materialSwitchesUnsorted = queueStats.materialSwitchesUnsorted;
+        m_stats.materialSwitches = queueStats.materialSwitches;
+
+        const LevelOfDetail::Stats &lodStats = LevelOfDetail::getStats();
+        m_stats.trianglesFullDetail = lodStats.trianglesFullDetail;
+        m_stats.trianglesDrawn = lodStats.trianglesDrawn;
+
+        COWGL_PROFILE_COUNTER("Objects drawn", m_stats.objectsDrawn);
+        COWGL_PROFILE_COUNTER("Draw packets", m_stats.drawPackets);
+        COWGL_PROFILE_COUNTER("Triangles drawn", m_stats.trianglesDrawn);
+    }
+
+    bool Renderer::isVisible(const GameObject &object) {
+        if (!m_hasFrustum || !object.hasBounds()) return true;
+
+        m_stats.objectsTested++;
+
+        Bounds bounds = object.getRenderBounds();
+        if (!m_frustum.intersectsSphere(bounds.center, bounds.radius)) return false;
+        return m_frustum.intersectsBox(bounds.min, bounds.max);
+    }
+
+    bool Renderer::isDrawnInBatch(const GameObject &object) {
+        return object.isStatic() && (object.hasStaticGeometry() || object.getInstanceRenderer());
+    }
+
+    void Renderer::updateStaticGeometry(Scene *scene) {
+        // Only adding or removing a static object invalidates the bake
+        if (scene == m_staticBatchScene && scene->getStaticRevision() == m_staticBatchRevision) {
+            return;
+        }
+
+        m_staticBatch->build(scene->getGameObjects());
+
+        for (InstanceRenderer *instances: m_instanceRenderers) {
+            instances->clearInstances();
+        }
+        m_instanceRenderers.clear();
+
+        for (const auto &obj: scene->getGameObjects()) {
+            InstanceRenderer *instances = obj->getInstanceRenderer();
+            if (!instances || !obj->isStatic() || !obj->isActive()) continue;
+
+            if (std::find(m_instanceRenderers.begin(), m_instanceRenderers.end(), instances) ==
+                m_instanceRenderers.end()) {
+                m_instanceRenderers.push_back(instances);
+            }
+            instances->addInstance(obj->getTransform().getWorldMatrix(), obj->getInstanceTint());
+        }
+
+        m_staticBatchScene = scene;
+        m_staticBatchRevision = scene->getStaticRevision();
+    }
+
+    void Renderer::renderInstances(float globalAmbient, float sunIntensity) {
+        if (m_instanceRenderers.empty()) return;
+        COWGL_PROFILE_SCOPE("Instances");
+
+        // Without a camera there is no frustum, so fall back to the current GL matrices
+        Frustum frustum = m_frustum;
+        if (!m_hasFrustum) {
+            glm::mat4 projection, modelView;
+            glGetFloatv(GL_PROJECTION_MATRIX, projection.m);
+            glGetFloatv(GL_MODELVIEW_MATRIX, modelView.m);
+            frustum = Frustum::fromMatrix(projection * modelView);
+        }
+
+        for (InstanceRenderer *instances: m_instanceRenderers) {
+            size_t visible = instances->cull(frustum);
+            if (m_hasFrustum) {
+                instances->selectLevels(m_cameraPosition, m_cameraFov);
             }
+            m_stats.objectsTested += instances->getInstanceCount();
+            m_stats.objectsCulled += instances->getInstanceCount() - visible;
+            m_stats.objectsDrawn += visible;
+            instances->draw(globalAmbient, sunIntensity);
         }
     }
 
@@ -116,14 +253,10 @@ namespace CowGL {
         glPopAttrib();
     }
 
-    void Renderer::setupLighting(Scene *scene) {
-        // Get lighting values from UIManager
-        auto app = Application::getInstance();
-        auto uiManager = app->getUIManager();
-
-        float globalAmbientValue = uiManager ? uiManager->getGlobalAmbient() : 0.3f;
-        float sunIntensityValue = uiManager ? uiManager->getSunIntensity() : 1.0f;
-        float sunAngleValue = uiManager ? uiManager->getSunAngle() : 45.0f;
+    void Renderer::setupLighting(const LightingState &lighting) {
+        float globalAmbientValue = lighting.globalAmbient;
+        float sunIntensityValue = lighting.sunIntensity;
+        float sunAngleValue = lighting.sunAngle;
 
         // Setup global ambient light
         GLfloat globalAmbient[] = {globalAmbientValue, globalAmbientValue, globalAmbientValue, 1.0f};
@@ -142,98 +275,6 @@ namespace CowGL {
         glLightfv(GL_LIGHT0, GL_SPECULAR, lightSpecular);
     }
 
-    void Renderer::renderSkybox() {
-        // Get current lighting values
-        auto app = Application::getInstance();
-        auto uiManager = app->getUIManager();
-        float globalAmbientValue = uiManager ? uiManager->getGlobalAmbient() : 0.3f;
-        float sunIntensityValue = uiManager ? uiManager->getSunIntensity() : 1.0f;
-        float sunAngleValue = uiManager ? uiManager->getSunAngle() : 45.0f;
-
-        // Save current state
-        glPushMatrix();
-        glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_DEPTH_BUFFER_BIT);
-
-        // Disable depth writes and testing for sky rendering
-        glDisable(GL_DEPTH_TEST);
-        glDepthMask(GL_FALSE);
-
-        // Disable lighting for sky rendering
-        glDisable(GL_LIGHTING);
-
-        // Enable backface culling to render inside of sphere
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_FRONT); // Cull front faces since we're inside the sphere
-
-        // Move sky sphere to camera position to ensure it always surrounds the viewer
-        Camera *camera = app->getScene()->getActiveCamera();
-        if (camera) {
-            glm::vec3 camPos = camera->getPosition();
-            glTranslatef(camPos.x, camPos.y, camPos.z);
-        }
-
-        // Use bright blue sky color without dimming
-        float baseR = 0.529f, baseG = 0.808f, baseB = 0.922f;
-
-        // Optional: slightly modulate based on sun position for atmosphere effect
-        float sunHeight = std::sin(glm::radians(sunAngleValue));
-        float atmosphereEffect = 0.9f + 0.1f * std::max(0.0f, sunHeight);
-
-        // Set bright sky color
-        glColor3f(
-            baseR * atmosphereEffect,
-            baseG * atmosphereEffect,
-            baseB * atmosphereEffect
-        );
-
-        // Render sky sphere
-        glutSolidSphere(150.0, 50, 50); // Slightly smaller radius to ensure we're well inside
-
-        // Reset culling for sun
-        glCullFace(GL_BACK);
-
-        // Render sun
-        glPushMatrix();
-
-        // Position sun relative to world origin (not camera)
-        // First, undo the camera translation
-        if (camera) {
-            glm::vec3 camPos = camera->getPosition();
-            glTranslatef(-camPos.x, -camPos.y, -camPos.z);
-        }
-
-        float angleRad = glm::radians(sunAngleValue);
-        float sunDistance = 140.0f; // Place sun inside the sky sphere
-        glTranslatef(
-            sunDistance * std::cos(angleRad),
-            sunDistance * std::sin(angleRad),
-            50.0f // Raise sun position for better visibility
-        );
-
-        // Sun color: warm yellow-orange that varies with intensity
-        glColor3f(
-            1.0f * sunIntensityValue,
-            0.95f * sunIntensityValue,
-            0.4f * sunIntensityValue
-        );
-
-        // Render sun as a sphere
-        glutSolidSphere(8.0, 20, 20);
-
-        glPopMatrix();
-
-        // Restore state
-        glDisable(GL_CULL_FACE);
-        glDepthMask(GL_TRUE);
-        glEnable(GL_DEPTH_TEST);
-
-        glPopAttrib();
-        glPopMatrix();
-
-        // Re-enable lighting for subsequent rendering
-        glEnable(GL_LIGHTING);
-    }
-
     void Renderer::setViewport(int x, int y, int width, int height) {
         glViewport(x, y, width, height);
     }
@@ -10,11 +10,37 @@
 
 
 #include <memory>
+#include <vector>
+#include <cstdint>
 #include "utils/Math.h"
+#include "graphics/Frustum.h"
+#include "graphics/RenderQueue.h"
+#include "graphics/SkyPass.h"
 
 namespace CowGL {
     class Scene;
     class Camera;
+    class StaticBatch;
+    class InstanceRenderer;
+    class GameObject;
+    struct FrameContext;
+    struct LightingState;
+
+    // Per-frame visibility counters, reset by every renderScene
+    struct RenderStats {
+        size_t objectsTested = 0;
+        size_t objectsCulled = 0;
+        size_t objectsDrawn = 0;
+
+        // Triangles of LOD-managed objects at full detail and as actually drawn
+        size_t trianglesFullDetail = 0;
+        size_t trianglesDrawn = 0;
+
+        // Material changes of the queued packets, in scene order and after sorting
+        size_t drawPackets = 0;
+        size_t materialSwitchesUnsorted = 0;
+        size_t materialSwitches = 0;
+    };
 
     class Renderer {
     public:
@@ -28,7 +54,8 @@ namespace CowGL {
 
         void endFrame();
 
-        void renderScene(Scene *scene);
+        // Draws the scene from the context's camera, lit by the context's lighting
+        void renderScene(Scene *scene, const FrameContext &context);
 
         void renderUI();
 
@@ -38,15 +65,45 @@ namespace CowGL {
 
         void setupViewport(int windowWidth, int windowHeight);
 
+        const StaticBatch &getStaticBatch() const { return *m_staticBatch; }
+
+        const RenderStats &getStats() const { return m_stats; }
+
 
     private:
-        void setupLighting(Scene *scene);
+        void setupLighting(const LightingState &lighting);
+
+        void updateStaticGeometry(Scene *scene);
+
+        void renderInstances(float globalAmbient, float sunIntensity);
 
-        void renderSkybox();
+        // True for objects drawn by the static batch or an instance renderer
+        static bool isDrawnInBatch(const GameObject &object);
+
+        // Sphere test first, the tighter box test only for spheres crossing a plane
+        bool isVisible(const GameObject &object);
 
 
         glm::mat4 m_viewMatrix;
         glm::mat4 m_projectionMatrix;
+
+        // View frustum of the active camera, valid while m_hasFrustum is set
+        Frustum m_frustum;
+        bool m_hasFrustum;
+        glm::vec3 m_cameraPosition;
+        float m_cameraFov;
+        RenderStats m_stats;
+
+        SkyPass m_skyPass;
+
+        // Draw packets of the static batch and every queue-capable object, rebuilt each frame
+        RenderQueue m_queue;
+
+        // Every static object of the scene, baked per material or gathered per instanced model
+        std::unique_ptr<StaticBatch> m_staticBatch;
+        std::vector<InstanceRenderer *> m_instanceRenderers;
+        const Scene *m_staticBatchScene;
+        uint64_t m_staticBatchRevision;
     };
 } // namespace CowGL
 
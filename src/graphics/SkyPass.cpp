@@ -0,0 +1,128 @@
+//==============================================================================
+// File: graphics/SkyPass.cpp
+// Purpose: Sky pass implementation
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "graphics/SkyPass.h"
+#include "graphics/Camera.h"
+#include "utils/OpenGL.h"
+
+namespace CowGL {
+    namespace {
+        const int DOME_SLICES = 16;
+        const int DOME_STACKS = 8;
+        const float DOME_RADIUS = 100.0f; // Anywhere between the near and far planes will do
+
+        const int SUN_SEGMENTS = 16;
+        const float SUN_RADIUS = 8.0f;
+        const float SUN_DISTANCE = 140.0f;
+        const float SUN_HEIGHT = 50.0f;
+
+        const glm::vec3 SKY_BLUE(0.529f, 0.808f, 0.922f);
+    }
+
+    SkyPass::SkyPass()
+        : m_cachedSunAngle(0.0f)
+          , m_cachedSunIntensity(0.0f)
+          , m_colorsValid(false) {
+        buildDome();
+        m_sunPositions.resize(SUN_SEGMENTS + 2);
+    }
+
+    void SkyPass::buildDome() {
+        for (int stack = 0; stack <= DOME_STACKS; ++stack) {
+            float phi = static_cast<float>(M_PI) * stack / DOME_STACKS;
+            for (int slice = 0; slice <= DOME_SLICES; ++slice) {
+                float theta = 2.0f * static_cast<float>(M_PI) * slice / DOME_SLICES;
+                m_domePositions.emplace_back(std::sin(phi) * std::cos(theta),
+                                             std::sin(phi) * std::sin(theta),
+                                             std::cos(phi));
+            }
+        }
+
+        const int row = DOME_SLICES + 1;
+        for (int stack = 0; stack < DOME_STACKS; ++stack) {
+            for (int slice = 0; slice < DOME_SLICES; ++slice) {
+                uint16_t a = static_cast<uint16_t>(stack * row + slice);
+                uint16_t b = static_cast<uint16_t>(a + row);
+                m_domeIndices.insert(m_domeIndices.end(), {a, b, static_cast<uint16_t>(a + 1)});
+                m_domeIndices.insert(m_domeIndices.end(), {static_cast<uint16_t>(a + 1), b, static_cast<uint16_t>(b + 1)});
+            }
+        }
+
+        m_domeColors.resize(m_domePositions.size());
+    }
+
+    void SkyPass::updateColors(float sunAngle, float sunIntensity) {
+        if (m_colorsValid && sunAngle == m_cachedSunAngle && sunIntensity == m_cachedSunIntensity) {
+            return;
+        }
+
+        // Slightly brighter while the sun is up, paler towards the horizon
+        float sunHeight = std::sin(glm::radians(sunAngle));
+        float atmosphereEffect = 0.9f + 0.1f * std::max(0.0f, sunHeight);
+        glm::vec3 zenith = SKY_BLUE * atmosphereEffect;
+        glm::vec3 horizon = zenith + (glm::vec3(1.0f) - zenith) * 0.2f;
+
+        for (size_t i = 0; i < m_domePositions.size(); ++i) {
+            float t = std::sqrt(std::max(0.0f, m_domePositions[i].z));
+            m_domeColors[i] = horizon + (zenith - horizon) * t;
+        }
+
+        // Warm yellow-orange that varies with intensity
+        m_sunColor = glm::vec3(1.0f, 0.95f, 0.4f) * sunIntensity;
+
+        m_cachedSunAngle = sunAngle;
+        m_cachedSunIntensity = sunIntensity;
+        m_colorsValid = true;
+    }
+
+    void SkyPass::draw(const Camera &camera, float sunAngle, float sunIntensity) {
+        updateColors(sunAngle, sunIntensity);
+
+        glm::vec3 eye = camera.getRenderPosition();
+
+        // Sun disc facing the camera, at a fixed place in the world
+        float angleRad = glm::radians(sunAngle);
+        glm::vec3 sunCenter(SUN_DISTANCE * std::cos(angleRad), SUN_DISTANCE * std::sin(angleRad), SUN_HEIGHT);
+        glm::vec3 toCamera = (eye - sunCenter).normalized();
+        glm::vec3 right = glm::vec3::cross(camera.getUp(), toCamera).normalized();
+        if (right.length() == 0.0f) right = glm::vec3(1.0f, 0.0f, 0.0f);
+        glm::vec3 up = glm::vec3::cross(toCamera, right);
+
+        m_sunPositions[0] = sunCenter;
+        for (int i = 0; i <= SUN_SEGMENTS; ++i) {
+            float theta = 2.0f * static_cast<float>(M_PI) * i / SUN_SEGMENTS;
+            m_sunPositions[i + 1] = sunCenter + (right * std::cos(theta) + up * std::sin(theta)) * SUN_RADIUS;
+        }
+
+        // Nothing in the sky pass writes or tests depth, and it is all unlit
+        glDisable(GL_DEPTH_TEST);
+        glDepthMask(GL_FALSE);
+        glDisable(GL_LIGHTING);
+
+        glEnableClientState(GL_VERTEX_ARRAY);
+
+        glPushMatrix();
+        glTranslatef(eye.x, eye.y, eye.z);
+        glScalef(DOME_RADIUS, DOME_RADIUS, DOME_RADIUS);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(3, GL_FLOAT, sizeof(glm::vec3), m_domePositions.data());
+        glColorPointer(3, GL_FLOAT, sizeof(glm::vec3), m_domeColors.data());
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_domeIndices.size()), GL_UNSIGNED_SHORT,
+                       m_domeIndices.data());
+        glDisableClientState(GL_COLOR_ARRAY);
+        glPopMatrix();
+
+        glColor3f(m_sunColor.x, m_sunColor.y, m_sunColor.z);
+        glVertexPointer(3, GL_FLOAT, sizeof(glm::vec3), m_sunPositions.data());
+        glDrawArrays(GL_TRIANGLE_FAN, 0, static_cast<GLsizei>(m_sunPositions.size()));
+
+        glDisableClientState(GL_VERTEX_ARRAY);
+
+        glDepthMask(GL_TRUE);
+        glEnable(GL_DEPTH_TEST);
+        glEnable(GL_LIGHTING);
+    }
+} // namespace CowGL
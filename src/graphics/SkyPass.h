@@ -0,0 +1,50 @@
+//==============================================================================
+// File: graphics/SkyPass.h
+// Purpose: Gradient sky dome and billboarded sun, drawn before the scene
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef SKYPASS_H
+#define SKYPASS_H
+
+
+#include <vector>
+#include <cstdint>
+#include "utils/Math.h"
+
+namespace CowGL {
+    class Camera;
+
+    class SkyPass {
+    public:
+        SkyPass();
+
+        // Draws behind everything and leaves depth testing and lighting enabled.
+        // Colours are only recomputed when the sun angle or intensity changes.
+        void draw(const Camera &camera, float sunAngle, float sunIntensity);
+
+        // Fixed per-frame vertex cost, independent of any tessellation setting
+        size_t getVertexCount() const { return m_domePositions.size() + m_sunPositions.size(); }
+
+    private:
+        void buildDome();
+
+        void updateColors(float sunAngle, float sunIntensity);
+
+        // Low-poly unit sphere around the camera, coloured by elevation
+        std::vector<glm::vec3> m_domePositions;
+        std::vector<glm::vec3> m_domeColors;
+        std::vector<uint16_t> m_domeIndices;
+
+        // Sun disc as a triangle fan, rebuilt facing the camera each frame
+        std::vector<glm::vec3> m_sunPositions;
+        glm::vec3 m_sunColor;
+
+        float m_cachedSunAngle;
+        float m_cachedSunIntensity;
+        bool m_colorsValid;
+    };
+} // namespace CowGL
+
+
+#endif //SKYPASS_H
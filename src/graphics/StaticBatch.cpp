@@ -0,0 +1,78 @@
+//==============================================================================
+// File: graphics/StaticBatch.cpp
+// Purpose: Static geometry baking and drawing
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "graphics/StaticBatch.h"
+#include "graphics/RenderQueue.h"
+#include "scene/GameObject.h"
+#include "utils/OpenGL.h"
+
+namespace CowGL {
+    StaticBatch::~StaticBatch() = default;
+
+    void StaticBatch::build(const std::vector<std::shared_ptr<GameObject> > &objects) {
+        GeometryBuilder builder;
+        size_t objectCount = 0;
+
+        for (const auto &obj: objects) {
+            if (!obj->isActive() || !obj->isStatic() || !obj->hasStaticGeometry()) {
+                continue;
+            }
+
+            builder.loadMatrix(obj->getTransform().getWorldMatrix());
+            obj->buildStaticGeometry(builder);
+            ++objectCount;
+        }
+
+        build(builder);
+        m_objectCount = objectCount;
+    }
+
+    void StaticBatch::build(const GeometryBuilder &builder) {
+        clear();
+
+        for (const auto &bucket: builder.getBuckets()) {
+            if (bucket.indices.empty()) continue;
+
+            Part part;
+            part.material = Materials::intern(bucket.material);
+            part.mesh = std::make_unique<Mesh>(bucket.vertices, bucket.indices);
+            m_parts.push_back(std::move(part));
+        }
+        m_objectCount = 1;
+    }
+
+    void StaticBatch::clear() {
+        m_parts.clear();
+        m_objectCount = 0;
+    }
+
+    void StaticBatch::draw(float globalAmbient, float sunIntensity) const {
+        if (m_parts.empty()) return;
+
+        glEnable(GL_LIGHTING);
+
+        for (const Part &part: m_parts) {
+            Materials::get(part.material).apply(globalAmbient, sunIntensity);
+            part.mesh->draw();
+        }
+
+        glDisable(GL_LIGHTING);
+    }
+
+    void StaticBatch::enqueue(RenderQueue &queue) const {
+        for (const Part &part: m_parts) {
+            queue.submit(RenderPass::Opaque, part.material, *part.mesh, glm::mat4());
+        }
+    }
+
+    size_t StaticBatch::getTriangleCount() const {
+        size_t triangles = 0;
+        for (const Part &part: m_parts) {
+            triangles += part.mesh->getTriangleCount();
+        }
+        return triangles;
+    }
+} // namespace CowGL
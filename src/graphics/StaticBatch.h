@@ -0,0 +1,61 @@
+//==============================================================================
+// File: graphics/StaticBatch.h
+// Purpose: Non-moving geometry merged into one buffer per material
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef STATICBATCH_H
+#define STATICBATCH_H
+
+
+#include <vector>
+#include <memory>
+#include "graphics/GeometryBuilder.h"
+
+namespace CowGL {
+    class GameObject;
+    class RenderQueue;
+
+    class StaticBatch {
+    public:
+        StaticBatch() = default;
+
+        ~StaticBatch();
+
+        // Bakes every active static object that provides geometry, with its world
+        // transform pre-applied. Baked objects must not move or change their
+        // active state; add or remove them through the Scene instead.
+        void build(const std::vector<std::shared_ptr<GameObject> > &objects);
+
+        // Uploads whatever was recorded into the builder as it is
+        void build(const GeometryBuilder &builder);
+
+        void clear();
+
+        // Lighting values feed the materials that react to the lighting menu
+        void draw(float globalAmbient, float sunIntensity) const;
+
+        // One packet per material, already in world space
+        void enqueue(RenderQueue &queue) const;
+
+        bool isEmpty() const { return m_parts.empty(); }
+
+        size_t getDrawCallCount() const { return m_parts.size(); }
+
+        size_t getTriangleCount() const;
+
+        size_t getObjectCount() const { return m_objectCount; }
+
+    private:
+        struct Part {
+            MaterialId material;
+            std::unique_ptr<Mesh> mesh;
+        };
+
+        std::vector<Part> m_parts;
+        size_t m_objectCount = 0;
+    };
+} // namespace CowGL
+
+
+#endif //STATICBATCH_H
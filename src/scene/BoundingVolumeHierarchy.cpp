@@ -0,0 +1,491 @@
+//==============================================================================
+// File: scene/BoundingVolumeHierarchy.cpp
+// Purpose: Box tree for ray and swept-sphere queries against many boxes
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "scene/BoundingVolumeHierarchy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace CowGL {
+    namespace {
+        // Candidate split planes per axis, evenly spaced over the boxes' centres
+        const int SAH_BINS = 12;
+
+        // Cost of visiting a node, relative to testing one box
+        const float TRAVERSAL_COST = 1.0f;
+
+        const float INFINITY_F = std::numeric_limits<float>::infinity();
+
+        // Half the surface area of a box, which is what the heuristic compares
+        float halfArea(const float min[3], const float max[3]) {
+            float dx = max[0] - min[0];
+            float dy = max[1] - min[1];
+            float dz = max[2] - min[2];
+            return dx * dy + dy * dz + dz * dx;
+        }
+
+        void emptyBox(float min[3], float max[3]) {
+            for (int axis = 0; axis < 3; ++axis) {
+                min[axis] = INFINITY_F;
+                max[axis] = -INFINITY_F;
+            }
+        }
+
+        void growBox(float min[3], float max[3], const float otherMin[3], const float otherMax[3]) {
+            for (int axis = 0; axis < 3; ++axis) {
+                min[axis] = std::min(min[axis], otherMin[axis]);
+                max[axis] = std::max(max[axis], otherMax[axis]);
+            }
+        }
+
+        // A segment from origin along delta, with what the slab tests need of it
+        struct Segment {
+            float origin[3];
+            float inverse[3];
+            bool parallel[3];
+            float radius;
+        };
+
+        Segment makeSegment(const glm::vec3 &from, const glm::vec3 &to, float radius) {
+            Segment segment;
+            const float delta[3] = {to.x - from.x, to.y - from.y, to.z - from.z};
+            const float origin[3] = {from.x, from.y, from.z};
+            for (int axis = 0; axis < 3; ++axis) {
+                segment.origin[axis] = origin[axis];
+                segment.parallel[axis] = std::fabs(delta[axis]) < 1.0e-12f;
+                segment.inverse[axis] = segment.parallel[axis] ? 0.0f : 1.0f / delta[axis];
+            }
+            segment.radius = radius;
+            return segment;
+        }
+
+        // Outward normal of the face crossed on the axis; it was never a parallel one
+        glm::vec3 faceNormal(const Segment &segment, int axis) {
+            float normal[3] = {0.0f, 0.0f, 0.0f};
+            normal[axis] = segment.inverse[axis] > 0.0f ? -1.0f : 1.0f;
+            return glm::vec3(normal[0], normal[1], normal[2]);
+        }
+
+        // Clips the segment to the box grown by its radius. Returns false when they
+        // do not meet within [start, end]; otherwise start and end are narrowed to
+        // the part inside and axis is the face entered last, or -1 if none was crossed.
+        bool clip(const Segment &segment, const float min[3], const float max[3], float &start, float &end,
+                  int &axis) {
+            axis = -1;
+            for (int i = 0; i < 3; ++i) {
+                float low = min[i] - segment.radius;
+                float high = max[i] + segment.radius;
+                if (segment.parallel[i]) {
+                    if (segment.origin[i] < low || segment.origin[i] > high) return false;
+                    continue;
+                }
+
+                float t0 = (low - segment.origin[i]) * segment.inverse[i];
+                float t1 = (high - segment.origin[i]) * segment.inverse[i];
+                if (t0 > t1) std::swap(t0, t1);
+                if (t0 > start) {
+                    start = t0;
+                    axis = i;
+                }
+                end = std::min(end, t1);
+                if (start > end) return false;
+            }
+            return true;
+        }
+
+        // Nodes only need to know whether, and from where, the segment crosses them
+        bool reaches(const Segment &segment, const float min[3], const float max[3], float limit, float &start) {
+            float from = 0.0f;
+            float to = limit;
+            for (int i = 0; i < 3; ++i) {
+                float low = min[i] - segment.radius;
+                float high = max[i] + segment.radius;
+                if (segment.parallel[i]) {
+                    if (segment.origin[i] < low || segment.origin[i] > high) return false;
+                    continue;
+                }
+
+                float t0 = (low - segment.origin[i]) * segment.inverse[i];
+                float t1 = (high - segment.origin[i]) * segment.inverse[i];
+                from = std::max(from, std::min(t0, t1));
+                to = std::min(to, std::max(t0, t1));
+            }
+            start = from;
+            return from <= to;
+        }
+
+        // How far the box must grow on every side to reach the point; sweepSphere
+        // grows boxes the same way, so a sphere this far off can move this far freely
+        float gap(const float point[3], const float min[3], const float max[3]) {
+            float widest = 0.0f;
+            for (int i = 0; i < 3; ++i) {
+                widest = std::max({widest, min[i] - point[i], point[i] - max[i]});
+            }
+            return widest;
+        }
+
+        // A node put off for later, with how close the query gets to it
+        struct Deferred {
+            uint32_t node;
+            float start;
+        };
+    }
+
+    void BoundingVolumeHierarchy::build(const std::vector<Bounds> &boxes) {
+        m_nodes.clear();
+        m_boxes.clear();
+        m_ids.clear();
+        m_positions.assign(boxes.size(), 0);
+        if (boxes.empty()) return;
+
+        m_boxes.reserve(boxes.size());
+        m_ids.reserve(boxes.size());
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            const Bounds &bounds = boxes[i];
+            m_boxes.push_back(Box{{bounds.min.x, bounds.min.y, bounds.min.z},
+                                  {bounds.max.x, bounds.max.y, bounds.max.z}});
+            m_ids.push_back(static_cast<uint32_t>(i));
+        }
+
+        // A tree over n boxes never has more than 2n - 1 nodes
+        m_nodes.reserve(boxes.size() * 2);
+        Node root;
+        root.first = 0;
+        root.count = static_cast<uint32_t>(boxes.size());
+        fitNode(root);
+        m_nodes.push_back(root);
+
+        std::vector<std::pair<uint32_t, int> > pending = {{0, 0}};
+        while (!pending.empty()) {
+            std::pair<uint32_t, int> next = pending.back();
+            pending.pop_back();
+            if (next.second >= MAX_DEPTH || !splitNode(next.first)) continue;
+
+            uint32_t left = m_nodes[next.first].first;
+            pending.emplace_back(left, next.second + 1);
+            pending.emplace_back(left + 1, next.second + 1);
+        }
+
+        for (size_t i = 0; i < m_ids.size(); ++i) {
+            m_positions[m_ids[i]] = static_cast<uint32_t>(i);
+        }
+    }
+
+    void BoundingVolumeHierarchy::fitNode(Node &node) const {
+        emptyBox(node.min, node.max);
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            growBox(node.min, node.max, m_boxes[i].min, m_boxes[i].max);
+        }
+    }
+
+    bool BoundingVolumeHierarchy::splitNode(uint32_t nodeIndex) {
+        Node node = m_nodes[nodeIndex];
+        if (node.count <= MAX_LEAF_SIZE) return false;
+
+        // Bins are laid over the spread of the centres; centres are kept doubled
+        float centerMin[3];
+        float centerMax[3];
+        emptyBox(centerMin, centerMax);
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            float center[3];
+            for (int axis = 0; axis < 3; ++axis) {
+                center[axis] = m_boxes[i].min[axis] + m_boxes[i].max[axis];
+            }
+            growBox(centerMin, centerMax, center, center);
+        }
+
+        int bestAxis = -1;
+        int bestSplit = 0;
+        float bestCost = INFINITY_F;
+        for (int axis = 0; axis < 3; ++axis) {
+            float extent = centerMax[axis] - centerMin[axis];
+            if (extent <= 0.0f) continue;
+
+            uint32_t counts[SAH_BINS] = {};
+            Box bins[SAH_BINS];
+            for (Box &bin: bins) {
+                emptyBox(bin.min, bin.max);
+            }
+
+            float scale = SAH_BINS / extent;
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                const Box &box = m_boxes[i];
+                int bin = std::min(SAH_BINS - 1,
+                                   static_cast<int>((box.min[axis] + box.max[axis] - centerMin[axis]) * scale));
+                ++counts[bin];
+                growBox(bins[bin].min, bins[bin].max, box.min, box.max);
+            }
+
+            // Sweep from the right to get the area and count beyond each plane,
+            // then from the left pricing each plane
+            float rightArea[SAH_BINS];
+            uint32_t rightCount[SAH_BINS];
+            Box right;
+            emptyBox(right.min, right.max);
+            uint32_t count = 0;
+            for (int bin = SAH_BINS - 1; bin > 0; --bin) {
+                growBox(right.min, right.max, bins[bin].min, bins[bin].max);
+                count += counts[bin];
+                rightArea[bin] = count ? halfArea(right.min, right.max) : 0.0f;
+                rightCount[bin] = count;
+            }
+
+            Box left;
+            emptyBox(left.min, left.max);
+            count = 0;
+            for (int split = 1; split < SAH_BINS; ++split) {
+                growBox(left.min, left.max, bins[split - 1].min, bins[split - 1].max);
+                count += counts[split - 1];
+                if (count == 0 || rightCount[split] == 0) continue;
+
+                float cost = halfArea(left.min, left.max) * count + rightArea[split] * rightCount[split];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = split;
+                }
+            }
+        }
+
+        // Every centre in one spot: no plane separates them
+        if (bestAxis < 0) return false;
+
+        float nodeArea = halfArea(node.min, node.max);
+        float splitCost = TRAVERSAL_COST + (nodeArea > 0.0f ? bestCost / nodeArea : 0.0f);
+        if (splitCost >= static_cast<float>(node.count) && node.count <= MAX_LEAF_SIZE * 4) return false;
+
+        // Boxes left of the plane to the front
+        float scale = SAH_BINS / (centerMax[bestAxis] - centerMin[bestAxis]);
+        uint32_t middle = node.first;
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            const Box &box = m_boxes[i];
+            int bin = std::min(SAH_BINS - 1,
+                               static_cast<int>((box.min[bestAxis] + box.max[bestAxis] - centerMin[bestAxis]) * scale));
+            if (bin < bestSplit) {
+                std::swap(m_boxes[i], m_boxes[middle]);
+                std::swap(m_ids[i], m_ids[middle]);
+                ++middle;
+            }
+        }
+
+        uint32_t leftCount = middle - node.first;
+        if (leftCount == 0 || leftCount == node.count) return false;
+
+        Node left;
+        left.first = node.first;
+        left.count = leftCount;
+        fitNode(left);
+
+        Node right;
+        right.first = middle;
+        right.count = node.count - leftCount;
+        fitNode(right);
+
+        m_nodes[nodeIndex].first = static_cast<uint32_t>(m_nodes.size());
+        m_nodes[nodeIndex].count = 0;
+        m_nodes.push_back(left);
+        m_nodes.push_back(right);
+        return true;
+    }
+
+    void BoundingVolumeHierarchy::setBounds(uint32_t id, const Bounds &box) {
+        Box &stored = m_boxes[m_positions[id]];
+        stored = Box{{box.min.x, box.min.y, box.min.z}, {box.max.x, box.max.y, box.max.z}};
+    }
+
+    void BoundingVolumeHierarchy::refit() {
+        for (size_t i = m_nodes.size(); i > 0; --i) {
+            Node &node = m_nodes[i - 1];
+            if (node.count > 0) {
+                fitNode(node);
+                continue;
+            }
+
+            const Node &left = m_nodes[node.first];
+            const Node &right = m_nodes[node.first + 1];
+            std::copy(left.min, left.min + 3, node.min);
+            std::copy(left.max, left.max + 3, node.max);
+            growBox(node.min, node.max, right.min, right.max);
+        }
+    }
+
+    bool BoundingVolumeHierarchy::sweepSphere(const glm::vec3 &from, const glm::vec3 &to, float radius,
+                                              Hit &hit) const {
+        if (m_nodes.empty()) return false;
+
+        Segment segment = makeSegment(from, to, radius);
+
+        float best = 1.0f;
+        int bestAxis = -1;
+        uint32_t bestBox = UINT32_MAX;
+
+        // Depth-first into the nearer child, keeping the farther one with where the
+        // segment enters it, so it is dropped if a nearer hit turns up first
+        float start;
+        if (!reaches(segment, m_nodes[0].min, m_nodes[0].max, best, start)) return false;
+
+        Deferred stack[MAX_DEPTH + 4];
+        int top = 0;
+        uint32_t current = 0;
+        while (true) {
+            const Node &node = m_nodes[current];
+            if (node.count == 0) {
+                float leftStart;
+                float rightStart;
+                bool hitsLeft = reaches(segment, m_nodes[node.first].min, m_nodes[node.first].max, best, leftStart);
+                bool hitsRight = reaches(segment, m_nodes[node.first + 1].min, m_nodes[node.first + 1].max, best,
+                                         rightStart);
+
+                if (hitsLeft && hitsRight) {
+                    bool leftFirst = leftStart <= rightStart;
+                    stack[top++] = leftFirst ? Deferred{node.first + 1, rightStart} : Deferred{node.first, leftStart};
+                    current = leftFirst ? node.first : node.first + 1;
+                    continue;
+                }
+                if (hitsLeft || hitsRight) {
+                    current = hitsLeft ? node.first : node.first + 1;
+                    continue;
+                }
+            } else {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                    int axis;
+                    float boxStart = -INFINITY_F;
+                    float boxEnd = INFINITY_F;
+                    if (!clip(segment, m_boxes[i].min, m_boxes[i].max, boxStart, boxEnd, axis)) continue;
+
+                    // Entered within the segment, ahead of the best hit; starting inside does not count
+                    if (axis < 0 || boxStart < 0.0f || boxStart >= best) continue;
+                    best = boxStart;
+                    bestAxis = axis;
+                    bestBox = i;
+                }
+            }
+
+            // Next deferred node the segment reaches before the best hit
+            while (top > 0 && stack[top - 1].start >= best) {
+                --top;
+            }
+            if (top == 0) break;
+            current = stack[--top].node;
+        }
+
+        if (bestBox == UINT32_MAX) return false;
+
+        hit.fraction = best;
+        hit.id = m_ids[bestBox];
+        hit.normal = faceNormal(segment, bestAxis);
+        return true;
+    }
+
+    bool BoundingVolumeHierarchy::sweepSphere(const glm::vec3 &from, const glm::vec3 &to, float radius,
+                                              const std::vector<uint32_t> &ids, Hit &hit) const {
+        Segment segment = makeSegment(from, to, radius);
+        float best = 1.0f;
+        int bestAxis = -1;
+        uint32_t bestId = UINT32_MAX;
+        for (uint32_t id: ids) {
+            const Box &box = m_boxes[m_positions[id]];
+            int axis;
+            float boxStart = -INFINITY_F;
+            float boxEnd = INFINITY_F;
+            if (!clip(segment, box.min, box.max, boxStart, boxEnd, axis)) continue;
+
+            if (axis < 0 || boxStart < 0.0f || boxStart >= best) continue;
+            best = boxStart;
+            bestAxis = axis;
+            bestId = id;
+        }
+
+        if (bestId == UINT32_MAX) return false;
+
+        hit.fraction = best;
+        hit.id = bestId;
+        hit.normal = faceNormal(segment, bestAxis);
+        return true;
+    }
+
+    void BoundingVolumeHierarchy::overlap(const glm::vec3 &min, const glm::vec3 &max,
+                                          std::vector<uint32_t> &ids) const {
+        if (m_nodes.empty()) return;
+
+        const float low[3] = {min.x, min.y, min.z};
+        const float high[3] = {max.x, max.y, max.z};
+        auto overlaps = [&low, &high](const float boxMin[3], const float boxMax[3]) {
+            return boxMin[0] <= high[0] && boxMax[0] >= low[0] &&
+                   boxMin[1] <= high[1] && boxMax[1] >= low[1] &&
+                   boxMin[2] <= high[2] && boxMax[2] >= low[2];
+        };
+        if (!overlaps(m_nodes[0].min, m_nodes[0].max)) return;
+
+        // Each level leaves at most one sibling waiting, so the stack stays within the depth
+        uint32_t stack[MAX_DEPTH + 4];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node &node = m_nodes[stack[--top]];
+            if (node.count > 0) {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                    if (overlaps(m_boxes[i].min, m_boxes[i].max)) {
+                        ids.push_back(m_ids[i]);
+                    }
+                }
+                continue;
+            }
+
+            if (overlaps(m_nodes[node.first + 1].min, m_nodes[node.first + 1].max)) {
+                stack[top++] = node.first + 1;
+            }
+            if (overlaps(m_nodes[node.first].min, m_nodes[node.first].max)) {
+                stack[top++] = node.first;
+            }
+        }
+    }
+
+    float BoundingVolumeHierarchy::distance(const glm::vec3 &point, float limit) const {
+        if (m_nodes.empty()) return limit;
+
+        // The same walk as sweepSphere, ordered by gap
+        const float position[3] = {point.x, point.y, point.z};
+        float best = limit;
+        if (gap(position, m_nodes[0].min, m_nodes[0].max) >= best) return limit;
+
+        Deferred stack[MAX_DEPTH + 4];
+        int top = 0;
+        uint32_t current = 0;
+        while (true) {
+            const Node &node = m_nodes[current];
+            if (node.count == 0) {
+                float left = gap(position, m_nodes[node.first].min, m_nodes[node.first].max);
+                float right = gap(position, m_nodes[node.first + 1].min, m_nodes[node.first + 1].max);
+                bool leftFirst = left <= right;
+                float nearer = leftFirst ? left : right;
+                float farther = leftFirst ? right : left;
+
+                if (nearer < best) {
+                    if (farther < best) {
+                        stack[top++] = leftFirst ? Deferred{node.first + 1, right} : Deferred{node.first, left};
+                    }
+                    current = leftFirst ? node.first : node.first + 1;
+                    continue;
+                }
+            } else {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                    best = std::min(best, gap(position, m_boxes[i].min, m_boxes[i].max));
+                }
+            }
+
+            while (top > 0 && stack[top - 1].start >= best) {
+                --top;
+            }
+            if (top == 0) break;
+            current = stack[--top].node;
+        }
+
+        return best;
+    }
+} // namespace CowGL
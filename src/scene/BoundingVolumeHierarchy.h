@@ -0,0 +1,111 @@
+//==============================================================================
+// File: scene/BoundingVolumeHierarchy.h
+// Purpose: Box tree for ray and swept-sphere queries against many boxes
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef BOUNDINGVOLUMEHIERARCHY_H
+#define BOUNDINGVOLUMEHIERARCHY_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "scene/Bounds.h"
+
+namespace CowGL {
+    // A binary tree of axis-aligned boxes over a fixed set of boxes, split by the
+    // surface area heuristic when built. Boxes that move keep their place in the
+    // tree: set their new bounds and refit, which only grows or shrinks the
+    // nodes above them. Rebuild once the tree has been refit far out of shape.
+    class BoundingVolumeHierarchy {
+    public:
+        // Where a query segment first touches a box
+        struct Hit {
+            // Along the segment, from 0 at its start to 1 at its end
+            float fraction = 1.0f;
+
+            // Outward normal of the face touched
+            glm::vec3 normal;
+
+            // Index of the box in the list the tree was built from
+            uint32_t id = UINT32_MAX;
+        };
+
+        // Replaces the tree with one over the boxes; a box's id is its index
+        void build(const std::vector<Bounds> &boxes);
+
+        // Takes effect on the next refit
+        void setBounds(uint32_t id, const Bounds &box);
+
+        // Fits every node around its children again
+        void refit();
+
+        // First box the segment enters; boxes it starts inside are ignored
+        bool raycast(const glm::vec3 &from, const glm::vec3 &to, Hit &hit) const {
+            return sweepSphere(from, to, 0.0f, hit);
+        }
+
+        // First box a sphere moving along the segment touches, with the boxes grown
+        // by the radius, which treats their edges and corners as square. Boxes the
+        // sphere starts in are ignored, so it can always move out of them.
+        bool sweepSphere(const glm::vec3 &from, const glm::vec3 &to, float radius, Hit &hit) const;
+
+        // The same sweep against just the boxes of these ids, for repeated sweeps
+        // in one small region
+        bool sweepSphere(const glm::vec3 &from, const glm::vec3 &to, float radius, const std::vector<uint32_t> &ids,
+                         Hit &hit) const;
+
+        // Appends the ids of the boxes overlapping the region
+        void overlap(const glm::vec3 &min, const glm::vec3 &max, std::vector<uint32_t> &ids) const;
+
+        // How far the nearest box must grow on every side to reach the point, the
+        // way sweepSphere grows them; 0 inside one, limit when none is nearer
+        float distance(const glm::vec3 &point, float limit) const;
+
+        size_t size() const { return m_ids.size(); }
+
+        size_t getNodeCount() const { return m_nodes.size(); }
+
+    private:
+        // An inner node's children sit side by side at first; a leaf holds count
+        // boxes from first on. Children always come after their parent.
+        struct Node {
+            float min[3];
+            uint32_t first;
+            float max[3];
+            uint32_t count;
+        };
+
+        struct Box {
+            float min[3];
+            float max[3];
+        };
+
+        // Leaves with this many boxes or fewer are never split, and leaves with
+        // more than MAX_LEAF_SIZE * 4 always are, whatever the heuristic says
+        static const uint32_t MAX_LEAF_SIZE = 4;
+
+        // Deep enough for any balanced tree; deeper splits become leaves
+        static const int MAX_DEPTH = 60;
+
+        // Fits the node around the boxes it covers
+        void fitNode(Node &node) const;
+
+        // Splits the node at the cheapest of a few candidate planes per axis,
+        // unless keeping it a leaf is cheaper
+        bool splitNode(uint32_t nodeIndex);
+
+        std::vector<Node> m_nodes;
+
+        // Boxes and their ids in leaf order, so a leaf's boxes are adjacent
+        std::vector<Box> m_boxes;
+        std::vector<uint32_t> m_ids;
+
+        // Position of each id in m_boxes
+        std::vector<uint32_t> m_positions;
+    };
+} // namespace CowGL
+
+
+#endif //BOUNDINGVOLUMEHIERARCHY_H
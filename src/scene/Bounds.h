@@ -0,0 +1,62 @@
+//==============================================================================
+// File: scene/Bounds.h
+// Purpose: Bounding volumes for visibility and proximity tests
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+
+#include "utils/Math.h"
+
+namespace CowGL {
+    // Axis-aligned box plus the sphere that encloses it
+    struct Bounds {
+        glm::vec3 min;
+        glm::vec3 max;
+        glm::vec3 center;
+        float radius = 0.0f;
+
+        Bounds() = default;
+
+        Bounds(const glm::vec3 &boxMin, const glm::vec3 &boxMax)
+            : min(boxMin), max(boxMax) {
+            center = (min + max) * 0.5f;
+            radius = (max - center).length();
+        }
+
+        // World-space bounds: the box is re-fitted around the transformed box
+        // (Arvo's method) and the sphere is scaled by the largest axis scale
+        Bounds transformed(const glm::mat4 &matrix) const {
+            glm::vec3 newMin(matrix.m[12], matrix.m[13], matrix.m[14]);
+            glm::vec3 newMax = newMin;
+            float *outMin[3] = {&newMin.x, &newMin.y, &newMin.z};
+            float *outMax[3] = {&newMax.x, &newMax.y, &newMax.z};
+            const float inMin[3] = {min.x, min.y, min.z};
+            const float inMax[3] = {max.x, max.y, max.z};
+
+            for (int row = 0; row < 3; ++row) {
+                for (int col = 0; col < 3; ++col) {
+                    float a = matrix.m[col * 4 + row] * inMin[col];
+                    float b = matrix.m[col * 4 + row] * inMax[col];
+                    *outMin[row] += std::min(a, b);
+                    *outMax[row] += std::max(a, b);
+                }
+            }
+
+            Bounds result(newMin, newMax);
+            float scale = std::max({
+                matrix.transformDirection(glm::vec3(1.0f, 0.0f, 0.0f)).length(),
+                matrix.transformDirection(glm::vec3(0.0f, 1.0f, 0.0f)).length(),
+                matrix.transformDirection(glm::vec3(0.0f, 0.0f, 1.0f)).length()
+            });
+            result.center = matrix.transformPoint(center);
+            result.radius = radius * scale;
+            return result;
+        }
+    };
+} // namespace CowGL
+
+
+#endif //BOUNDS_H
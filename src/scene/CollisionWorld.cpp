@@ -0,0 +1,196 @@
+//==============================================================================
+// File: scene/CollisionWorld.cpp
+// Purpose: Solid objects of a scene, for movement and camera collision queries
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "scene/CollisionWorld.h"
+#include "scene/GameObject.h"
+#include "core/Profiler.h"
+
+#include <algorithm>
+
+namespace CowGL {
+    namespace {
+        // Gap left between a sliding sphere and what it touched, so the next
+        // sweep starts outside it
+        const float SKIN = 0.01f;
+
+        // Slides after the first contact; corners need two
+        const int MAX_SLIDES = 2;
+
+        // Boxes a slide can touch, kept per thread so warm slides allocate nothing
+        thread_local std::vector<uint32_t> t_staticCandidates;
+        thread_local std::vector<uint32_t> t_movingCandidates;
+
+        void buildTree(BoundingVolumeHierarchy &tree, const std::vector<GameObject *> &objects) {
+            std::vector<Bounds> boxes;
+            boxes.reserve(objects.size());
+            for (const GameObject *object: objects) {
+                boxes.push_back(object->getWorldCollisionBounds());
+            }
+            tree.build(boxes);
+        }
+    }
+
+    void CollisionWorld::add(GameObject *object) {
+        if (!object->hasCollision()) return;
+
+        if (object->isStatic()) {
+            m_staticObjects.push_back(object);
+            m_staticDirty = true;
+        } else {
+            m_movingObjects.push_back(object);
+            m_movingDirty = true;
+        }
+    }
+
+    void CollisionWorld::remove(GameObject *object) {
+        if (!object->hasCollision()) return;
+
+        std::vector<GameObject *> &objects = object->isStatic() ? m_staticObjects : m_movingObjects;
+        auto it = std::find(objects.begin(), objects.end(), object);
+        if (it == objects.end()) return;
+
+        objects.erase(it);
+        if (object->isStatic()) {
+            m_staticDirty = true;
+        } else {
+            m_movingDirty = true;
+        }
+    }
+
+    void CollisionWorld::update() {
+        COWGL_PROFILE_SCOPE("Collision world");
+        if (m_staticDirty) {
+            buildTree(m_staticTree, m_staticObjects);
+            m_staticDirty = false;
+            ++m_revision;
+        }
+
+        if (m_movingDirty) {
+            buildTree(m_movingTree, m_movingObjects);
+            m_movingRevisions.resize(m_movingObjects.size());
+            for (size_t i = 0; i < m_movingObjects.size(); ++i) {
+                m_movingRevisions[i] = m_movingObjects[i]->getTransform().getRevision();
+            }
+            m_movingDirty = false;
+            return;
+        }
+
+        bool moved = false;
+        for (size_t i = 0; i < m_movingObjects.size(); ++i) {
+            const GameObject *object = m_movingObjects[i];
+            uint32_t revision = object->getTransform().getRevision();
+            if (revision == m_movingRevisions[i]) continue;
+
+            m_movingRevisions[i] = revision;
+            m_movingTree.setBounds(static_cast<uint32_t>(i), object->getWorldCollisionBounds());
+            moved = true;
+        }
+        if (moved) {
+            m_movingTree.refit();
+        }
+    }
+
+    void CollisionWorld::resolveHit(const BoundingVolumeHierarchy::Hit &treeHit,
+                                    const std::vector<GameObject *> &objects, Hit &hit) {
+        hit.fraction = treeHit.fraction;
+        hit.normal = treeHit.normal;
+        hit.object = objects[treeHit.id];
+    }
+
+    bool CollisionWorld::raycast(const glm::vec3 &from, const glm::vec3 &to, Hit &hit) const {
+        return sweepSphere(from, to, 0.0f, hit);
+    }
+
+    bool CollisionWorld::sweepSphere(const glm::vec3 &from, const glm::vec3 &to, float radius, Hit &hit) const {
+        BoundingVolumeHierarchy::Hit treeHit;
+        bool found = false;
+        if (m_staticTree.sweepSphere(from, to, radius, treeHit)) {
+            resolveHit(treeHit, m_staticObjects, hit);
+            found = true;
+        }
+
+        // Only a nearer moving object can replace a static hit
+        BoundingVolumeHierarchy::Hit movingHit;
+        if (m_movingTree.sweepSphere(from, to, radius, movingHit) && (!found || movingHit.fraction < hit.fraction)) {
+            resolveHit(movingHit, m_movingObjects, hit);
+            found = true;
+        }
+        return found;
+    }
+
+    bool CollisionWorld::sweepSphere(const glm::vec3 &from, const glm::vec3 &to, float radius,
+                                     const std::vector<uint32_t> &staticIds, const std::vector<uint32_t> &movingIds,
+                                     Hit &hit) const {
+        BoundingVolumeHierarchy::Hit treeHit;
+        bool found = false;
+        if (!staticIds.empty() && m_staticTree.sweepSphere(from, to, radius, staticIds, treeHit)) {
+            resolveHit(treeHit, m_staticObjects, hit);
+            found = true;
+        }
+
+        BoundingVolumeHierarchy::Hit movingHit;
+        if (!movingIds.empty() && m_movingTree.sweepSphere(from, to, radius, movingIds, movingHit) &&
+            (!found || movingHit.fraction < hit.fraction)) {
+            resolveHit(movingHit, m_movingObjects, hit);
+            found = true;
+        }
+        return found;
+    }
+
+    glm::vec3 CollisionWorld::slideSphere(const glm::vec3 &center, float radius, const glm::vec3 &displacement) const {
+        // No slide travels further than the displacement, so one walk of each tree
+        // finds every box any of the sweeps could touch
+        glm::vec3 reach(displacement.length() + radius + SKIN);
+        std::vector<uint32_t> &staticIds = t_staticCandidates;
+        std::vector<uint32_t> &movingIds = t_movingCandidates;
+        staticIds.clear();
+        movingIds.clear();
+        m_staticTree.overlap(center - reach, center + reach, staticIds);
+        m_movingTree.overlap(center - reach, center + reach, movingIds);
+        return slideSphere(center, radius, displacement, staticIds, movingIds);
+    }
+
+    void CollisionWorld::findSlideCandidates(const glm::vec3 &center, float radius, float travel,
+                                             std::vector<uint32_t> &staticIds) const {
+        glm::vec3 reach(travel + radius + SKIN);
+        m_staticTree.overlap(center - reach, center + reach, staticIds);
+    }
+
+    glm::vec3 CollisionWorld::slideSphere(const glm::vec3 &center, float radius, const glm::vec3 &displacement,
+                                          const std::vector<uint32_t> &staticIds) const {
+        std::vector<uint32_t> &movingIds = t_movingCandidates;
+        movingIds.clear();
+        return slideSphere(center, radius, displacement, staticIds, movingIds);
+    }
+
+    glm::vec3 CollisionWorld::slideSphere(const glm::vec3 &center, float radius, const glm::vec3 &displacement,
+                                          const std::vector<uint32_t> &staticIds,
+                                          const std::vector<uint32_t> &movingIds) const {
+        // Summed from zero, so a move that touches nothing comes back exactly as asked
+        glm::vec3 moved(0.0f);
+        glm::vec3 remaining = displacement;
+        for (int slide = 0; slide <= MAX_SLIDES; ++slide) {
+            Hit hit;
+            glm::vec3 start = center + moved;
+            if (!sweepSphere(start, start + remaining, radius, staticIds, movingIds, hit)) {
+                return moved + remaining;
+            }
+
+            // Up to the contact, less the skin, then along the face with what is left
+            float fraction = std::max(0.0f, hit.fraction - SKIN / remaining.length());
+            moved = moved + remaining * fraction;
+            remaining = remaining * (1.0f - hit.fraction);
+            remaining = remaining - hit.normal * glm::vec3::dot(remaining, hit.normal);
+        }
+        return moved;
+    }
+
+    float CollisionWorld::getClearance(const glm::vec3 &center, float radius, float limit) const {
+        float distance = std::min(m_staticTree.distance(center, radius + limit),
+                                  m_movingTree.distance(center, radius + limit));
+        return std::max(0.0f, distance - radius);
+    }
+} // namespace CowGL
@@ -0,0 +1,105 @@
+//==============================================================================
+// File: scene/CollisionWorld.h
+// Purpose: Solid objects of a scene, for movement and camera collision queries
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef COLLISIONWORLD_H
+#define COLLISIONWORLD_H
+
+
+#include <cstdint>
+#include <vector>
+#include "scene/BoundingVolumeHierarchy.h"
+
+namespace CowGL {
+    class GameObject;
+
+    // The collision boxes of a scene's objects in two trees: one over static
+    // objects, rebuilt only when static objects come or go, and one over moving
+    // objects, refit every update. Queries may run from any thread while the
+    // world is not being updated.
+    class CollisionWorld {
+    public:
+        struct Hit {
+            // Along the query segment, from 0 at its start to 1 at its end
+            float fraction = 1.0f;
+
+            // Outward normal of the face touched
+            glm::vec3 normal;
+
+            GameObject *object = nullptr;
+        };
+
+        CollisionWorld() = default;
+
+        CollisionWorld(const CollisionWorld &) = delete;
+
+        CollisionWorld &operator=(const CollisionWorld &) = delete;
+
+        // Objects without collision bounds are ignored
+        void add(GameObject *object);
+
+        void remove(GameObject *object);
+
+        // Rebuilds the static tree if objects came or went, and refits the moving
+        // tree around the objects that moved
+        void update();
+
+        bool raycast(const glm::vec3 &from, const glm::vec3 &to, Hit &hit) const;
+
+        bool sweepSphere(const glm::vec3 &from, const glm::vec3 &to, float radius, Hit &hit) const;
+
+        // Moves a sphere by the displacement, stopping short of solid objects and
+        // sliding along them; returns how far it got
+        glm::vec3 slideSphere(const glm::vec3 &center, float radius, const glm::vec3 &displacement) const;
+
+        // Static boxes that any slide travelling up to this far from the center could
+        // touch. A caller can keep them and slide against just those while it stays in
+        // range, as long as nothing solid moves.
+        void findSlideCandidates(const glm::vec3 &center, float radius, float travel,
+                                 std::vector<uint32_t> &staticIds) const;
+
+        // slideSphere against just these static boxes; moving objects are ignored
+        glm::vec3 slideSphere(const glm::vec3 &center, float radius, const glm::vec3 &displacement,
+                              const std::vector<uint32_t> &staticIds) const;
+
+        // How far the sphere can go in any direction before a sweep would stop it, up to limit
+        float getClearance(const glm::vec3 &center, float radius, float limit) const;
+
+        // Clearance only holds while nothing solid moves
+        bool hasMovingObjects() const { return !m_movingObjects.empty(); }
+
+        // Bumped whenever the static tree is rebuilt
+        uint64_t getRevision() const { return m_revision; }
+
+        const BoundingVolumeHierarchy &getStaticTree() const { return m_staticTree; }
+
+    private:
+        // Turns a tree hit into a world hit on one of the objects
+        static void resolveHit(const BoundingVolumeHierarchy::Hit &treeHit, const std::vector<GameObject *> &objects,
+                               Hit &hit);
+
+        // sweepSphere against just the boxes of these ids in each tree
+        bool sweepSphere(const glm::vec3 &from, const glm::vec3 &to, float radius,
+                         const std::vector<uint32_t> &staticIds, const std::vector<uint32_t> &movingIds,
+                         Hit &hit) const;
+
+        // slideSphere once the boxes it could touch are known
+        glm::vec3 slideSphere(const glm::vec3 &center, float radius, const glm::vec3 &displacement,
+                              const std::vector<uint32_t> &staticIds, const std::vector<uint32_t> &movingIds) const;
+
+        std::vector<GameObject *> m_staticObjects;
+        BoundingVolumeHierarchy m_staticTree;
+        bool m_staticDirty = false;
+        uint64_t m_revision = 0;
+
+        std::vector<GameObject *> m_movingObjects;
+        std::vector<uint32_t> m_movingRevisions;
+        BoundingVolumeHierarchy m_movingTree;
+        bool m_movingDirty = false;
+    };
+} // namespace CowGL
+
+
+#endif //COLLISIONWORLD_H
@@ -5,33 +5,78 @@
 //==============================================================================
 
 #include "scene/GameObject.h"
-#include <OpenGL/gl.h>
+#include "scene/RenderSnapshot.h"
+#include "scene/Scene.h"
+#include "core/Profiler.h"
+#include "utils/OpenGL.h"
+
+#include <cmath>
 
 namespace CowGL {
 
     GameObject::GameObject(const std::string& name)
         : m_name(name)
-        , m_active(true) {
+        , m_scene(nullptr)
+        , m_active(true)
+        , m_static(false)
+        , m_hasBounds(false)
+        , m_hasCollision(false)
+        , m_interpolated(false)
+        , m_nameId(Scene::NO_NAME) {
+    }
+
+    void GameObject::setScene(Scene *scene) {
+        if (scene == m_scene) return;
+
+        if (m_scene) {
+            m_scene->getTransformStore().detach(m_transform);
+        }
+
+        m_scene = scene;
+
+        if (m_scene) {
+            m_scene->getTransformStore().attach(m_transform);
+        }
+    }
+
+    void GameObject::setName(const std::string &name) {
+        m_name = name;
+        if (m_scene) {
+            m_scene->renameGameObject(*this);
+        }
     }
 
-    void GameObject::render() {
+    void GameObject::captureState(ObjectState &state) const {
+        state.position = m_transform.getPosition();
+        state.rotation = m_transform.getRotation();
+        state.scale = m_transform.getScale();
+    }
+
+    void GameObject::applyState(const ObjectState &from, const ObjectState &to, float alpha) {
+        auto lerp = [alpha](const glm::vec3 &a, const glm::vec3 &b) { return a + (b - a) * alpha; };
+
+        // Rotations take the shorter way around
+        auto lerpAngle = [alpha](float a, float b) { return a + std::remainder(b - a, 360.0f) * alpha; };
+
+        m_renderTransform.setPosition(lerp(from.position, to.position));
+        m_renderTransform.setRotation(glm::vec3(lerpAngle(from.rotation.x, to.rotation.x),
+                                                lerpAngle(from.rotation.y, to.rotation.y),
+                                                lerpAngle(from.rotation.z, to.rotation.z)));
+        m_renderTransform.setScale(lerp(from.scale, to.scale));
+        m_interpolated = true;
+    }
+
+    void GameObject::render(const FrameContext &context) {
         if (!m_active) return;
+        COWGL_PROFILE_SCOPE("Object render");
 
         glPushMatrix();
 
         // Apply transform
-        glm::vec3 pos = m_transform.getPosition();
-        glm::vec3 rot = m_transform.getRotation();
-        glm::vec3 scale = m_transform.getScale();
-
-        glTranslatef(pos.x, pos.y, pos.z);
-        glRotatef(rot.z, 0.0f, 0.0f, 1.0f);
-        glRotatef(rot.y, 0.0f, 1.0f, 0.0f);
-        glRotatef(rot.x, 1.0f, 0.0f, 0.0f);
-        glScalef(scale.x, scale.y, scale.z);
+        glMultMatrixf(getRenderTransform().getWorldMatrix().m);
 
         // Render the object
-        onRender();
+        onRender(context);
 
         glPopMatrix();
     }
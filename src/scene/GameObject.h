@@ -10,39 +10,165 @@
 
 #include <string>
 #include <memory>
+#include <cstdint>
 #include "scene/Transform.h"
+#include "scene/Bounds.h"
 
 namespace CowGL {
+    class GeometryBuilder;
+    class RenderQueue;
+    class InstanceRenderer;
+    struct ObjectState;
+    class Scene;
+    struct FrameContext;
+
+    // Shared systems an update may touch besides the object's own state
+    namespace Systems {
+        using Mask = uint32_t;
+
+        constexpr Mask NONE = 0;
+        constexpr Mask INPUT = 1u << 0;
+        constexpr Mask CAMERA = 1u << 1;
+        constexpr Mask SCENE = 1u << 2;    // Adding, removing or looking up objects
+        constexpr Mask LIGHTING = 1u << 3;
+        constexpr Mask ALL = ~0u;
+    } // namespace Systems
+
+    // Updates that do not write anything another one reads or writes run concurrently
+    struct UpdateAccess {
+        Systems::Mask reads = Systems::ALL;
+        Systems::Mask writes = Systems::ALL;
+
+        bool conflictsWith(const UpdateAccess &other) const {
+            return (writes & (other.reads | other.writes)) != 0 || (other.writes & reads) != 0;
+        }
+    };
+
     class GameObject {
     public:
         GameObject(const std::string &name = "GameObject");
 
         virtual ~GameObject() = default;
 
-        virtual void update(float deltaTime) {
+        // The transform may live in a scene's store, which copies would share
+        GameObject(const GameObject &) = delete;
+
+        GameObject &operator=(const GameObject &) = delete;
+
+        virtual void update(const FrameContext &context) {
         }
 
-        virtual void render();
+        // Systems update() reads and writes; anything that does not declare them is
+        // assumed to touch everything and updates on its own
+        virtual UpdateAccess getUpdateAccess() const { return UpdateAccess(); }
+
+        // Objects with nothing to do per tick, or that a system updates in bulk,
+        // stay out of the scene's update phases
+        virtual bool needsUpdate() const { return true; }
+
+        virtual void render(const FrameContext &context);
+
+        // Objects that can describe themselves as draw packets submit them here
+        // and return true; the renderer then sorts them with everything else
+        // instead of calling render()
+        virtual bool enqueue(RenderQueue &queue, const FrameContext &context) { return false; }
 
         // Active state
         bool isActive() const { return m_active; }
-        void setActive(bool active) { m_active = active; }
+        virtual void setActive(bool active) { m_active = active; }
 
         // Name
         const std::string &getName() const { return m_name; }
-        void setName(const std::string &name) { m_name = name; }
+        void setName(const std::string &name);
 
-        // Transform
+        // The name's id in the object's scene, see Scene::findNameId
+        uint32_t getNameId() const { return m_nameId; }
+
+        // Transform; while the object is in a scene its position, rotation and
+        // scale live in the scene's transform store
         Transform &getTransform() { return m_transform; }
         const Transform &getTransform() const { return m_transform; }
 
+        // Local-space bounds; objects without bounds are never culled
+        bool hasBounds() const { return m_hasBounds; }
+        const Bounds &getLocalBounds() const { return m_localBounds; }
+
+        void setLocalBounds(const Bounds &bounds) {
+            m_localBounds = bounds;
+            m_hasBounds = true;
+        }
+
+        Bounds getWorldBounds() const { return m_localBounds.transformed(m_transform.getWorldMatrix()); }
+
+        // Local-space solid box; objects without one never block movement or the camera.
+        // Set it before adding the object to a scene.
+        bool hasCollision() const { return m_hasCollision; }
+        const Bounds &getCollisionBounds() const { return m_collisionBounds; }
+
+        void setCollisionBounds(const Bounds &bounds) {
+            m_collisionBounds = bounds;
+            m_hasCollision = true;
+        }
+
+        Bounds getWorldCollisionBounds() const { return m_collisionBounds.transformed(m_transform.getWorldMatrix()); }
+
+        // The simulation captures its state once per tick, and the renderer draws a
+        // blend of the last two captures. Objects that were never captured render as is.
+        virtual void captureState(ObjectState &state) const;
+
+        virtual void applyState(const ObjectState &from, const ObjectState &to, float alpha);
+
+        const Transform &getRenderTransform() const { return m_interpolated ? m_renderTransform : m_transform; }
+
+        Bounds getRenderBounds() const { return m_localBounds.transformed(getRenderTransform().getWorldMatrix()); }
+
+        // Changes whenever anything the object draws changes
+        virtual uint64_t getStateRevision() const { return m_transform.getRevision(); }
+
+        // Objects that change on their own keep the scene from going idle
+        virtual bool isAnimating() const { return false; }
+
+        // Scene the object was added to, if any. Moves the transform into the
+        // scene's transform store, and back out when the object leaves.
+        Scene *getScene() const { return m_scene; }
+        virtual void setScene(Scene *scene);
+
+        // Static objects never move once added to the scene, which lets the
+        // renderer bake their geometry into shared per-material batches
+        bool isStatic() const { return m_static; }
+        void setStatic(bool isStatic) { m_static = isStatic; }
+
+        // Bakeable objects emit their local-space geometry through the builder
+        virtual bool hasStaticGeometry() const { return false; }
+
+        virtual void buildStaticGeometry(GeometryBuilder &builder) const {
+        }
+
+        // Static objects sharing one model can instead be drawn together through an instance renderer
+        virtual InstanceRenderer *getInstanceRenderer() const { return nullptr; }
+
+        virtual glm::vec4 getInstanceTint() const { return glm::vec4(1.0f, 1.0f, 1.0f, 1.0f); }
+
     protected:
-        virtual void onRender() {
+        virtual void onRender(const FrameContext &context) {
         }
 
         std::string m_name;
+        Scene *m_scene;
         bool m_active;
+        bool m_static;
+        bool m_hasBounds;
+        Bounds m_localBounds;
+        bool m_hasCollision;
+        Bounds m_collisionBounds;
         Transform m_transform;
+        Transform m_renderTransform;
+        bool m_interpolated;
+
+    private:
+        // Set by the scene, which interns the name when the object is added or renamed
+        friend class Scene;
+        uint32_t m_nameId;
     };
 } // namespace CowGL
 
@@ -0,0 +1,60 @@
+//==============================================================================
+// File: scene/Handle.h
+// Purpose: Generational, typed references to scene objects
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef HANDLE_H
+#define HANDLE_H
+
+
+#include <cstdint>
+#include <type_traits>
+
+namespace CowGL {
+    class Scene;
+
+    // Refers to an object by its slot in the scene's registry. The slot's
+    // generation moves on when its object is removed, so a handle to a removed
+    // object resolves to null instead of to whatever reuses the slot. Handles do
+    // not keep objects alive and are only meaningful to the scene that made them.
+    template<typename T>
+    class Handle {
+    public:
+        Handle() = default;
+
+        // A handle converts to a handle of any base class
+        template<typename U, typename = std::enable_if_t<std::is_base_of_v<T, U> > >
+        Handle(const Handle<U> &other)
+            : m_index(other.getIndex())
+              , m_generation(other.getGeneration()) {
+        }
+
+        // Null handles never resolve; generations start at 1
+        bool isNull() const { return m_generation == 0; }
+        explicit operator bool() const { return !isNull(); }
+
+        uint32_t getIndex() const { return m_index; }
+        uint32_t getGeneration() const { return m_generation; }
+
+        bool operator==(const Handle &other) const {
+            return m_index == other.m_index && m_generation == other.m_generation;
+        }
+
+        bool operator!=(const Handle &other) const { return !(*this == other); }
+
+    private:
+        friend class Scene;
+
+        Handle(uint32_t index, uint32_t generation)
+            : m_index(index)
+              , m_generation(generation) {
+        }
+
+        uint32_t m_index = 0;
+        uint32_t m_generation = 0;
+    };
+} // namespace CowGL
+
+
+#endif //HANDLE_H
@@ -0,0 +1,69 @@
+//==============================================================================
+// File: scene/RenderSnapshot.h
+// Purpose: Simulation state handed from the simulation thread to the renderer
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef RENDERSNAPSHOT_H
+#define RENDERSNAPSHOT_H
+
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include "scene/Handle.h"
+#include "graphics/Camera.h"
+#include "core/FrameContext.h"
+#include "utils/Math.h"
+
+namespace CowGL {
+    class GameObject;
+
+    // Drawable state of one moving object; pose holds object-specific articulation.
+    // The handle resolves to null once the object has been removed.
+    struct ObjectState {
+        Handle<GameObject> object;
+        glm::vec3 position;
+        glm::vec3 rotation; // Euler angles in degrees
+        glm::vec3 scale;
+        glm::vec4 pose;
+    };
+
+    struct CameraState {
+        glm::vec3 position;
+        glm::vec3 target;
+        float fov = 60.0f;
+        Camera::Mode mode = Camera::Mode::ThirdPerson;
+    };
+
+    // Everything the renderer reads from the simulation, as of one tick. Both the
+    // previous and the current tick are included so frames can blend between them.
+    // Objects are listed in registry slot order.
+    struct RenderSnapshot {
+        uint64_t tick = 0;
+        std::chrono::steady_clock::time_point time; // When the current tick became due
+
+        std::vector<ObjectState> previousObjects;
+        std::vector<ObjectState> objects;
+
+        CameraState previousCamera;
+        CameraState camera;
+        bool hasCamera = false;
+
+        // Lighting and menus as set through the UI
+        LightingState lighting;
+        bool showHelpMenu = false;
+        bool showLightingMenu = false;
+
+        // Change tracking: revisions move whenever something drawn changes, and an idle
+        // snapshot looks exactly like the one before it
+        uint64_t sceneRevision = 0;
+        uint64_t uiRevision = 0;
+        bool animating = false;
+        bool idle = false;
+        uint64_t wakeSerial = 0; // Wake-ups the tick had seen, see Application::wake
+    };
+} // namespace CowGL
+
+
+#endif //RENDERSNAPSHOT_H
@@ -10,51 +10,327 @@
 #include "graphics/Light.h"
 #include "entities/Cow.h"
 #include "entities/Environment.h"
-#include "core/Application.h"
+#include "core/FrameContext.h"
 #include "core/Input.h"
+#include "core/Profiler.h"
+#include "core/JobSystem.h"
 
 #include <algorithm>
+#include <cmath>
+#include <mutex>
 
 namespace CowGL {
-    Scene::Scene() : m_activeCamera(nullptr), m_cow(nullptr) {
+    namespace {
+        // Objects per job; updates are short, so small batches would be all overhead
+        const size_t UPDATE_GRAIN_SIZE = 256;
+
+        // Up to this many objects, comparing every name beats hashing the one asked for
+        const size_t NAME_SCAN_LIMIT = 24;
+
+        // Objects per job when re-filing moved objects; each is a handful of loads
+        const size_t INDEX_GRAIN_SIZE = 4096;
+
+        // A few cows across, so a query near a cow visits a handful of cells;
+        // bigger objects, like the ground, are tested by every query
+        const float INDEX_CELL_SIZE = 16.0f;
+
+        // Added to the circles of moving objects, so a walking cow is re-filed
+        // about every dozen ticks rather than every tick
+        const float INDEX_SLACK = 1.0f;
+
+        // Ids found by the spatial index, kept per thread so warm queries allocate nothing
+        thread_local std::vector<uint32_t> t_queryIds;
+
+        // Radius of the circle that holds bounds reaching this far from the
+        // transform's position, once scaled
+        float indexRadius(const Transform &transform, float reach) {
+            const glm::vec3 &scale = transform.getScale();
+            return reach * std::max({std::fabs(scale.x), std::fabs(scale.y), std::fabs(scale.z)});
+        }
     }
 
-    Scene::~Scene() = default;
+    Scene::Scene()
+        : m_activeCamera(nullptr)
+          , m_staticRevision(0)
+          , m_cowStore(m_transforms)
+          , m_spatialIndex(INDEX_CELL_SIZE)
+          , m_jobSystem(nullptr)
+          , m_updatePhasesDirty(true)
+          , m_hasCapture(false) {
+    }
+
+    Scene::~Scene() {
+        // Objects can outlive the scene, so they take their state back out of its stores
+        for (auto &obj: m_gameObjects) {
+            obj->setScene(nullptr);
+        }
+    }
 
     void Scene::initialize() {
         createDefaultScene();
     }
 
-    void Scene::update(float deltaTime) {
-        // Update all game objects
-        for (auto &obj: m_gameObjects) {
-            if (obj->isActive()) {
-                obj->update(deltaTime);
+    void Scene::update(const FrameContext &context) {
+        COWGL_PROFILE_SCOPE("Scene update");
+        if (m_updatePhasesDirty) {
+            buildUpdatePhases();
+        }
+
+        m_collision.update();
+
+        // Systems first: they only touch their own objects' state
+        m_cowStore.update(context, m_jobSystem, &m_collision);
+
+        // Then every other game object, phase by phase
+        for (const UpdatePhase &phase: m_updatePhases) {
+            auto updateRange = [&phase, &context](size_t begin, size_t end) {
+                COWGL_PROFILE_SCOPE("Update objects");
+                for (size_t i = begin; i < end; ++i) {
+                    GameObject *obj = phase.objects[i];
+                    if (obj->isActive()) {
+                        obj->update(context);
+                    }
+                }
+            };
+
+            if (m_jobSystem) {
+                m_jobSystem->parallelFor(phase.objects.size(), UPDATE_GRAIN_SIZE, updateRange);
+            } else {
+                updateRange(0, phase.objects.size());
             }
         }
 
+        updateSpatialIndex();
+
         // Update camera
         if (m_activeCamera) {
-            m_activeCamera->update(deltaTime);
+            m_activeCamera->update(context.deltaTime);
         }
 
         // Handle camera controls
-        handleCameraControls(deltaTime);
+        handleCameraControls(context);
+    }
+
+    void Scene::buildUpdatePhases() {
+        m_updatePhases.clear();
+
+        for (auto &obj: m_gameObjects) {
+            if (!obj->needsUpdate()) continue;
+
+            UpdateAccess access = obj->getUpdateAccess();
+
+            size_t target = 0;
+            for (size_t i = m_updatePhases.size(); i > 0; --i) {
+                if (m_updatePhases[i - 1].access.conflictsWith(access)) {
+                    target = i;
+                    break;
+                }
+            }
+
+            if (target == m_updatePhases.size()) {
+                m_updatePhases.emplace_back();
+            }
+            UpdatePhase &phase = m_updatePhases[target];
+            phase.access.reads |= access.reads;
+            phase.access.writes |= access.writes;
+            phase.objects.push_back(obj.get());
+        }
+
+        m_updatePhasesDirty = false;
+    }
+
+    void Scene::indexGameObject(uint32_t index) {
+        GameObject *object = m_slots[index].object.get();
+        if (!object->hasBounds()) return;
+
+        const Bounds &bounds = object->getLocalBounds();
+        const Transform &transform = object->getTransform();
+        float reach = bounds.center.length() + bounds.radius;
+        const glm::vec3 &position = transform.getPosition();
+        float radius = indexRadius(transform, reach);
+
+        // Static objects stay where they were put
+        if (object->isStatic()) {
+            m_spatialIndex.insert(index, position.x, position.y, radius);
+            return;
+        }
+
+        MovingIndexed moving;
+        moving.transform = &transform;
+        moving.slot = index;
+        moving.revision = transform.getRevision();
+        moving.reach = reach;
+        moving.x = position.x;
+        moving.y = position.y;
+        moving.radius = radius + INDEX_SLACK;
+        m_spatialIndex.insert(index, moving.x, moving.y, moving.radius);
+
+        m_slots[index].movingRow = static_cast<uint32_t>(m_movingIndexed.size());
+        m_movingIndexed.push_back(moving);
+    }
+
+    void Scene::unindexGameObject(uint32_t index) {
+        m_spatialIndex.remove(index);
+
+        uint32_t row = m_slots[index].movingRow;
+        if (row == UINT32_MAX) return;
+
+        // Move the last row into the hole
+        m_movingIndexed[row] = m_movingIndexed.back();
+        m_slots[m_movingIndexed[row].slot].movingRow = row;
+        m_movingIndexed.pop_back();
+        m_slots[index].movingRow = UINT32_MAX;
     }
 
-    void Scene::handleCameraControls(float deltaTime) {
-        if (!m_activeCamera || !m_cow) return;
+    void Scene::updateSpatialIndex() {
+        COWGL_PROFILE_SCOPE("Spatial index");
 
-        Input *input = Application::getInstance()->getInput();
+        // Objects still inside their circles are left alone. Moving within a cell
+        // only rewrites the entry, which is safe in parallel; the few objects that
+        // crossed into another cell are re-filed afterwards.
+        std::vector<uint32_t> relinks;
+        std::mutex relinksMutex;
+        auto refreshRange = [this, &relinks, &relinksMutex](size_t begin, size_t end) {
+            std::vector<uint32_t> crossed;
+            for (size_t i = begin; i < end; ++i) {
+                MovingIndexed &moving = m_movingIndexed[i];
+                const Transform &transform = *moving.transform;
+                if (transform.getRevision() == moving.revision) continue;
+
+                moving.revision = transform.getRevision();
+                const glm::vec3 &position = transform.getPosition();
+                float radius = indexRadius(transform, moving.reach);
+                float dx = position.x - moving.x;
+                float dy = position.y - moving.y;
+                float room = moving.radius - radius;
+                if (room >= 0.0f && dx * dx + dy * dy <= room * room) continue;
+
+                moving.x = position.x;
+                moving.y = position.y;
+                moving.radius = radius + INDEX_SLACK;
+                if (m_spatialIndex.move(moving.slot, moving.x, moving.y, moving.radius)) {
+                    crossed.push_back(moving.slot);
+                }
+            }
+
+            if (!crossed.empty()) {
+                std::lock_guard<std::mutex> lock(relinksMutex);
+                relinks.insert(relinks.end(), crossed.begin(), crossed.end());
+            }
+        };
+
+        if (m_jobSystem) {
+            m_jobSystem->parallelFor(m_movingIndexed.size(), INDEX_GRAIN_SIZE, refreshRange);
+        } else {
+            refreshRange(0, m_movingIndexed.size());
+        }
+
+        for (uint32_t index: relinks) {
+            m_spatialIndex.relink(index);
+        }
+    }
+
+    void Scene::resolveAll(const std::vector<uint32_t> &ids, std::vector<GameObject *> &result) const {
+        result.clear();
+        result.reserve(ids.size());
+        for (uint32_t index: ids) {
+            result.push_back(m_slots[index].object.get());
+        }
+    }
+
+    void Scene::queryRadius(const glm::vec2 &center, float radius, std::vector<GameObject *> &result) const {
+        t_queryIds.clear();
+        m_spatialIndex.queryRadius(center.x, center.y, radius, t_queryIds);
+        resolveAll(t_queryIds, result);
+    }
+
+    void Scene::queryBox(const glm::vec2 &min, const glm::vec2 &max, std::vector<GameObject *> &result) const {
+        t_queryIds.clear();
+        m_spatialIndex.queryBox(min.x, min.y, max.x, max.y, t_queryIds);
+        resolveAll(t_queryIds, result);
+    }
+
+    void Scene::queryNearest(const glm::vec2 &point, size_t count, std::vector<GameObject *> &result) const {
+        t_queryIds.clear();
+        m_spatialIndex.queryNearest(point.x, point.y, count, t_queryIds);
+        resolveAll(t_queryIds, result);
+    }
+
+    void Scene::captureSnapshot(RenderSnapshot &snapshot) {
+        // The last capture becomes the previous state without copying it
+        snapshot.previousObjects.swap(m_capturedObjects);
+        snapshot.objects.clear();
+        snapshot.sceneRevision = m_staticRevision;
+        snapshot.animating = false;
+        for (uint32_t index = 0; index < m_slots.size(); ++index) {
+            GameObject *obj = m_slots[index].object.get();
+            if (!obj || obj->isStatic()) continue;
+
+            snapshot.objects.emplace_back();
+            ObjectState &state = snapshot.objects.back();
+            state.object = Handle<GameObject>(index, m_slots[index].generation);
+            obj->captureState(state);
+
+            snapshot.sceneRevision += obj->getStateRevision();
+            snapshot.animating = snapshot.animating || obj->isAnimating();
+        }
+
+        snapshot.hasCamera = m_activeCamera != nullptr;
+        if (m_activeCamera) {
+            m_activeCamera->captureState(snapshot.camera);
+            snapshot.sceneRevision += m_activeCamera->getRevision();
+        }
+
+        // The first capture has no earlier tick to blend from
+        if (!m_hasCapture) {
+            snapshot.previousObjects = snapshot.objects;
+            m_capturedCamera = snapshot.camera;
+            m_hasCapture = true;
+        }
+
+        snapshot.previousCamera = m_capturedCamera;
+        m_capturedObjects = snapshot.objects;
+        m_capturedCamera = snapshot.camera;
+    }
+
+    void Scene::applySnapshot(const RenderSnapshot &snapshot, float alpha) {
+        // Both lists are in slot order, so each object's previous state is found by
+        // walking them together; objects added or removed in between shift positions
+        const std::vector<ObjectState> &previous = snapshot.previousObjects;
+        size_t p = 0;
+        for (const ObjectState &to: snapshot.objects) {
+            while (p < previous.size() && previous[p].object.getIndex() < to.object.getIndex()) {
+                ++p;
+            }
+
+            GameObject *object = get(to.object);
+            if (!object) continue;
+
+            // A slot reused since the last tick has nothing to blend from
+            bool blend = p < previous.size() && previous[p].object == to.object;
+            object->applyState(blend ? previous[p] : to, to, alpha);
+        }
+
+        if (m_activeCamera && snapshot.hasCamera) {
+            m_activeCamera->applyState(snapshot.previousCamera, snapshot.camera, alpha);
+        }
+    }
+
+    void Scene::handleCameraControls(const FrameContext &context) {
+        const Input *input = context.input;
+        Cow *cow = getMainCow();
+        if (!m_activeCamera || !cow || !input) return;
+
+        float deltaTime = context.deltaTime;
 
         // Switch camera mode with 'V'
-        if (input->isKeyJustPressed('v') || input->isKeyJustPressed('V')) {
+        if (input->isActionJustPressed(Action::ToggleCamera)) {
             if (m_activeCamera->getMode() == Camera::Mode::ThirdPerson) {
                 m_activeCamera->setMode(Camera::Mode::FirstPerson);
-                m_activeCamera->setFollowTarget(&m_cow->getTransform().getPositionRef());
+                m_activeCamera->setFollowTarget(&cow->getTransform().getPositionRef());
             } else {
                 m_activeCamera->setMode(Camera::Mode::ThirdPerson);
-                m_activeCamera->setFollowTarget(&m_cow->getTransform().getPositionRef());
+                m_activeCamera->setFollowTarget(&cow->getTransform().getPositionRef());
             }
         }
 
@@ -64,35 +340,35 @@ namespace CowGL {
             float zoomSpeed = 5.0f * deltaTime;
 
             // Rotation controls
-            if (input->isKeyPressed('8')) {
+            if (input->isActionPressed(Action::OrbitUp)) {
                 // Numpad 8 - rotate up
                 m_activeCamera->rotate(0.0f, -rotateSpeed);
             }
-            if (input->isKeyPressed('2')) {
+            if (input->isActionPressed(Action::OrbitDown)) {
                 // Numpad 2 - rotate down
                 m_activeCamera->rotate(0.0f, rotateSpeed);
             }
-            if (input->isKeyPressed('4')) {
+            if (input->isActionPressed(Action::OrbitLeft)) {
                 // Numpad 4 - rotate left
                 m_activeCamera->rotate(-rotateSpeed, 0.0f);
             }
-            if (input->isKeyPressed('6')) {
+            if (input->isActionPressed(Action::OrbitRight)) {
                 // Numpad 6 - rotate right
                 m_activeCamera->rotate(rotateSpeed, 0.0f);
             }
 
             // Zoom controls
-            if (input->isKeyPressed('1')) {
+            if (input->isActionPressed(Action::ZoomIn)) {
                 // Numpad 1 - zoom in
                 m_activeCamera->zoom(-zoomSpeed);
             }
-            if (input->isKeyPressed('7')) {
+            if (input->isActionPressed(Action::ZoomOut)) {
                 // Numpad 7 - zoom out
                 m_activeCamera->zoom(zoomSpeed);
             }
 
             // Reset camera
-            if (input->isKeyPressed('5')) {
+            if (input->isActionPressed(Action::ResetCamera)) {
                 // Numpad 5 - reset
                 m_activeCamera->setOrbitAngles(180.0f, 35.0f);
                 m_activeCamera->setOrbitDistance(10.0f);
@@ -100,23 +376,169 @@ namespace CowGL {
         }
     }
 
-    void Scene::addGameObject(std::shared_ptr<GameObject> object) {
-        m_gameObjects.push_back(object);
+    Cow *Scene::getMainCow() const {
+        return get(m_mainCow);
+    }
+
+    Handle<GameObject> Scene::registerGameObject(std::shared_ptr<GameObject> object) {
+        std::lock_guard<std::mutex> lock(m_structureMutex);
+        if (object->isStatic()) {
+            ++m_staticRevision;
+        }
+
+        uint32_t index;
+        if (m_freeSlots.empty()) {
+            index = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        } else {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        m_slots[index].object = object;
+        indexName(index);
+
+        object->setScene(this);
+        indexGameObject(index);
+        m_collision.add(object.get());
+
+        // The render thread reads static transforms as they are, so their cached
+        // matrices are filled in while only this thread can see them
+        if (object->isStatic()) {
+            object->getTransform().getWorldMatrix();
+        }
+        m_gameObjects.push_back(std::move(object));
+        m_updatePhasesDirty = true;
+        return Handle<GameObject>(index, m_slots[index].generation);
+    }
+
+    void Scene::unregisterGameObject(uint32_t index) {
+        Slot &slot = m_slots[index];
+        GameObject *object = slot.object.get();
+        if (object->isStatic()) {
+            ++m_staticRevision;
+        }
+
+        unindexName(index);
+
+        // The camera holds on to the cow it follows by pointer
+        if (object == getMainCow()) {
+            if (m_camera) {
+                m_camera->setFollowTarget(nullptr);
+                m_camera->setFirstPersonSource(nullptr);
+            }
+            m_mainCow = Handle<Cow>();
+        }
+
+        unindexGameObject(index);
+        m_collision.remove(object);
+        object->setScene(nullptr);
+        slot.object.reset();
+        slot.generation = slot.generation == UINT32_MAX ? 1 : slot.generation + 1;
+        m_freeSlots.push_back(index);
+        m_updatePhasesDirty = true;
+    }
+
+    void Scene::removeGameObject(Handle<GameObject> handle) {
+        std::lock_guard<std::mutex> lock(m_structureMutex);
+        GameObject *object = get(handle);
+        if (!object) return;
+
+        // Objects stay in the order they were added, so the later ones move up
+        auto it = std::find_if(m_gameObjects.begin(), m_gameObjects.end(),
+                               [object](const auto &obj) { return obj.get() == object; });
+        unregisterGameObject(handle.getIndex());
+        m_gameObjects.erase(it);
     }
 
     void Scene::removeGameObject(const std::string &name) {
+        std::lock_guard<std::mutex> lock(m_structureMutex);
+        uint32_t nameId = findNameId(name);
+        if (nameId == NO_NAME) return;
+
+        // Unregistering edits the index entry, so work from a copy
+        std::vector<uint32_t> slots = m_nameIndex[nameId];
+        for (uint32_t index: slots) {
+            unregisterGameObject(index);
+        }
+
         m_gameObjects.erase(
             std::remove_if(m_gameObjects.begin(), m_gameObjects.end(),
-                           [&name](const auto &obj) { return obj->getName() == name; }),
+                           [](const auto &obj) { return obj->getScene() == nullptr; }),
             m_gameObjects.end()
         );
     }
 
+    uint32_t Scene::findSlot(const std::string &name) const {
+        if (m_gameObjects.size() > NAME_SCAN_LIMIT) {
+            return findSlot(findNameId(name));
+        }
+
+        // Objects are in the order they were added, so the first match is the one indexed first
+        for (const auto &obj: m_gameObjects) {
+            if (obj->getName() == name) {
+                return findSlot(obj->getNameId());
+            }
+        }
+        return static_cast<uint32_t>(m_slots.size());
+    }
+
+    uint32_t Scene::findSlot(uint32_t nameId) const {
+        if (nameId >= m_nameIndex.size() || m_nameIndex[nameId].empty()) {
+            return static_cast<uint32_t>(m_slots.size());
+        }
+        return m_nameIndex[nameId].front();
+    }
+
+    uint32_t Scene::findNameId(const std::string &name) const {
+        auto named = m_nameIds.find(name);
+        return named == m_nameIds.end() ? NO_NAME : named->second;
+    }
+
+    uint32_t Scene::internName(const std::string &name) {
+        auto named = m_nameIds.emplace(name, static_cast<uint32_t>(m_nameIndex.size()));
+        if (named.second) {
+            m_nameIndex.emplace_back();
+        }
+        return named.first->second;
+    }
+
+    void Scene::indexName(uint32_t index) {
+        GameObject &object = *m_slots[index].object;
+        object.m_nameId = internName(object.getName());
+        m_nameIndex[object.m_nameId].push_back(index);
+    }
+
+    void Scene::unindexName(uint32_t index) {
+        GameObject &object = *m_slots[index].object;
+        std::vector<uint32_t> &slots = m_nameIndex[object.m_nameId];
+        slots.erase(std::find(slots.begin(), slots.end(), index));
+        object.m_nameId = NO_NAME;
+    }
+
     std::shared_ptr<GameObject> Scene::findGameObject(const std::string &name) const {
-        auto it = std::find_if(m_gameObjects.begin(), m_gameObjects.end(),
-                               [&name](const auto &obj) { return obj->getName() == name; });
+        uint32_t index = findSlot(name);
+        return index < m_slots.size() ? m_slots[index].object : nullptr;
+    }
+
+    Handle<GameObject> Scene::findHandle(const std::string &name) const {
+        uint32_t index = findSlot(name);
+        return index < m_slots.size() ? Handle<GameObject>(index, m_slots[index].generation) : Handle<GameObject>();
+    }
+
+    Handle<GameObject> Scene::findHandle(uint32_t nameId) const {
+        uint32_t index = findSlot(nameId);
+        return index < m_slots.size() ? Handle<GameObject>(index, m_slots[index].generation) : Handle<GameObject>();
+    }
+
+    void Scene::renameGameObject(GameObject &object) {
+        const std::vector<uint32_t> &slots = m_nameIndex[object.m_nameId];
+        auto it = std::find_if(slots.begin(), slots.end(),
+                               [this, &object](uint32_t index) { return m_slots[index].object.get() == &object; });
+        if (it == slots.end()) return;
 
-        return (it != m_gameObjects.end()) ? *it : nullptr;
+        uint32_t index = *it;
+        unindexName(index);
+        indexName(index);
     }
 
     void Scene::addLight(std::shared_ptr<Light> light) {
@@ -129,9 +551,9 @@ namespace CowGL {
         addGameObject(ground);
 
         // Create cow
-        m_cow = std::make_shared<Cow>("MainCow");
-        m_cow->getTransform().setPosition(glm::vec3(0.0f, 0.0f, 0.0f));
-        addGameObject(m_cow);
+        auto cow = std::make_shared<Cow>("MainCow");
+        cow->getTransform().setPosition(glm::vec3(0.0f, 0.0f, 0.0f));
+        m_mainCow = addGameObject(cow);
 
         // Create environment objects
         auto house = std::make_shared<Environment::House>();
@@ -163,7 +585,9 @@ namespace CowGL {
         // Create camera
         m_camera = std::make_unique<Camera>();
         m_camera->setMode(Camera::Mode::ThirdPerson);
-        m_camera->setFollowTarget(&m_cow->getTransform().getPositionRef());
+        m_camera->setFollowTarget(&cow->getTransform().getPositionRef());
+        m_camera->setFirstPersonSource(cow.get());
+        m_camera->setCollisionWorld(&m_collision);
         m_activeCamera = m_camera.get();  // Set the raw pointer
     }
 } // namespace CowGL
@@ -10,13 +10,24 @@
 
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <cstdint>
+#include <unordered_map>
+#include "scene/RenderSnapshot.h"
+#include "scene/GameObject.h"
+#include "scene/Handle.h"
+#include "scene/TransformStore.h"
+#include "scene/SpatialHash.h"
+#include "scene/CollisionWorld.h"
+#include "entities/CowStore.h"
 
 namespace CowGL {
-    class GameObject;
     class Camera;
     class Light;
     class Cow;
+    class JobSystem;
+    struct FrameContext;
 
     class Scene {
     public:
@@ -26,32 +37,222 @@ namespace CowGL {
 
         void initialize();
 
-        void update(float deltaTime);
+        // One simulation tick; objects without input in the context ignore controls
+        void update(const FrameContext &context);
 
-        void addGameObject(std::shared_ptr<GameObject> object);
+        // Object updates are spread over the job system when one is set
+        void setJobSystem(JobSystem *jobSystem) { m_jobSystem = jobSystem; }
+        JobSystem *getJobSystem() const { return m_jobSystem; }
 
+        // Simulation thread: records moving objects and the camera after a tick,
+        // along with what was recorded after the tick before
+        void captureSnapshot(RenderSnapshot &snapshot);
+
+        // Render thread: blends moving objects and the camera between the two ticks
+        void applySnapshot(const RenderSnapshot &snapshot, float alpha);
+
+        // Render thread: held from applying a snapshot until the frame is drawn. Adding and
+        // removing objects wait for it, so the object list, the slots and the objects
+        // themselves stay put while a frame reads them.
+        std::unique_lock<std::mutex> lockStructure() const { return std::unique_lock<std::mutex>(m_structureMutex); }
+
+        // Adds the object and returns a handle typed like the pointer passed in;
+        // waits for a frame being drawn to finish, see lockStructure
+        template<typename T>
+        Handle<T> addGameObject(std::shared_ptr<T> object) {
+            Handle<GameObject> handle = registerGameObject(std::move(object));
+            return Handle<T>(handle.getIndex(), handle.getGeneration());
+        }
+
+        // The object behind the handle in constant time, or null once it was removed
+        template<typename T>
+        T *get(Handle<T> handle) const {
+            return static_cast<T *>(resolve(handle.getIndex(), handle.getGeneration()));
+        }
+
+        // Waits for a frame being drawn to finish, see lockStructure
+        void removeGameObject(Handle<GameObject> handle);
+
+        // Removes every object of that name
         void removeGameObject(const std::string &name);
 
+        // Names are interned as objects are added or renamed, and the index is
+        // keyed by the id. By-name queries hash the name once to find its id, or
+        // scan small scenes; callers that look a name up often can keep its id,
+        // and hot paths should look an object up once and keep its handle. With
+        // several objects of the same name, the one added first is returned.
         std::shared_ptr<GameObject> findGameObject(const std::string &name) const;
 
+        Handle<GameObject> findHandle(const std::string &name) const;
+
+        Handle<GameObject> findHandle(uint32_t nameId) const;
+
+        // Null when the object of that name is not a T
+        template<typename T>
+        Handle<T> findHandle(const std::string &name) const { return castHandle<T>(findHandle(name)); }
+
+        template<typename T>
+        Handle<T> findHandle(uint32_t nameId) const { return castHandle<T>(findHandle(nameId)); }
+
+        // Ids stay valid for the life of the scene; NO_NAME if no object here was ever given the name
+        static const uint32_t NO_NAME = UINT32_MAX;
+        uint32_t findNameId(const std::string &name) const;
+
+        // Keeps the name index current; called by GameObject::setName
+        void renameGameObject(GameObject &object);
+
         const std::vector<std::shared_ptr<GameObject> > &getGameObjects() const { return m_gameObjects; }
 
+        // Bumped whenever a static object is added or removed, so baked batches know to rebuild
+        uint64_t getStaticRevision() const { return m_staticRevision; }
+
         void setActiveCamera(Camera *camera) { m_activeCamera = camera; }
         Camera *getActiveCamera() const { return m_activeCamera; }
 
+        // The cow the player controls, if the scene has one
+        Cow *getMainCow() const;
+
+        // Transforms of every object in the scene
+        TransformStore &getTransformStore() { return m_transforms; }
+
+        // Simulation state of every cow in the scene, ticked in bulk by update()
+        CowStore &getCowStore() { return m_cowStore; }
+        const CowStore &getCowStore() const { return m_cowStore; }
+
+        // Proximity queries on the ground (XY) plane over every object with bounds.
+        // Each object is indexed by a circle around its position that holds its
+        // bounds, so results can include objects whose bounds just miss; moving
+        // objects get some slack, and are re-filed at the end of an update only
+        // once they leave their circle. Parented transforms are placed by their
+        // local position. Results are cleared first.
+        void queryRadius(const glm::vec2 &center, float radius, std::vector<GameObject *> &result) const;
+
+        void queryBox(const glm::vec2 &min, const glm::vec2 &max, std::vector<GameObject *> &result) const;
+
+        // The count objects nearest the point, nearest first
+        void queryNearest(const glm::vec2 &point, size_t count, std::vector<GameObject *> &result) const;
+
+        const SpatialHash &getSpatialIndex() const { return m_spatialIndex; }
+
+        // Collision boxes of every solid object, brought up to date at the start
+        // of each update; static objects are taken where they were put
+        const CollisionWorld &getCollisionWorld() const { return m_collision; }
+
         void addLight(std::shared_ptr<Light> light);
 
         const std::vector<std::shared_ptr<Light> > &getLights() const { return m_lights; }
 
     private:
+        // Objects whose updates do not conflict, in scene order
+        struct UpdatePhase {
+            UpdateAccess access{Systems::NONE, Systems::NONE};
+            std::vector<GameObject *> objects;
+        };
+
+        // Registry entry; the generation moves on whenever the slot's object is removed
+        struct Slot {
+            std::shared_ptr<GameObject> object;
+            uint32_t generation = 1;
+
+            // Row in m_movingIndexed, if the object is indexed and can move
+            uint32_t movingRow = UINT32_MAX;
+        };
+
+        // An indexed object that is not static, with the circle it was last filed by
+        struct MovingIndexed {
+            const Transform *transform = nullptr;
+            uint32_t slot = 0;
+            uint32_t revision = 0;
+
+            // Distance from the position to the local bounds' centre, plus their radius
+            float reach = 0.0f;
+
+            float x = 0.0f;
+            float y = 0.0f;
+            float radius = 0.0f;
+        };
+
+        Handle<GameObject> registerGameObject(std::shared_ptr<GameObject> object);
+
+        // Frees the slot and drops the object from the name index and the camera
+        void unregisterGameObject(uint32_t index);
+
+        template<typename T>
+        Handle<T> castHandle(Handle<GameObject> handle) const {
+            if (!dynamic_cast<T *>(get(handle))) return Handle<T>();
+            return Handle<T>(handle.getIndex(), handle.getGeneration());
+        }
+
+        GameObject *resolve(uint32_t index, uint32_t generation) const {
+            return index < m_slots.size() && m_slots[index].generation == generation ? m_slots[index].object.get() : nullptr;
+        }
+
+        // First live slot indexed under the name, or the end of the registry
+        uint32_t findSlot(const std::string &name) const;
+
+        uint32_t findSlot(uint32_t nameId) const;
+
+        // The name's id, handing out the next one for a new name
+        uint32_t internName(const std::string &name);
+
+        // Files the object's slot under its interned name
+        void indexName(uint32_t index);
+
+        void unindexName(uint32_t index);
+
+        // Files the object in the spatial index, if it has bounds
+        void indexGameObject(uint32_t index);
+
+        void unindexGameObject(uint32_t index);
+
+        // Re-files the objects whose transforms changed since they were last filed
+        void updateSpatialIndex();
+
+        // Slot objects of the ids, in order
+        void resolveAll(const std::vector<uint32_t> &ids, std::vector<GameObject *> &result) const;
+
         void createDefaultScene();
 
-        void handleCameraControls(float deltaTime);
+        // Each object goes into the phase after the last one it conflicts with, so
+        // conflicting updates keep their scene order
+        void buildUpdatePhases();
+
+        void handleCameraControls(const FrameContext &context);
         std::unique_ptr<Camera> m_camera;
         std::vector<std::shared_ptr<GameObject> > m_gameObjects;
         std::vector<std::shared_ptr<Light> > m_lights;
         Camera *m_activeCamera;
-        std::shared_ptr<Cow> m_cow;
+        Handle<Cow> m_mainCow;
+
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_freeSlots;
+
+        // Every name given to an object so far; ids are never reused
+        std::unordered_map<std::string, uint32_t> m_nameIds;
+
+        // Slots of every name id, in the order the objects were added
+        std::vector<std::vector<uint32_t> > m_nameIndex;
+        uint64_t m_staticRevision;
+
+        TransformStore m_transforms;
+        CowStore m_cowStore;
+
+        // Keyed by slot index
+        SpatialHash m_spatialIndex;
+        std::vector<MovingIndexed> m_movingIndexed;
+
+        CollisionWorld m_collision;
+
+        JobSystem *m_jobSystem;
+        std::vector<UpdatePhase> m_updatePhases;
+        bool m_updatePhasesDirty;
+
+        mutable std::mutex m_structureMutex;
+
+        // State of the last capture, which becomes the previous state of the next
+        std::vector<ObjectState> m_capturedObjects;
+        CameraState m_capturedCamera;
+        bool m_hasCapture;
     };
 } // namespace CowGL
 
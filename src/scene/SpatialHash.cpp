@@ -0,0 +1,325 @@
+//==============================================================================
+// File: scene/SpatialHash.cpp
+// Purpose: Uniform grid over the ground plane for proximity and region queries
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "scene/SpatialHash.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace CowGL {
+    namespace {
+        // Keeps cell coordinates, and sums of two of them, within 32 bits
+        const float CELL_LIMIT = 1073741824.0f;
+
+        const size_t INITIAL_TABLE_SIZE = 64;
+
+        // Nearest-query heap, kept per thread so warm queries allocate nothing
+        thread_local std::vector<std::pair<float, uint32_t> > t_nearest;
+
+        size_t hashCell(uint64_t key) {
+            return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 16);
+        }
+    }
+
+    SpatialHash::SpatialHash(float cellSize)
+        : m_cellSize(cellSize)
+          , m_inverseCellSize(1.0f / cellSize) {
+    }
+
+    void SpatialHash::insert(uint32_t id, float x, float y, float radius) {
+        if (id >= m_entries.size()) {
+            m_entries.resize(id + 1);
+        }
+
+        if (m_entries[id].live) {
+            if (move(id, x, y, radius)) {
+                relink(id);
+            }
+            return;
+        }
+
+        m_entries[id].live = true;
+        ++m_count;
+        link(Item{x, y, radius, id});
+    }
+
+    void SpatialHash::remove(uint32_t id) {
+        if (!contains(id)) return;
+
+        unlink(id);
+        m_entries[id].live = false;
+        --m_count;
+    }
+
+    bool SpatialHash::move(uint32_t id, float x, float y, float radius) {
+        const Entry &entry = m_entries[id];
+        Item &item = (*entry.cell)[entry.position];
+        item.x = x;
+        item.y = y;
+        item.radius = radius;
+
+        bool oversized = radius > m_cellSize;
+        if (oversized != entry.oversized) return true;
+        if (oversized) return false;
+
+        // A radius past the largest one seen must widen every query, which relink does
+        return radius > m_maxRadius || toCell(x) != entry.cellX || toCell(y) != entry.cellY;
+    }
+
+    void SpatialHash::relink(uint32_t id) {
+        link(unlink(id));
+    }
+
+    int32_t SpatialHash::toCell(float coordinate) const {
+        float cell = std::floor(coordinate * m_inverseCellSize);
+        return static_cast<int32_t>(std::max(-CELL_LIMIT, std::min(cell, CELL_LIMIT)));
+    }
+
+    const SpatialHash::Cell *SpatialHash::findCell(int32_t cellX, int32_t cellY) const {
+        if (m_table.empty()) return nullptr;
+
+        uint64_t key = cellKey(cellX, cellY);
+        size_t mask = m_table.size() - 1;
+        for (size_t i = hashCell(key) & mask; m_table[i].used; i = (i + 1) & mask) {
+            if (m_table[i].key == key) return &m_table[i].items;
+        }
+        return nullptr;
+    }
+
+    SpatialHash::Cell &SpatialHash::getCell(int32_t cellX, int32_t cellY) {
+        // At most half full, so probes stay short
+        if ((m_cellCount + 1) * 2 > m_table.size()) {
+            growTable();
+        }
+
+        uint64_t key = cellKey(cellX, cellY);
+        size_t mask = m_table.size() - 1;
+        size_t i = hashCell(key) & mask;
+        for (; m_table[i].used; i = (i + 1) & mask) {
+            if (m_table[i].key == key) return m_table[i].items;
+        }
+
+        m_table[i].key = key;
+        m_table[i].used = true;
+        ++m_cellCount;
+        return m_table[i].items;
+    }
+
+    void SpatialHash::growTable() {
+        std::vector<CellSlot> old;
+        old.swap(m_table);
+        m_table.resize(old.empty() ? INITIAL_TABLE_SIZE : old.size() * 2);
+
+        size_t mask = m_table.size() - 1;
+        for (CellSlot &slot: old) {
+            if (!slot.used) continue;
+
+            size_t i = hashCell(slot.key) & mask;
+            while (m_table[i].used) {
+                i = (i + 1) & mask;
+            }
+            m_table[i].key = slot.key;
+            m_table[i].used = true;
+            m_table[i].items.swap(slot.items);
+            for (const Item &item: m_table[i].items) {
+                m_entries[item.id].cell = &m_table[i].items;
+            }
+        }
+    }
+
+    void SpatialHash::link(const Item &item) {
+        Entry &entry = m_entries[item.id];
+        entry.oversized = item.radius > m_cellSize;
+        if (entry.oversized) {
+            entry.cell = &m_oversized;
+        } else {
+            entry.cellX = toCell(item.x);
+            entry.cellY = toCell(item.y);
+            entry.cell = &getCell(entry.cellX, entry.cellY);
+
+            m_maxRadius = std::max(m_maxRadius, item.radius);
+            if (m_maxCellX < m_minCellX) {
+                m_minCellX = m_maxCellX = entry.cellX;
+                m_minCellY = m_maxCellY = entry.cellY;
+            } else {
+                m_minCellX = std::min(m_minCellX, entry.cellX);
+                m_minCellY = std::min(m_minCellY, entry.cellY);
+                m_maxCellX = std::max(m_maxCellX, entry.cellX);
+                m_maxCellY = std::max(m_maxCellY, entry.cellY);
+            }
+        }
+
+        entry.position = static_cast<uint32_t>(entry.cell->size());
+        entry.cell->push_back(item);
+    }
+
+    SpatialHash::Item SpatialHash::unlink(uint32_t id) {
+        const Entry &entry = m_entries[id];
+        Cell &list = *entry.cell;
+        Item item = list[entry.position];
+
+        // Move the last item of the list into the hole
+        list[entry.position] = list.back();
+        m_entries[list.back().id].position = entry.position;
+        list.pop_back();
+        return item;
+    }
+
+    template<typename Visit>
+    void SpatialHash::forEachInCells(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, Visit visit) const {
+        minX = std::max(minX, m_minCellX);
+        minY = std::max(minY, m_minCellY);
+        maxX = std::min(maxX, m_maxCellX);
+        maxY = std::min(maxY, m_maxCellY);
+        if (minX > maxX || minY > maxY) return;
+
+        // A range wider than the cells in use is cheaper to cover by walking the cells
+        double area = (static_cast<double>(maxX) - minX + 1.0) * (static_cast<double>(maxY) - minY + 1.0);
+        if (area > static_cast<double>(m_cellCount)) {
+            for (const CellSlot &slot: m_table) {
+                if (!slot.used) continue;
+
+                int32_t cellX = static_cast<int32_t>(static_cast<uint32_t>(slot.key >> 32));
+                int32_t cellY = static_cast<int32_t>(static_cast<uint32_t>(slot.key));
+                if (cellX < minX || cellX > maxX || cellY < minY || cellY > maxY) continue;
+                for (const Item &item: slot.items) {
+                    visit(item);
+                }
+            }
+            return;
+        }
+
+        for (int32_t cellY = minY; cellY <= maxY; ++cellY) {
+            for (int32_t cellX = minX; cellX <= maxX; ++cellX) {
+                const Cell *cell = findCell(cellX, cellY);
+                if (!cell) continue;
+                for (const Item &item: *cell) {
+                    visit(item);
+                }
+            }
+        }
+    }
+
+    void SpatialHash::queryRadius(float x, float y, float radius, std::vector<uint32_t> &result) const {
+        auto test = [x, y, radius, &result](const Item &item) {
+            float dx = item.x - x;
+            float dy = item.y - y;
+            float reach = radius + item.radius;
+            if (dx * dx + dy * dy <= reach * reach) {
+                result.push_back(item.id);
+            }
+        };
+
+        float reach = radius + m_maxRadius;
+        forEachInCells(toCell(x - reach), toCell(y - reach), toCell(x + reach), toCell(y + reach), test);
+        for (const Item &item: m_oversized) {
+            test(item);
+        }
+    }
+
+    void SpatialHash::queryBox(float minX, float minY, float maxX, float maxY, std::vector<uint32_t> &result) const {
+        auto test = [minX, minY, maxX, maxY, &result](const Item &item) {
+            float dx = item.x - std::max(minX, std::min(item.x, maxX));
+            float dy = item.y - std::max(minY, std::min(item.y, maxY));
+            if (dx * dx + dy * dy <= item.radius * item.radius) {
+                result.push_back(item.id);
+            }
+        };
+
+        forEachInCells(toCell(minX - m_maxRadius), toCell(minY - m_maxRadius),
+                       toCell(maxX + m_maxRadius), toCell(maxY + m_maxRadius), test);
+        for (const Item &item: m_oversized) {
+            test(item);
+        }
+    }
+
+    void SpatialHash::queryNearest(float x, float y, size_t count, std::vector<uint32_t> &result) const {
+        if (count == 0 || m_count == 0) return;
+
+        // A max-heap of the nearest so far by squared distance, the farthest on top
+        std::vector<std::pair<float, uint32_t> > &best = t_nearest;
+        best.clear();
+        auto consider = [x, y, count, &best](const Item &item) {
+            float dx = item.x - x;
+            float dy = item.y - y;
+            std::pair<float, uint32_t> candidate(dx * dx + dy * dy, item.id);
+            if (best.size() < count) {
+                best.push_back(candidate);
+                std::push_heap(best.begin(), best.end());
+            } else if (candidate < best.front()) {
+                std::pop_heap(best.begin(), best.end());
+                best.back() = candidate;
+                std::push_heap(best.begin(), best.end());
+            }
+        };
+
+        for (const Item &item: m_oversized) {
+            consider(item);
+        }
+
+        // Walk square rings of cells outwards from the point's cell. Centres in
+        // ring r are at least r - 1 cells plus the way out of the point's own cell away.
+        int64_t centerX = toCell(x);
+        int64_t centerY = toCell(y);
+        float inner = std::max(0.0f, std::min({
+            x - centerX * m_cellSize, (centerX + 1) * m_cellSize - x,
+            y - centerY * m_cellSize, (centerY + 1) * m_cellSize - y
+        }));
+
+        auto visitCell = [this, &consider](int64_t cellX, int64_t cellY) {
+            const Cell *cell = findCell(static_cast<int32_t>(cellX), static_cast<int32_t>(cellY));
+            if (!cell) return;
+            for (const Item &item: *cell) {
+                consider(item);
+            }
+        };
+        auto visitRow = [this, &visitCell](int64_t cellY, int64_t fromX, int64_t toX) {
+            if (cellY < m_minCellY || cellY > m_maxCellY) return;
+            for (int64_t cellX = std::max<int64_t>(fromX, m_minCellX); cellX <= std::min<int64_t>(toX, m_maxCellX); ++cellX) {
+                visitCell(cellX, cellY);
+            }
+        };
+        auto visitColumn = [this, &visitCell](int64_t cellX, int64_t fromY, int64_t toY) {
+            if (cellX < m_minCellX || cellX > m_maxCellX) return;
+            for (int64_t cellY = std::max<int64_t>(fromY, m_minCellY); cellY <= std::min<int64_t>(toY, m_maxCellY); ++cellY) {
+                visitCell(cellX, cellY);
+            }
+        };
+
+        // Rings short of the cells in use are empty
+        int64_t firstRing = std::max({
+            int64_t(0), m_minCellX - centerX, centerX - m_maxCellX, m_minCellY - centerY, centerY - m_maxCellY
+        });
+
+        for (int64_t ring = firstRing; ; ++ring) {
+            if (ring > 0 && best.size() == count) {
+                float bound = (ring - 1) * m_cellSize + inner;
+                if (bound * bound >= best.front().first) break;
+            }
+
+            // Every cell in use was visited
+            if (centerX - ring < m_minCellX && centerX + ring > m_maxCellX &&
+                centerY - ring < m_minCellY && centerY + ring > m_maxCellY) {
+                break;
+            }
+
+            if (ring == 0) {
+                visitCell(centerX, centerY);
+                continue;
+            }
+            visitRow(centerY - ring, centerX - ring, centerX + ring);
+            visitRow(centerY + ring, centerX - ring, centerX + ring);
+            visitColumn(centerX - ring, centerY - ring + 1, centerY + ring - 1);
+            visitColumn(centerX + ring, centerY - ring + 1, centerY + ring - 1);
+        }
+
+        std::sort_heap(best.begin(), best.end());
+        for (const auto &candidate: best) {
+            result.push_back(candidate.second);
+        }
+    }
+} // namespace CowGL
@@ -0,0 +1,129 @@
+//==============================================================================
+// File: scene/SpatialHash.h
+// Purpose: Uniform grid over the ground plane for proximity and region queries
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace CowGL {
+    // Circles on the XY plane, filed under the grid cell holding their centre in
+    // a hash of cells, so queries visit the few cells around them rather than
+    // every circle. Cells are loose: a circle may reach past its cell by up to
+    // the cell size, and queries widen their search by the largest radius seen.
+    // Circles bigger than a cell are kept aside and tested by every query.
+    // Ids are chosen by the caller and index a flat table, so keep them dense.
+    class SpatialHash {
+    public:
+        explicit SpatialHash(float cellSize);
+
+        SpatialHash(const SpatialHash &) = delete;
+
+        SpatialHash &operator=(const SpatialHash &) = delete;
+
+        void insert(uint32_t id, float x, float y, float radius);
+
+        void remove(uint32_t id);
+
+        // Moves the circle. Returns true when it now belongs to another cell, which
+        // only takes effect on relink(); in between, queries may miss it. Calls for
+        // different ids may run concurrently, relink calls may not.
+        bool move(uint32_t id, float x, float y, float radius);
+
+        void relink(uint32_t id);
+
+        bool contains(uint32_t id) const { return id < m_entries.size() && m_entries[id].live; }
+
+        size_t size() const { return m_count; }
+
+        float getCellSize() const { return m_cellSize; }
+
+        // Appends the ids of circles overlapping the query circle
+        void queryRadius(float x, float y, float radius, std::vector<uint32_t> &result) const;
+
+        // Appends the ids of circles overlapping the box
+        void queryBox(float minX, float minY, float maxX, float maxY, std::vector<uint32_t> &result) const;
+
+        // Appends the ids of the count circles whose centres are nearest the point, nearest first
+        void queryNearest(float x, float y, size_t count, std::vector<uint32_t> &result) const;
+
+    private:
+        // A circle as its cell stores it, so queries read cells front to back
+        struct Item {
+            float x;
+            float y;
+            float radius;
+            uint32_t id;
+        };
+
+        using Cell = std::vector<Item>;
+
+        struct Entry {
+            // The list holding the item; moved along when the table grows
+            Cell *cell = nullptr;
+            uint32_t position = 0;
+            int32_t cellX = 0;
+            int32_t cellY = 0;
+            bool oversized = false;
+            bool live = false;
+        };
+
+        // Open-addressed, so finding a cell is one probe rather than a chain of nodes
+        struct CellSlot {
+            uint64_t key = 0;
+            bool used = false;
+            Cell items;
+        };
+
+        int32_t toCell(float coordinate) const;
+
+        static uint64_t cellKey(int32_t cellX, int32_t cellY) {
+            return static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32 | static_cast<uint32_t>(cellY);
+        }
+
+        const Cell *findCell(int32_t cellX, int32_t cellY) const;
+
+        // Finds or adds the cell
+        Cell &getCell(int32_t cellX, int32_t cellY);
+
+        // Doubles the table and points the entries at their cells' new places
+        void growTable();
+
+        // Files the item under its coordinates
+        void link(const Item &item);
+
+        // Takes the entry's item out of its list
+        Item unlink(uint32_t id);
+
+        // Calls visit(item) for every item filed in cells overlapping the range, in any order
+        template<typename Visit>
+        void forEachInCells(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, Visit visit) const;
+
+        float m_cellSize;
+        float m_inverseCellSize;
+
+        std::vector<Entry> m_entries;
+        std::vector<CellSlot> m_table;
+        size_t m_cellCount = 0;
+        Cell m_oversized;
+        size_t m_count = 0;
+
+        // Largest radius filed in a cell; grows only
+        float m_maxRadius = 0.0f;
+
+        // Cells that ever held an entry lie within these; they grow only
+        int32_t m_minCellX = 0;
+        int32_t m_minCellY = 0;
+        int32_t m_maxCellX = -1;
+        int32_t m_maxCellY = -1;
+    };
+} // namespace CowGL
+
+
+#endif //SPATIALHASH_H
@@ -8,14 +8,69 @@
 
 namespace CowGL {
     Transform::Transform()
-        : m_position(0.0f, 0.0f, 0.0f)
-          , m_rotation(0.0f, 0.0f, 0.0f)
-          , m_scale(1.0f, 1.0f, 1.0f) {
+        : m_slot(NO_SLOT)
+          , m_localRevision(0)
+          , m_worldRevision(0)
+          , m_localValid(false)
+          , m_worldValid(false)
+          , m_worldVersion(0)
+          , m_parentWorldVersion(0)
+          , m_parent(nullptr)
+          , m_ownPosition(0.0f, 0.0f, 0.0f)
+          , m_ownRotation(0.0f, 0.0f, 0.0f)
+          , m_ownScale(1.0f, 1.0f, 1.0f)
+          , m_ownRevision(0) {
+        useOwnState();
+    }
+
+    Transform::Transform(const Transform &other)
+        : m_slot(NO_SLOT)
+          , m_localRevision(other.m_localRevision)
+          , m_worldRevision(other.m_worldRevision)
+          , m_localValid(other.m_localValid)
+          , m_worldValid(other.m_worldValid)
+          , m_worldVersion(other.m_worldVersion)
+          , m_parentWorldVersion(other.m_parentWorldVersion)
+          , m_parent(other.m_parent)
+          , m_localMatrix(other.m_localMatrix)
+          , m_worldMatrix(other.m_worldMatrix)
+          , m_ownPosition(*other.m_position)
+          , m_ownRotation(*other.m_rotation)
+          , m_ownScale(*other.m_scale)
+          , m_ownRevision(*other.m_revision) {
+        useOwnState();
+    }
+
+    Transform &Transform::operator=(const Transform &other) {
+        if (this == &other) return *this;
+
+        *m_position = *other.m_position;
+        *m_rotation = *other.m_rotation;
+        *m_scale = *other.m_scale;
+        *m_revision = *other.m_revision;
+
+        m_localRevision = other.m_localRevision;
+        m_worldRevision = other.m_worldRevision;
+        m_localValid = other.m_localValid;
+        m_worldValid = other.m_worldValid;
+        m_worldVersion = other.m_worldVersion;
+        m_parentWorldVersion = other.m_parentWorldVersion;
+        m_parent = other.m_parent;
+        m_localMatrix = other.m_localMatrix;
+        m_worldMatrix = other.m_worldMatrix;
+        return *this;
+    }
+
+    void Transform::useOwnState() {
+        m_position = &m_ownPosition;
+        m_rotation = &m_ownRotation;
+        m_scale = &m_ownScale;
+        m_revision = &m_ownRevision;
     }
 
     glm::vec3 Transform::getForward() const {
-        float yaw = glm::radians(m_rotation.z);
-        float pitch = glm::radians(m_rotation.x);
+        float yaw = glm::radians(m_rotation->z);
+        float pitch = glm::radians(m_rotation->x);
 
         return glm::vec3(
             std::cos(yaw) * std::cos(pitch),
@@ -25,7 +80,7 @@ namespace CowGL {
     }
 
     glm::vec3 Transform::getRight() const {
-        float yaw = glm::radians(m_rotation.z + 90.0f);
+        float yaw = glm::radians(m_rotation->z + 90.0f);
 
         return glm::vec3(
             std::cos(yaw),
@@ -37,4 +92,37 @@ namespace CowGL {
     glm::vec3 Transform::getUp() const {
         return glm::vec3(0.0f, 0.0f, 1.0f);
     }
+
+    const glm::mat4 &Transform::getMatrix() const {
+        uint32_t revision = *m_revision;
+        if (!m_localValid || m_localRevision != revision) {
+            const glm::vec3 &rotation = *m_rotation;
+            m_localMatrix = glm::mat4::translate(*m_position) *
+                            glm::mat4::rotate(glm::radians(rotation.z), glm::vec3(0.0f, 0.0f, 1.0f)) *
+                            glm::mat4::rotate(glm::radians(rotation.y), glm::vec3(0.0f, 1.0f, 0.0f)) *
+                            glm::mat4::rotate(glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f)) *
+                            glm::mat4::scale(*m_scale);
+            m_localRevision = revision;
+            m_localValid = true;
+
+            // A root's world matrix is its local one
+            if (!m_parent) ++m_worldVersion;
+        }
+        return m_localMatrix;
+    }
+
+    const glm::mat4 &Transform::getWorldMatrix() const {
+        if (!m_parent) return getMatrix();
+
+        const glm::mat4 &parentWorld = m_parent->getWorldMatrix();
+        uint32_t revision = *m_revision;
+        if (!m_worldValid || m_worldRevision != revision || m_parentWorldVersion != m_parent->m_worldVersion) {
+            m_worldMatrix = parentWorld * getMatrix();
+            m_parentWorldVersion = m_parent->m_worldVersion;
+            m_worldRevision = revision;
+            m_worldValid = true;
+            ++m_worldVersion;
+        }
+        return m_worldMatrix;
+    }
 } // namespace CowGL
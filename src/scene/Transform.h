@@ -10,29 +10,82 @@
 
 
 #include "utils/Math.h"
+#include <cstdint>
 
 namespace CowGL {
+    class TransformStore;
+
+    // Position, rotation and scale relative to an optional parent transform.
+    // Inside a scene those live in the scene's transform store, one dense
+    // column per field, so systems moving many objects stream through the
+    // columns; the transform itself keeps the parent link and the cached
+    // matrices. Outside a scene it keeps its own copy of them.
+    // The local matrix and the world matrix (the parent's world matrix times
+    // the local one) are rebuilt when the revision moved since they were built,
+    // or when the parent's world matrix was rebuilt.
     class Transform {
     public:
         Transform();
 
+        // Copies keep their values themselves, outside any store
+        Transform(const Transform &other);
+
+        // Writes the values wherever this transform keeps them
+        Transform &operator=(const Transform &other);
+
         ~Transform() = default;
 
         // Position
-        const glm::vec3 &getPosition() const { return m_position; }
-        glm::vec3 &getPositionRef() { return m_position; }
-        void setPosition(const glm::vec3 &position) { m_position = position; }
-        void translate(const glm::vec3 &delta) { m_position = m_position + delta; }
+        const glm::vec3 &getPosition() const { return *m_position; }
+        glm::vec3 &getPositionRef() { return *m_position; }
+        void setPosition(const glm::vec3 &position) {
+            *m_position = position;
+            ++*m_revision;
+        }
+
+        void translate(const glm::vec3 &delta) {
+            *m_position = *m_position + delta;
+            ++*m_revision;
+        }
 
         // Rotation (Euler angles in degrees)
-        const glm::vec3 &getRotation() const { return m_rotation; }
-        void setRotation(const glm::vec3 &rotation) { m_rotation = rotation; }
-        void rotate(const glm::vec3 &delta) { m_rotation = m_rotation + delta; }
+        const glm::vec3 &getRotation() const { return *m_rotation; }
+        void setRotation(const glm::vec3 &rotation) {
+            *m_rotation = rotation;
+            ++*m_revision;
+        }
+
+        void rotate(const glm::vec3 &delta) {
+            *m_rotation = *m_rotation + delta;
+            ++*m_revision;
+        }
 
         // Scale
-        const glm::vec3 &getScale() const { return m_scale; }
-        void setScale(const glm::vec3 &scale) { m_scale = scale; }
-        void setUniformScale(float scale) { m_scale = glm::vec3(scale); }
+        const glm::vec3 &getScale() const { return *m_scale; }
+        void setScale(const glm::vec3 &scale) {
+            *m_scale = scale;
+            ++*m_revision;
+        }
+
+        void setUniformScale(float scale) { setScale(glm::vec3(scale)); }
+
+        // Bumped by every setter, and by systems writing the store's columns;
+        // writes through getPositionRef() are neither tracked nor seen by the
+        // cached matrices
+        uint32_t getRevision() const { return *m_revision; }
+
+        // Slot in the scene's transform store; NO_SLOT outside a scene
+        static const uint32_t NO_SLOT = UINT32_MAX;
+        uint32_t getSlot() const { return m_slot; }
+
+        // Null for a root. The parent must outlive the link, and copies share it.
+        const Transform *getParent() const { return m_parent; }
+
+        void setParent(const Transform *parent) {
+            m_parent = parent;
+            m_worldValid = false;
+            ++m_worldVersion;
+        }
 
         // Direction vectors
         glm::vec3 getForward() const;
@@ -41,10 +94,46 @@ namespace CowGL {
 
         glm::vec3 getUp() const;
 
+        // Translate * RotateZ * RotateY * RotateX * Scale, relative to the parent
+        const glm::mat4 &getMatrix() const;
+
+        // The local matrix placed in the parent's world; the local one for a root
+        const glm::mat4 &getWorldMatrix() const;
+
     private:
-        glm::vec3 m_position;
-        glm::vec3 m_rotation; // Euler angles in degrees
-        glm::vec3 m_scale;
+        friend class TransformStore;
+
+        // Points the fields at the transform's own copy
+        void useOwnState();
+
+        // Where the fields live: the own copy below, or a store slot's columns
+        glm::vec3 *m_position;
+        glm::vec3 *m_rotation;
+        glm::vec3 *m_scale;
+        uint32_t *m_revision;
+        uint32_t m_slot;
+
+        // Revisions the cached matrices were built at
+        mutable uint32_t m_localRevision;
+        mutable uint32_t m_worldRevision;
+        mutable bool m_localValid;
+        mutable bool m_worldValid;
+
+        // Bumped whenever the world matrix is rebuilt, so children know theirs is stale
+        mutable uint32_t m_worldVersion;
+        mutable uint32_t m_parentWorldVersion;
+
+        const Transform *m_parent;
+
+        // Filled in on first use after a change, by whichever thread owns the transform
+        mutable glm::mat4 m_localMatrix;
+        mutable glm::mat4 m_worldMatrix;
+
+        // The values while outside a store
+        glm::vec3 m_ownPosition;
+        glm::vec3 m_ownRotation; // Euler angles in degrees
+        glm::vec3 m_ownScale;
+        uint32_t m_ownRevision;
     };
 } // namespace CowGL
 
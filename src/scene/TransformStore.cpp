@@ -0,0 +1,46 @@
+//==============================================================================
+// File: scene/TransformStore.cpp
+// Purpose: Dense storage for the transforms of a scene's objects
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#include "scene/TransformStore.h"
+
+namespace CowGL {
+    void TransformStore::attach(Transform &transform) {
+        uint32_t slot;
+        if (!m_free.empty()) {
+            slot = m_free.back();
+            m_free.pop_back();
+        } else {
+            if (m_used == m_blocks.size() * BLOCK_SIZE) {
+                m_blocks.push_back(std::make_unique<Block>());
+            }
+            slot = m_used++;
+        }
+
+        Block &columns = block(slot);
+        uint32_t index = slot % BLOCK_SIZE;
+        columns.positions[index] = transform.getPosition();
+        columns.rotations[index] = transform.getRotation();
+        columns.scales[index] = transform.getScale();
+        columns.revisions[index] = transform.getRevision();
+
+        transform.m_position = &columns.positions[index];
+        transform.m_rotation = &columns.rotations[index];
+        transform.m_scale = &columns.scales[index];
+        transform.m_revision = &columns.revisions[index];
+        transform.m_slot = slot;
+    }
+
+    void TransformStore::detach(Transform &transform) {
+        transform.m_ownPosition = transform.getPosition();
+        transform.m_ownRotation = transform.getRotation();
+        transform.m_ownScale = transform.getScale();
+        transform.m_ownRevision = transform.getRevision();
+        transform.useOwnState();
+
+        m_free.push_back(transform.m_slot);
+        transform.m_slot = Transform::NO_SLOT;
+    }
+} // namespace CowGL
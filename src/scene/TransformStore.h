@@ -0,0 +1,81 @@
+//==============================================================================
+// File: scene/TransformStore.h
+// Purpose: Dense storage for the transforms of a scene's objects
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef TRANSFORMSTORE_H
+#define TRANSFORMSTORE_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "scene/Transform.h"
+
+namespace CowGL {
+    // Positions, rotations, scales and revisions of every transform in a
+    // scene, one column per field, so systems that move many objects stream
+    // through just the fields they use. Columns grow in fixed-size blocks and
+    // slots never move while in use, so transforms and the camera can point
+    // into them; freed slots are handed out again first.
+    class TransformStore {
+    public:
+        TransformStore() = default;
+
+        TransformStore(const TransformStore &) = delete;
+
+        TransformStore &operator=(const TransformStore &) = delete;
+
+        // Moves the transform's values into a free slot, where it reads and writes them from then on
+        void attach(Transform &transform);
+
+        // Moves the values back into the transform and frees its slot
+        void detach(Transform &transform);
+
+        // Slots in use
+        size_t size() const { return m_used - m_free.size(); }
+
+        // Column access for systems. Writes go through translate and rotate,
+        // which bump the revision so the transform's cached matrices notice.
+        const glm::vec3 &getPosition(uint32_t slot) const { return block(slot).positions[slot % BLOCK_SIZE]; }
+        const glm::vec3 &getRotation(uint32_t slot) const { return block(slot).rotations[slot % BLOCK_SIZE]; }
+
+        void translate(uint32_t slot, const glm::vec3 &delta) {
+            Block &columns = block(slot);
+            glm::vec3 &position = columns.positions[slot % BLOCK_SIZE];
+            position = position + delta;
+            ++columns.revisions[slot % BLOCK_SIZE];
+        }
+
+        void rotate(uint32_t slot, const glm::vec3 &delta) {
+            Block &columns = block(slot);
+            glm::vec3 &rotation = columns.rotations[slot % BLOCK_SIZE];
+            rotation = rotation + delta;
+            ++columns.revisions[slot % BLOCK_SIZE];
+        }
+
+    private:
+        static const uint32_t BLOCK_SIZE = 4096;
+
+        struct Block {
+            glm::vec3 positions[BLOCK_SIZE];
+            glm::vec3 rotations[BLOCK_SIZE];
+            glm::vec3 scales[BLOCK_SIZE];
+            uint32_t revisions[BLOCK_SIZE];
+        };
+
+        Block &block(uint32_t slot) { return *m_blocks[slot / BLOCK_SIZE]; }
+        const Block &block(uint32_t slot) const { return *m_blocks[slot / BLOCK_SIZE]; }
+
+        std::vector<std::unique_ptr<Block> > m_blocks;
+        std::vector<uint32_t> m_free;
+
+        // Slots handed out from the blocks so far, freed ones included
+        uint32_t m_used = 0;
+    };
+} // namespace CowGL
+
+
+#endif //TRANSFORMSTORE_H
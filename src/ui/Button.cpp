@@ -6,11 +6,9 @@
 
 
 #include "ui/Button.h"
-#include "core/Application.h"
+#include "core/FrameContext.h"
 #include "core/Input.h"
-#include "core/Window.h"
-#include <GLUT/glut.h>
-#include <OpenGL/gl.h>
+#include "utils/OpenGL.h"
 
 namespace CowGL {
     Button::Button(const std::string &label, int x, int y, int width, int height)
@@ -23,12 +21,12 @@ namespace CowGL {
           , m_pressed(false) {
     }
 
-    void Button::update() {
-        Input *input = Application::getInstance()->getInput();
-        Window *window = Application::getInstance()->getWindow();
+    void Button::update(const FrameContext &context) {
+        const Input *input = context.input;
+        if (!input) return;
 
         glm::vec2 mousePos = input->getMousePosition();
-        int windowHeight = window->getHeight();
+        int windowHeight = context.height;
 
         // Mouse coordinates are already in window space (0,0 is top-left)
         // Button coordinates are in OpenGL space (0,0 is bottom-left)
@@ -9,9 +9,12 @@
 
 #include <string>
 #include <functional>
+#include <atomic>
 #include "utils/Math.h"
 
 namespace CowGL {
+    struct FrameContext;
+
     class Button {
     public:
         using Callback = std::function<void()>;
@@ -20,7 +23,7 @@ namespace CowGL {
 
         ~Button() = default;
 
-        void update();
+        void update(const FrameContext &context);
 
         void render();
 
@@ -47,11 +50,13 @@ namespace CowGL {
 
     private:
         std::string m_label;
-        int m_x, m_y;
+
+        // Updated by the simulation thread, drawn by the render thread
+        std::atomic<int> m_x, m_y;
         int m_width, m_height;
         Callback m_callback;
-        bool m_hovered;
-        bool m_pressed;
+        std::atomic<bool> m_hovered;
+        std::atomic<bool> m_pressed;
     };
 } // namespace CowGL
 #endif //BUTTON_H
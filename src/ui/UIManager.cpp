@@ -8,13 +8,13 @@
 #include "ui/Button.h"
 #include "graphics/Renderer.h"
 #include "core/Application.h"
-#include "core/Window.h"
 #include "core/Input.h"
+#include "core/Profiler.h"
 #include "scene/Scene.h"
 #include "graphics/Light.h"
+#include "scene/RenderSnapshot.h"
 
-#include <GLUT/glut.h>
-#include <OpenGL/gl.h>
+#include "utils/OpenGL.h"
 
 #include "entities/Cow.h"
 
@@ -22,69 +22,91 @@ namespace CowGL {
     UIManager::UIManager()
         : m_showHelpMenu(false)
           , m_showLightingMenu(false)
-          , m_globalAmbient(0.3f)
-          , m_sunIntensity(1.0f)
-          , m_sunAngle(45.0f) {
+          , m_revision(0)
+          , m_layoutWidth(0)
+          , m_layoutHeight(0)
+          , m_renderHelpMenu(false)
+          , m_renderLightingMenu(false) {
     }
 
     UIManager::~UIManager() = default;
 
-    void UIManager::initialize() {
-        createTopMenu();
+    void UIManager::initialize(int width, int height) {
+        createTopMenu(width, height);
     }
 
-    void UIManager::update(float deltaTime) {
-        Input *input = Application::getInstance()->getInput();
+    void UIManager::update(const FrameContext &context) {
+        // Follow window resizes reported by the render thread
+        if (context.width != m_layoutWidth || context.height != m_layoutHeight) {
+            updateButtonPositions(context.width, context.height);
+        }
+
+        // Menus only react to controls
+        const Input *input = context.input;
+        if (!input) return;
+
+        const bool showHelpMenu = m_showHelpMenu;
+        const bool showLightingMenu = m_showLightingMenu;
+        const LightingState lighting = m_lighting;
 
         // Check for help menu toggle ONLY if not in head control mode
-        if (!m_showHelpMenu && !m_showLightingMenu) {
+        if (!m_showHelpMenu && !m_showLightingMenu && context.scene) {
             // Only process H key for help if cow is not in head control mode
-            auto scene = Application::getInstance()->getScene();
-            auto cowObj = scene->findGameObject("MainCow");
-            if (cowObj) {
-                auto cow = std::dynamic_pointer_cast<Cow>(cowObj);
-                if (!cow || cow->getControlMode() != Cow::ControlMode::Head) {
-                    if (input->isKeyJustPressed('h') || input->isKeyJustPressed('H')) {
-                        toggleHelpMenu();
-                    }
+            const Cow *cow = context.scene->getMainCow();
+            if (cow && cow->getControlMode() != Cow::ControlMode::Head) {
+                if (input->isActionJustPressed(Action::ToggleHelp)) {
+                    toggleHelpMenu();
                 }
             }
         }
 
-        if (input->isKeyJustPressed('\r')) {
+#ifdef COWGL_PROFILER
+        if (input->isActionJustPressed(Action::ToggleProfiler)) {
+            Profiler::toggleOverlay();
+        }
+        if (input->isActionJustPressed(Action::SaveTrace) && Profiler::isTracing()) {
+            Profiler::saveTrace();
+        }
+#endif
+
+        if (input->isActionJustPressed(Action::CloseMenus)) {
             if (m_showHelpMenu) hideHelpMenu();
             if (m_showLightingMenu) hideLightingMenu();
         }
 
         // Handle lighting adjustments when menu is open
         if (m_showLightingMenu) {
-            if (input->isKeyPressed('+') || input->isKeyPressed('=')) {
-                m_globalAmbient = std::min(1.0f, m_globalAmbient + 0.02f);
+            if (input->isActionPressed(Action::AmbientUp)) {
+                m_lighting.globalAmbient = std::min(1.0f, m_lighting.globalAmbient + 0.02f);
             }
-            if (input->isKeyPressed('-') || input->isKeyPressed('_')) {
-                m_globalAmbient = std::max(0.0f, m_globalAmbient - 0.02f);
+            if (input->isActionPressed(Action::AmbientDown)) {
+                m_lighting.globalAmbient = std::max(0.0f, m_lighting.globalAmbient - 0.02f);
             }
-            if (input->isKeyPressed('[')) {
-                m_sunIntensity = std::max(0.0f, m_sunIntensity - 0.02f);
+            if (input->isActionPressed(Action::SunIntensityDown)) {
+                m_lighting.sunIntensity = std::max(0.0f, m_lighting.sunIntensity - 0.02f);
             }
-            if (input->isKeyPressed(']')) {
-                m_sunIntensity = std::min(2.0f, m_sunIntensity + 0.02f);
+            if (input->isActionPressed(Action::SunIntensityUp)) {
+                m_lighting.sunIntensity = std::min(2.0f, m_lighting.sunIntensity + 0.02f);
             }
-            if (input->isKeyPressed('<') || input->isKeyPressed(',')) {
-                m_sunAngle = std::max(-90.0f, m_sunAngle - 2.0f);
+            if (input->isActionPressed(Action::SunAngleDown)) {
+                m_lighting.sunAngle = std::max(-90.0f, m_lighting.sunAngle - 2.0f);
             }
-            if (input->isKeyPressed('>') || input->isKeyPressed('.')) {
-                m_sunAngle = std::min(90.0f, m_sunAngle + 2.0f);
+            if (input->isActionPressed(Action::SunAngleUp)) {
+                m_lighting.sunAngle = std::min(90.0f, m_lighting.sunAngle + 2.0f);
             }
         }
 
         // Update buttons
         for (auto &button: m_topMenuButtons) {
-            button->update();
+            button->update(context);
+        }
+
+        if (showHelpMenu != m_showHelpMenu || showLightingMenu != m_showLightingMenu || lighting != m_lighting) {
+            ++m_revision;
         }
     }
 
-    void UIManager::render(Renderer *renderer) {
+    void UIManager::render(Renderer *renderer, const FrameContext &context) {
         // Save current OpenGL state
         glPushAttrib(GL_ALL_ATTRIB_BITS);
         glMatrixMode(GL_PROJECTION);
@@ -93,9 +115,8 @@ namespace CowGL {
         glPushMatrix();
 
         // Set up orthographic projection for UI
-        auto window = Application::getInstance()->getWindow();
-        int width = window->getWidth();
-        int height = window->getHeight();
+        int width = context.width;
+        int height = context.height;
 
         glViewport(0, 0, width, height);
         glMatrixMode(GL_PROJECTION);
@@ -111,12 +132,18 @@ namespace CowGL {
 
         renderTopMenu();
 
-        if (m_showHelpMenu) {
-            renderHelpMenu();
+#ifdef COWGL_PROFILER
+        if (Profiler::isOverlayVisible()) {
+            renderProfilerOverlay(height);
         }
+#endif
 
-        if (m_showLightingMenu) {
-            renderLightingMenu();
+        if (m_renderHelpMenu) {
+            renderHelpMenu(width, height);
+        }
+
+        if (m_renderLightingMenu) {
+            renderLightingMenu(width, height);
         }
 
         // Restore OpenGL state
@@ -127,16 +154,14 @@ namespace CowGL {
         glPopAttrib();
     }
 
-    void UIManager::createTopMenu() {
-        auto window = Application::getInstance()->getWindow();
-        int width = window->getWidth();
-        int height = window->getHeight();
-
+    void UIManager::createTopMenu(int width, int height) {
         // Position buttons on the right side of screen, near the top
         int buttonX = width - 150; // 150 pixels from right edge
+        m_layoutWidth = width;
+        m_layoutHeight = height;
 
         auto exitButton = std::make_shared<Button>("Exit", buttonX, height - 50, 120, 35);
-        exitButton->setCallback([]() { exit(0); });
+        exitButton->setCallback([]() { Application::getInstance()->shutdown(); });
         m_topMenuButtons.push_back(exitButton);
 
         auto helpButton = std::make_shared<Button>("Help", buttonX, height - 95, 120, 35);
@@ -154,11 +179,10 @@ namespace CowGL {
         }
     }
 
-    void UIManager::updateButtonPositions() {
-        auto window = Application::getInstance()->getWindow();
-        int width = window->getWidth();
-        int height = window->getHeight();
+    void UIManager::updateButtonPositions(int width, int height) {
         int buttonX = width - 150;
+        m_layoutWidth = width;
+        m_layoutHeight = height;
 
         if (m_topMenuButtons.size() >= 3) {
             m_topMenuButtons[0]->setPosition(buttonX, height - 50); // Exit
@@ -167,13 +191,9 @@ namespace CowGL {
         }
     }
 
-    void UIManager::renderHelpMenu() {
-        auto window = Application::getInstance()->getWindow();
-        int width = window->getWidth();
-        int height = window->getHeight();
-
+    void UIManager::renderHelpMenu(int width, int height) {
         int menuWidth = 400;
-        int menuHeight = 350;
+        int menuHeight = 390;
         int x = (width - menuWidth) / 2;
         int y = (height - menuHeight) / 2;
 
@@ -237,6 +257,8 @@ namespace CowGL {
             "Toggle Camera View: V key",
             "Reset Head/Tail: R key",
             "Quit: Q key",
+            "Profiler overlay: P key",
+            "Save trace (with --trace): O key",
             "Camera controls (third person):",
             "  Numpad 8,2,4,6 - Rotate camera",
             "  Numpad 1,7 - Zoom in/out",
@@ -254,11 +276,7 @@ namespace CowGL {
         }
     }
 
-    void UIManager::renderLightingMenu() {
-        auto window = Application::getInstance()->getWindow();
-        int width = window->getWidth();
-        int height = window->getHeight();
-
+    void UIManager::renderLightingMenu(int width, int height) {
         int menuWidth = 400;
         int menuHeight = 350;
         int x = (width - menuWidth) / 2;
@@ -318,19 +336,19 @@ namespace CowGL {
         char buffer[100];
 
         glRasterPos2f(x + 50, y + 250);
-        sprintf(buffer, "Ambient Light (%.2f): Use +/- keys", m_globalAmbient);
+        sprintf(buffer, "Ambient Light (%.2f): Use +/- keys", m_renderLighting.globalAmbient);
         for (const char *c = buffer; *c != '\0'; c++) {
             glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
         }
 
         glRasterPos2f(x + 50, y + 200);
-        sprintf(buffer, "Sun Intensity (%.2f): Use [/] keys", m_sunIntensity);
+        sprintf(buffer, "Sun Intensity (%.2f): Use [/] keys", m_renderLighting.sunIntensity);
         for (const char *c = buffer; *c != '\0'; c++) {
             glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
         }
 
         glRasterPos2f(x + 50, y + 150);
-        sprintf(buffer, "Sun Angle (%.1f deg): Use <,> keys", m_sunAngle);
+        sprintf(buffer, "Sun Angle (%.1f deg): Use <,> keys", m_renderLighting.sunAngle);
         for (const char *c = buffer; *c != '\0'; c++) {
             glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
         }
@@ -342,6 +360,69 @@ namespace CowGL {
         }
     }
 
+    void UIManager::renderProfilerOverlay(int height) {
+        std::vector<Profiler::ZoneStats> zones = Profiler::getStats();
+
+        const int lineHeight = 16;
+        const int columns[] = {170, 225, 280, 335};
+        int panelWidth = columns[3] + 60;
+        int panelHeight = (static_cast<int>(zones.size()) + 1) * lineHeight + 12;
+        int x = 10;
+        int top = height - 10;
+
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glColor4f(0.0f, 0.0f, 0.0f, 0.6f);
+        glBegin(GL_QUADS);
+        glVertex2f(x, top - panelHeight);
+        glVertex2f(x + panelWidth, top - panelHeight);
+        glVertex2f(x + panelWidth, top);
+        glVertex2f(x, top);
+        glEnd();
+        glDisable(GL_BLEND);
+
+        auto drawText = [](int textX, int textY, const char *text) {
+            glRasterPos2f(textX, textY);
+            for (const char *c = text; *c != '\0'; c++) {
+                glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
+            }
+        };
+
+        int y = top - lineHeight;
+        glColor3f(1.0f, 1.0f, 0.6f);
+        drawText(x + 8, y, "Zone (ms)");
+        drawText(x + columns[0], y, "last");
+        drawText(x + columns[1], y, "min");
+        drawText(x + columns[2], y, "avg");
+        drawText(x + columns[3], y, "p99");
+
+        char buffer[32];
+        glColor3f(1.0f, 1.0f, 1.0f);
+        for (const Profiler::ZoneStats &zone: zones) {
+            y -= lineHeight;
+            drawText(x + 8 + zone.depth * 12, y, zone.name.c_str());
+
+            const double values[] = {zone.lastMs, zone.minMs, zone.avgMs, zone.p99Ms};
+            for (int i = 0; i < 4; ++i) {
+                snprintf(buffer, sizeof(buffer), "%.2f", values[i]);
+                drawText(x + columns[i], y, buffer);
+            }
+        }
+    }
+
+    void UIManager::captureSnapshot(RenderSnapshot &snapshot) const {
+        snapshot.lighting = m_lighting;
+        snapshot.showHelpMenu = m_showHelpMenu;
+        snapshot.showLightingMenu = m_showLightingMenu;
+        snapshot.uiRevision = m_revision;
+    }
+
+    void UIManager::applySnapshot(const RenderSnapshot &snapshot) {
+        m_renderLighting = snapshot.lighting;
+        m_renderHelpMenu = snapshot.showHelpMenu;
+        m_renderLightingMenu = snapshot.showLightingMenu;
+    }
+
     void UIManager::showHelpMenu() {
         m_showHelpMenu = true;
         m_showLightingMenu = false;
@@ -10,12 +10,15 @@
 
 
 #include <vector>
+#include <cstdint>
 #include <memory>
 #include <functional>
+#include "core/FrameContext.h"
 
 namespace CowGL {
     class Button;
     class Renderer;
+    struct RenderSnapshot;
 
     class UIManager {
     public:
@@ -23,11 +26,12 @@ namespace CowGL {
 
         ~UIManager();
 
-        void initialize();
+        // Lays the menu out for a window of the given size
+        void initialize(int width, int height);
 
-        void update(float deltaTime);
+        void update(const FrameContext &context);
 
-        void render(Renderer *renderer);
+        void render(Renderer *renderer, const FrameContext &context);
 
         void showHelpMenu();
 
@@ -41,31 +45,51 @@ namespace CowGL {
 
         void toggleLightingMenu();
 
-        void updateButtonPositions();
+        void updateButtonPositions(int width, int height);
 
-        float getGlobalAmbient() const { return m_globalAmbient; }
+        // Simulation thread: lighting and menu state after a tick
+        void captureSnapshot(RenderSnapshot &snapshot) const;
 
-        float getSunIntensity() const { return m_sunIntensity; }
+        // Changes whenever lighting or menu visibility does
+        uint64_t getRevision() const { return m_revision; }
 
-        float getSunAngle() const { return m_sunAngle; }
+        // Render thread: the state the getters and render() present
+        void applySnapshot(const RenderSnapshot &snapshot);
+
+        // Simulation thread: lighting as of the last update
+        const LightingState &getLighting() const { return m_lighting; }
+
+        // Render thread: lighting of the snapshot being drawn
+        const LightingState &getRenderLighting() const { return m_renderLighting; }
 
     private:
-        void createTopMenu();
+        void createTopMenu(int width, int height);
 
         void renderTopMenu();
 
-        void renderHelpMenu();
+        void renderHelpMenu(int width, int height);
+
+        void renderLightingMenu(int width, int height);
 
-        void renderLightingMenu();
+        // Per-zone timings of the recent frames, toggled with P
+        void renderProfilerOverlay(int height);
 
         std::vector<std::shared_ptr<Button> > m_topMenuButtons;
 
         bool m_showHelpMenu;
         bool m_showLightingMenu;
 
-        float m_globalAmbient;
-        float m_sunIntensity;
-        float m_sunAngle;
+        LightingState m_lighting;
+        uint64_t m_revision;
+
+        // Window size the buttons were laid out for
+        int m_layoutWidth;
+        int m_layoutHeight;
+
+        // Copies applied from the latest snapshot, read while drawing
+        bool m_renderHelpMenu;
+        bool m_renderLightingMenu;
+        LightingState m_renderLighting;
     };
 } // namespace CowGL
 
@@ -40,6 +40,11 @@ namespace glm {
         vec3 operator-(const vec3 &other) const { return vec3(x - other.x, y - other.y, z - other.z); }
         vec3 operator*(float scalar) const { return vec3(x * scalar, y * scalar, z * scalar); }
 
+        vec3 operator-() const { return vec3(-x, -y, -z); }
+
+        bool operator==(const vec3 &other) const { return x == other.x && y == other.y && z == other.z; }
+        bool operator!=(const vec3 &other) const { return !(*this == other); }
+
         float length() const { return std::sqrt(x * x + y * y + z * z); }
 
         vec3 normalized() const {
@@ -47,6 +52,10 @@ namespace glm {
             return len > 0 ? vec3(x / len, y / len, z / len) : vec3(0, 0, 0);
         }
 
+        static float dot(const vec3 &a, const vec3 &b) {
+            return a.x * b.x + a.y * b.y + a.z * b.z;
+        }
+
         static vec3 cross(const vec3 &a, const vec3 &b) {
             return vec3(
                 a.y * b.z - a.z * b.y,
@@ -114,6 +123,54 @@ namespace glm {
             result.m[10] = s.z;
             return result;
         }
+
+        // Column-major like OpenGL, so a * b applies b first
+        mat4 operator*(const mat4 &other) const {
+            mat4 result;
+            for (int col = 0; col < 4; ++col) {
+                for (int row = 0; row < 4; ++row) {
+                    float sum = 0.0f;
+                    for (int k = 0; k < 4; ++k) {
+                        sum += m[k * 4 + row] * other.m[col * 4 + k];
+                    }
+                    result.m[col * 4 + row] = sum;
+                }
+            }
+            return result;
+        }
+
+        vec3 transformPoint(const vec3 &p) const {
+            return vec3(m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+                        m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+                        m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]);
+        }
+
+        vec3 transformDirection(const vec3 &d) const {
+            return vec3(m[0] * d.x + m[4] * d.y + m[8] * d.z,
+                        m[1] * d.x + m[5] * d.y + m[9] * d.z,
+                        m[2] * d.x + m[6] * d.y + m[10] * d.z);
+        }
+
+        // Inverse transpose of the upper 3x3 (up to scale), for transforming normals
+        mat4 normalMatrix() const {
+            mat4 result;
+            result.m[0] = m[5] * m[10] - m[6] * m[9];
+            result.m[1] = m[6] * m[8] - m[4] * m[10];
+            result.m[2] = m[4] * m[9] - m[5] * m[8];
+            result.m[4] = m[2] * m[9] - m[1] * m[10];
+            result.m[5] = m[0] * m[10] - m[2] * m[8];
+            result.m[6] = m[1] * m[8] - m[0] * m[9];
+            result.m[8] = m[1] * m[6] - m[2] * m[5];
+            result.m[9] = m[2] * m[4] - m[0] * m[6];
+            result.m[10] = m[0] * m[5] - m[1] * m[4];
+
+            // Cofactors equal det * inverse transpose; keep the orientation for mirrored matrices
+            float det = m[0] * result.m[0] + m[1] * result.m[1] + m[2] * result.m[2];
+            if (det < 0.0f) {
+                for (int i = 0; i < 11; ++i) result.m[i] = -result.m[i];
+            }
+            return result;
+        }
     };
 
     inline float radians(float degrees) {
@@ -0,0 +1,23 @@
+//==============================================================================
+// File: utils/OpenGL.h
+// Purpose: Platform OpenGL, GLU and GLUT includes
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef OPENGL_H
+#define OPENGL_H
+
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#include <GLUT/glut.h>
+#else
+// Buffer objects are not part of the GL 1.1 headers Linux ships by default
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <GL/glut.h>
+#endif
+
+
+#endif //OPENGL_H
@@ -0,0 +1,57 @@
+//==============================================================================
+// File: utils/TripleBuffer.h
+// Purpose: Lock-free single producer, single consumer triple buffer
+// Created by Guy Bernstein on 20/07/2025.
+//==============================================================================
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+
+#include <atomic>
+
+namespace CowGL {
+    // The producer fills its back slot and publishes it; the consumer picks up the
+    // most recently published slot. Neither side ever waits for the other, and
+    // slots are reused, so their contents keep their allocations.
+    template<typename T>
+    class TripleBuffer {
+    public:
+        TripleBuffer() = default;
+
+        TripleBuffer(const TripleBuffer &) = delete;
+
+        TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+        // Producer side
+        T &back() { return m_slots[m_back]; }
+
+        void publish() {
+            int previous = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel);
+            m_back = previous & INDEX_MASK;
+        }
+
+        // Consumer side; returns true when a newer slot than the current front was taken
+        bool acquire() {
+            if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+
+            int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+            m_front = previous & INDEX_MASK;
+            return true;
+        }
+
+        const T &front() const { return m_slots[m_front]; }
+
+    private:
+        static constexpr int INDEX_MASK = 0x3;
+        static constexpr int FRESH = 0x4; // Set while the middle slot has not been acquired
+
+        T m_slots[3];
+        int m_back = 0;               // Owned by the producer
+        std::atomic<int> m_middle{1}; // Exchanged between both sides
+        int m_front = 2;              // Owned by the consumer
+    };
+} // namespace CowGL
+
+
+#endif //TRIPLEBUFFER_H